@@ -0,0 +1,65 @@
+/* Contagem de alocações no heap - implementação
+ * Ver AllocationCounter.h
+ */
+
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+static atomic<size_t> allocations{0};
+static atomic<size_t> bytes{0};
+
+size_t allocationCount()
+{
+    return allocations.load(memory_order_relaxed);
+}
+
+size_t allocatedBytes()
+{
+    return bytes.load(memory_order_relaxed);
+}
+
+static void* countedAllocate(size_t size)
+{
+    allocations.fetch_add(1, memory_order_relaxed);
+    bytes.fetch_add(size, memory_order_relaxed);
+    void* block = malloc(size == 0 ? 1 : size);
+    if (!block)
+        throw bad_alloc();
+    return block;
+}
+
+// As versões nothrow e com tamanho na liberação padrão chamam estas
+void* operator new(size_t size)
+{
+    return countedAllocate(size);
+}
+
+void* operator new[](size_t size)
+{
+    return countedAllocate(size);
+}
+
+void operator delete(void* block) noexcept
+{
+    free(block);
+}
+
+void operator delete[](void* block) noexcept
+{
+    free(block);
+}
+
+void operator delete(void* block, size_t) noexcept
+{
+    free(block);
+}
+
+void operator delete[](void* block, size_t) noexcept
+{
+    free(block);
+}
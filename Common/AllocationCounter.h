@@ -0,0 +1,27 @@
+/* Contagem de alocações no heap
+ *
+ * Substitui o operator new/delete global por versões que contam as chamadas, para
+ * verificar que um trecho (o laço de um quadro, por exemplo) não aloca:
+ *
+ *     size_t before = allocationCount();
+ *     ...
+ *     size_t allocations = allocationCount() - before;
+ *
+ * Todo programa referencia o operator new, então o AllocationCounter.cpp não fica na
+ * biblioteca comum (seria ligado em todos): ele é compilado só nos programas que usam
+ * estas funções (ALLOCATION_COUNTER_TARGETS no CMakelists.txt). A contagem é global:
+ * inclui as outras threads do processo, inclusive as do driver de vídeo.
+ */
+
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstddef>
+
+// Total de chamadas a operator new desde o início do programa
+size_t allocationCount();
+
+// Total de bytes pedidos ao operator new desde o início do programa
+size_t allocatedBytes();
+
+#endif
@@ -0,0 +1,257 @@
+/* Animação por quadros-chave - implementação
+ * Ver AnimationTracks.h
+ */
+
+#include "AnimationTracks.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include "JobSystem.h"
+#include "QuatMatrix.h"
+
+using namespace std;
+using namespace glm;
+
+// Trilhas por job na avaliação em paralelo
+static const size_t TRACKS_PER_JOB = 4096;
+
+TrackTarget trackTargetFromName(const string& name)
+{
+    if (name == "position") return TRACK_POSITION;
+    if (name == "rotation") return TRACK_ROTATION;
+    if (name == "scale") return TRACK_SCALE;
+    if (name == "kd") return TRACK_DIFFUSE;
+    if (name == "shininess") return TRACK_SHININESS;
+    return TRACK_TARGET_COUNT;
+}
+
+uint32_t AnimationSet::addCurve(const float* times, const vec4* values, size_t count)
+{
+    curveFirst.push_back((uint32_t)keyTimes.size());
+    curveKeys.push_back((uint32_t)count);
+    keyTimes.insert(keyTimes.end(), times, times + count);
+    keyValues.insert(keyValues.end(), values, values + count);
+    return (uint32_t)curveFirst.size() - 1;
+}
+
+void AnimationSet::addTrack(Entity entity, TrackTarget target, uint32_t curve, float speed, float offset, bool loop)
+{
+    TrackList& list = tracks[target];
+    list.entities.push_back(entity);
+    list.curves.push_back(curve);
+    list.speeds.push_back(speed);
+    list.offsets.push_back(offset);
+    list.loops.push_back(loop ? 1 : 0);
+    list.cursors.push_back(0);
+}
+
+size_t AnimationSet::removeTracks(Entity entity)
+{
+    size_t removed = 0;
+    for (TrackList& list : tracks) {
+        // Troca com a última: a ordem das trilhas de um componente não importa
+        for (size_t i = 0; i < list.entities.size();) {
+            if (list.entities[i] != entity) {
+                ++i;
+                continue;
+            }
+            list.entities[i] = list.entities.back();
+            list.curves[i] = list.curves.back();
+            list.speeds[i] = list.speeds.back();
+            list.offsets[i] = list.offsets.back();
+            list.loops[i] = list.loops.back();
+            list.cursors[i] = list.cursors.back();
+            list.entities.pop_back();
+            list.curves.pop_back();
+            list.speeds.pop_back();
+            list.offsets.pop_back();
+            list.loops.pop_back();
+            list.cursors.pop_back();
+            ++removed;
+        }
+    }
+    return removed;
+}
+
+size_t AnimationSet::compactCurves()
+{
+    const uint32_t UNUSED = UINT32_MAX;
+    vector<uint32_t> remap(curveFirst.size(), UNUSED);
+    for (const TrackList& list : tracks)
+        for (uint32_t curve : list.curves)
+            remap[curve] = 0;
+
+    // As curvas mantêm a ordem, então as chaves só andam para trás
+    uint32_t kept = 0, keys = 0;
+    for (size_t curve = 0; curve < curveFirst.size(); ++curve) {
+        if (remap[curve] == UNUSED)
+            continue;
+        uint32_t first = curveFirst[curve], count = curveKeys[curve];
+        move(keyTimes.begin() + first, keyTimes.begin() + first + count, keyTimes.begin() + keys);
+        move(keyValues.begin() + first, keyValues.begin() + first + count, keyValues.begin() + keys);
+        curveFirst[kept] = keys;
+        curveKeys[kept] = count;
+        remap[curve] = kept++;
+        keys += count;
+    }
+    size_t removed = curveFirst.size() - kept;
+    if (removed == 0)
+        return 0;
+    curveFirst.resize(kept);
+    curveKeys.resize(kept);
+    keyTimes.resize(keys);
+    keyValues.resize(keys);
+    for (TrackList& list : tracks)
+        for (uint32_t& curve : list.curves)
+            curve = remap[curve];
+    return removed;
+}
+
+void AnimationSet::clear()
+{
+    curveFirst.clear();
+    curveKeys.clear();
+    keyTimes.clear();
+    keyValues.clear();
+    for (TrackList& list : tracks)
+        list = TrackList();
+}
+
+size_t AnimationSet::trackCount() const
+{
+    size_t count = 0;
+    for (const TrackList& list : tracks)
+        count += list.entities.size();
+    return count;
+}
+
+bool parseTrackKeys(const string& text, TrackTarget target, vector<float>& times, vector<vec4>& values)
+{
+    const int components = target == TRACK_SHININESS ? 1 : 3; // rotação: 3 ângulos de Euler
+    times.clear();
+    values.clear();
+
+    stringstream keys(text);
+    string key;
+    while (getline(keys, key, ';')) {
+        if (key.find_first_not_of(" \t") == string::npos)
+            continue;
+        istringstream iss(key);
+        float time;
+        vec4 value(0.0f);
+        iss >> time;
+        for (int c = 0; c < components; ++c)
+            iss >> value[c];
+        if (iss.fail() || (!times.empty() && time <= times.back()))
+            return false;
+        if (target == TRACK_ROTATION) {
+            quat rotation = quatFromEulerDegrees(vec3(value));
+            value = vec4(rotation.x, rotation.y, rotation.z, rotation.w);
+        }
+        times.push_back(time);
+        values.push_back(value);
+    }
+    return !times.empty();
+}
+
+// Tempo da trilha dentro do intervalo das chaves (repetido em laço ou preso nas pontas)
+static inline float wrapTime(float time, float start, float end, bool loop)
+{
+    if (!loop || end <= start)
+        return glm::clamp(time, start, end);
+    float length = end - start;
+    float t = fmod(time - start, length);
+    if (t < 0.0f)
+        t += length;
+    return start + t;
+}
+
+// Segmento [k, k + 1] das chaves que contém t, começando pelo da amostra anterior:
+// com o tempo avançando, fica no mesmo segmento ou anda poucos passos
+static inline uint32_t findSegment(const float* times, uint32_t count, float t, uint32_t cursor)
+{
+    if (cursor + 1 >= count || t < times[cursor])
+        cursor = 0;
+    while (cursor + 2 < count && t >= times[cursor + 1])
+        ++cursor;
+    return cursor;
+}
+
+// Avalia em lote as trilhas de um componente; write(entity, value) grava o resultado
+template <typename Write>
+static void evaluateList(const AnimationSet& set, AnimationSet::TrackList& list, float time, Entity skip,
+                         bool rotation, JobSystem* jobs, Write write)
+{
+    const Entity* entities = list.entities.data();
+    const uint32_t* curves = list.curves.data();
+    const float* speeds = list.speeds.data();
+    const float* offsets = list.offsets.data();
+    const uint8_t* loops = list.loops.data();
+    uint32_t* cursors = list.cursors.data();
+
+    auto body = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Entity entity = entities[i];
+            if (entity == skip)
+                continue;
+            uint32_t curve = curves[i];
+            const float* times = set.keyTimes.data() + set.curveFirst[curve];
+            const vec4* values = set.keyValues.data() + set.curveFirst[curve];
+            uint32_t count = set.curveKeys[curve];
+
+            vec4 value = values[0];
+            if (count > 1) {
+                float t = wrapTime(time * speeds[i] + offsets[i], times[0], times[count - 1], loops[i] != 0);
+                uint32_t k = findSegment(times, count, t, cursors[i]);
+                cursors[i] = k;
+                float span = times[k + 1] - times[k];
+                float u = span > 0.0f ? glm::clamp((t - times[k]) / span, 0.0f, 1.0f) : 1.0f;
+                vec4 a = values[k], b = values[k + 1];
+                if (rotation) {
+                    // Interpolação linear normalizada pelo caminho mais curto
+                    if (dot(a, b) < 0.0f)
+                        b = -b;
+                    value = normalize(mix(a, b, u));
+                }
+                else {
+                    value = mix(a, b, u);
+                }
+            }
+            write(entity, value);
+        }
+    };
+
+    if (jobs)
+        jobs->parallelFor(list.entities.size(), TRACKS_PER_JOB, body);
+    else if (!list.entities.empty())
+        body((size_t)0, list.entities.size());
+}
+
+size_t evaluateAnimations(EntityWorld& world, AnimationSet& set, float time, Entity skip, JobSystem* jobs)
+{
+    // Uma trilha por componente de cada entidade: as escritas de um lote não se sobrepõem
+    evaluateList(set, set.tracks[TRACK_POSITION], time, skip, false, jobs, [&](Entity entity, const vec4& value) {
+        world.positions[entity] = vec3(value);
+        world.markDirty(entity);
+    });
+    evaluateList(set, set.tracks[TRACK_ROTATION], time, skip, true, jobs, [&](Entity entity, const vec4& value) {
+        world.rotations[entity] = quat(value.w, value.x, value.y, value.z);
+        world.markDirty(entity);
+    });
+    evaluateList(set, set.tracks[TRACK_SCALE], time, skip, false, jobs, [&](Entity entity, const vec4& value) {
+        world.scales[entity] = vec3(value);
+        world.markDirty(entity);
+    });
+    evaluateList(set, set.tracks[TRACK_DIFFUSE], time, skip, false, jobs, [&](Entity entity, const vec4& value) {
+        world.materials[entity].kd = vec3(value);
+    });
+    evaluateList(set, set.tracks[TRACK_SHININESS], time, skip, false, jobs, [&](Entity entity, const vec4& value) {
+        world.materials[entity].shininess = value.x;
+    });
+    return set.trackCount();
+}
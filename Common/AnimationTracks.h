@@ -0,0 +1,96 @@
+/* Animação por quadros-chave (keyframes) em trilhas tipadas
+ *
+ * Uma curva é uma sequência de chaves (tempo, valor). Uma trilha liga uma curva a um
+ * componente de uma entidade (posição, rotação, escala, Kd ou brilho do material),
+ * com velocidade e deslocamento de tempo próprios: muitas entidades podem compartilhar
+ * a mesma curva, cada uma em uma fase diferente.
+ *
+ * Tudo fica em vetores separados (SoA): os tempos das chaves em um vetor e os valores
+ * em outro, e as trilhas agrupadas por componente. evaluateAnimations() percorre cada
+ * grupo em lote, em paralelo com o JobSystem. Cada trilha guarda o segmento da última
+ * amostra (cursor): com o tempo avançando, a busca da chave é O(1) amortizado.
+ *
+ * Formato no arquivo de cena (chaves separadas por ';', tempos em segundos, em laço):
+ *     object.moon.track.rotation = 0 0 0 0; 10 0 120 0; 20 0 240 0; 30 0 360 0
+ * Rotações são dadas em graus de Euler (como object.X.rotation) e interpoladas pelo
+ * caminho mais curto, então chaves vizinhas devem estar a menos de 180 graus.
+ */
+
+#ifndef ANIMATION_TRACKS_H
+#define ANIMATION_TRACKS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "EntityWorld.h"
+
+class JobSystem;
+
+// Componente animado por uma trilha (e o número de floats do seu valor)
+enum TrackTarget : uint8_t {
+    TRACK_POSITION,  // vec3
+    TRACK_ROTATION,  // quatérnio (x, y, z, w)
+    TRACK_SCALE,     // vec3
+    TRACK_DIFFUSE,   // Kd do material, vec3
+    TRACK_SHININESS, // float
+    TRACK_TARGET_COUNT
+};
+
+// "position", "rotation", "scale", "kd" ou "shininess" (TRACK_TARGET_COUNT se desconhecido)
+TrackTarget trackTargetFromName(const std::string& name);
+
+class AnimationSet {
+public:
+    // Adiciona uma curva com count chaves (tempos crescentes). Rotações em quatérnio
+    // no formato (x, y, z, w) de glm::vec4. Retorna o índice da curva
+    uint32_t addCurve(const float* times, const glm::vec4* values, size_t count);
+
+    // Liga a curva ao componente target da entidade. O tempo da trilha é
+    // time * speed + offset; com loop, a curva se repete, senão fica na última chave
+    void addTrack(Entity entity, TrackTarget target, uint32_t curve, float speed = 1.0f,
+                  float offset = 0.0f, bool loop = true);
+
+    // Remove as trilhas da entidade (as curvas ficam: outras trilhas podem usá-las;
+    // compactCurves() libera as que sobraram). Retorna quantas foram removidas
+    size_t removeTracks(Entity entity);
+    // Apaga as curvas que nenhuma trilha usa e junta as chaves das restantes, renumerando
+    // as curvas das trilhas. Percorre todas as trilhas e chaves: chamar uma vez depois de
+    // um lote de removeTracks. Retorna quantas curvas foram apagadas
+    size_t compactCurves();
+    void clear();
+    size_t trackCount() const;
+    size_t curveCount() const { return curveFirst.size(); }
+
+    // --- Curvas ---
+    std::vector<uint32_t> curveFirst;  // primeira chave da curva em keyTimes/keyValues
+    std::vector<uint32_t> curveKeys;   // quantidade de chaves
+    std::vector<float> keyTimes;
+    std::vector<glm::vec4> keyValues;
+
+    // --- Trilhas, agrupadas por componente ---
+    struct TrackList {
+        std::vector<Entity> entities;
+        std::vector<uint32_t> curves;
+        std::vector<float> speeds;
+        std::vector<float> offsets;
+        std::vector<uint8_t> loops;
+        std::vector<uint32_t> cursors; // segmento da última amostra
+    };
+    TrackList tracks[TRACK_TARGET_COUNT];
+};
+
+// Converte o texto "t v v v; t v v v; ..." de uma trilha em chaves. Rotações em graus de
+// Euler viram quatérnios. Retorna false se alguma chave estiver incompleta ou fora de ordem
+bool parseTrackKeys(const std::string& text, TrackTarget target, std::vector<float>& times,
+                    std::vector<glm::vec4>& values);
+
+// Amostra todas as trilhas no tempo time (segundos), escreve nos componentes das
+// entidades e marca as transformações alteradas. A entidade skip não é animada.
+// Retorna quantas trilhas foram avaliadas
+size_t evaluateAnimations(EntityWorld& world, AnimationSet& set, float time,
+                          Entity skip = INVALID_ENTITY, JobSystem* jobs = nullptr);
+
+#endif
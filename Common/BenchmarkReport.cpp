@@ -0,0 +1,68 @@
+/* Resultados de benchmark em JSON - implementação
+ * Ver BenchmarkReport.h
+ */
+
+#include "BenchmarkReport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <numeric>
+
+using namespace std;
+
+double percentile(const vector<double>& sorted, double percent)
+{
+    if (sorted.empty())
+        return 0.0;
+    size_t rank = (size_t)ceil(percent / 100.0 * sorted.size());
+    return sorted[std::min(std::max(rank, (size_t)1), sorted.size()) - 1];
+}
+
+const BenchmarkResult& BenchmarkReport::add(const string& name, const string& unit, vector<double> samples)
+{
+    BenchmarkResult result;
+    result.name = name;
+    result.unit = unit;
+    result.samples = samples.size();
+    if (!samples.empty()) {
+        sort(samples.begin(), samples.end());
+        result.median = percentile(samples, 50.0);
+        result.mean = accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+        result.min = samples.front();
+        result.max = samples.back();
+        result.p90 = percentile(samples, 90.0);
+        result.p99 = percentile(samples, 99.0);
+    }
+    char line[256];
+    snprintf(line, sizeof(line), "  %-44s mediana %10.4f %-5s p90 %10.4f  p99 %10.4f  (%zu amostras)",
+             name.c_str(), result.median, unit.c_str(), result.p90, result.p99, result.samples);
+    cout << line << endl;
+    entries.push_back(result);
+    return entries.back();
+}
+
+bool BenchmarkReport::write(const string& path) const
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        cout << "Nao foi possivel gravar " << path << endl;
+        return false;
+    }
+    // Nomes e unidades são identificadores do próprio código: sem caracteres a escapar
+    fprintf(file, "{\n  \"suite\": \"%s\",\n  \"results\": [\n", suite.c_str());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const BenchmarkResult& r = entries[i];
+        fprintf(file,
+                "    { \"name\": \"%s\", \"unit\": \"%s\", \"samples\": %zu, \"median\": %.6g, \"mean\": %.6g, "
+                "\"min\": %.6g, \"p90\": %.6g, \"p99\": %.6g, \"max\": %.6g }%s\n",
+                r.name.c_str(), r.unit.c_str(), r.samples, r.median, r.mean, r.min, r.p90, r.p99, r.max,
+                i + 1 < entries.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    bool ok = fclose(file) == 0;
+    if (ok)
+        cout << "Resultados gravados em " << path << endl;
+    return ok;
+}
@@ -0,0 +1,71 @@
+/* Resultados de benchmark em JSON, comparáveis entre execuções
+ *
+ * Cada métrica é um conjunto de amostras (ex.: o tempo de cada repetição ou de cada
+ * quadro) resumido em mediana, média, mínimo, percentis 90 e 99 e máximo. O arquivo
+ * tem o formato
+ *     { "suite": "SceneBench", "results": [
+ *         { "name": "obj/moon", "unit": "ms", "samples": 20, "median": 1.9, ... }, ... ] }
+ * e é lido por bench/compare_benchmarks.py, que acusa as métricas que pioraram além
+ * do limite (menor é sempre melhor). Os nomes são estáveis: "grupo/caso[/medida]".
+ */
+
+#ifndef BENCHMARK_REPORT_H
+#define BENCHMARK_REPORT_H
+
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+struct BenchmarkResult {
+    std::string name;
+    std::string unit;
+    size_t samples = 0;
+    double median = 0.0, mean = 0.0, min = 0.0, max = 0.0, p90 = 0.0, p99 = 0.0;
+};
+
+// Percentil (0 a 100) por posição mais próxima em amostras já ordenadas
+double percentile(const std::vector<double>& sorted, double percent);
+
+class BenchmarkReport {
+public:
+    explicit BenchmarkReport(const std::string& suite) : suite(suite) {}
+
+    // Resume as amostras (ordem qualquer) e escreve a linha no terminal
+    const BenchmarkResult& add(const std::string& name, const std::string& unit, std::vector<double> samples);
+
+    const std::vector<BenchmarkResult>& results() const { return entries; }
+
+    // false se o arquivo não pode ser escrito
+    bool write(const std::string& path) const;
+
+private:
+    std::string suite;
+    std::vector<BenchmarkResult> entries;
+};
+
+// Tempo de uma execução de work() em milissegundos
+template <typename F>
+double measureMilliseconds(F&& work)
+{
+    auto start = std::chrono::steady_clock::now();
+    work();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Executa work() repetitions vezes (depois de warmup execuções descartadas) e devolve
+// o tempo de cada uma em milissegundos
+template <typename F>
+std::vector<double> sampleMilliseconds(int repetitions, int warmup, F&& work)
+{
+    std::vector<double> samples;
+    samples.reserve(repetitions);
+    for (int i = -warmup; i < repetitions; ++i) {
+        double elapsed = measureMilliseconds(work);
+        if (i >= 0)
+            samples.push_back(elapsed);
+    }
+    return samples;
+}
+
+#endif
@@ -0,0 +1,439 @@
+/* Iluminação forward+ em clusters - implementação
+ * Ver ClusteredLights.h
+ */
+
+#include "ClusteredLights.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+using namespace glm;
+
+// Entradas do OpenGL 4.3 / GL_ARB_compute_shader (ausentes na GLAD 4.0)
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#define GL_TEXTURE_FETCH_BARRIER_BIT 0x00000008
+#define GL_BUFFER_UPDATE_BARRIER_BIT 0x00000200
+#endif
+
+typedef void (APIENTRYP PFN_DISPATCHCOMPUTE)(GLuint groupsX, GLuint groupsY, GLuint groupsZ);
+typedef void (APIENTRYP PFN_BINDBUFFERBASE)(GLenum target, GLuint index, GLuint buffer);
+typedef void (APIENTRYP PFN_MEMORYBARRIER)(GLbitfield barriers);
+
+static PFN_DISPATCHCOMPUTE dispatchCompute = NULL;
+static PFN_BINDBUFFERBASE bindBufferBase = NULL;
+static PFN_MEMORYBARRIER memoryBarrier = NULL;
+
+static const GLuint BINNING_GROUP_SIZE = 64;
+
+// Compute shader de classificação: uma invocação por cluster. Cada uma monta a caixa do
+// seu cluster no espaço de visão, conta as luzes cuja esfera toca a caixa, reserva o
+// trecho da lista com atomicAdd e escreve os índices. A grade e as listas usam o mesmo
+// formato da classificação na CPU
+static const char* binningSource = R"(#version 430
+layout (local_size_x = 64) in;
+
+layout (std430, binding = 0) readonly buffer ClusterLightData { vec4 lightData[]; };
+layout (std430, binding = 1) writeonly buffer ClusterGrid { uvec2 grid[]; };
+layout (std430, binding = 2) writeonly buffer ClusterLightIndices { uint indices[]; };
+layout (std430, binding = 3) buffer ClusterCounter { uint nextIndex; };
+
+uniform mat4 view;
+uniform mat4 inverseProjection;
+uniform ivec3 clusterDims;
+uniform vec2 clusterDepthRange; // near, far
+uniform uint lightCount;
+uniform uint indexCapacity;
+
+bool touches(uint light, vec3 boxMin, vec3 boxMax)
+{
+    vec4 posRadius = lightData[2u * light];
+    if (posRadius.w <= 0.0)
+        return true; // sem atenuação: todos os clusters
+    vec3 center = vec3(view * vec4(posRadius.xyz, 1.0));
+    vec3 d = clamp(center, boxMin, boxMax) - center;
+    return dot(d, d) <= posRadius.w * posRadius.w;
+}
+
+void main()
+{
+    int cluster = int(gl_GlobalInvocationID.x);
+    if (cluster >= clusterDims.x * clusterDims.y * clusterDims.z)
+        return;
+    ivec3 cell = ivec3(cluster % clusterDims.x, (cluster / clusterDims.x) % clusterDims.y,
+                       cluster / (clusterDims.x * clusterDims.y));
+
+    // Fatias exponenciais, como no fragment shader
+    float n = clusterDepthRange.x, f = clusterDepthRange.y;
+    float depths[2] = float[2](n * pow(f / n, float(cell.z) / float(clusterDims.z)),
+                               n * pow(f / n, float(cell.z + 1) / float(clusterDims.z)));
+    vec2 ndcMin = vec2(cell.xy) / vec2(clusterDims.xy) * 2.0 - 1.0;
+    vec2 ndcMax = vec2(cell.xy + 1) / vec2(clusterDims.xy) * 2.0 - 1.0;
+    vec3 boxMin = vec3(1e30), boxMax = vec3(-1e30);
+    for (int c = 0; c < 4; ++c) {
+        vec2 ndc = vec2((c & 1) != 0 ? ndcMax.x : ndcMin.x, (c & 2) != 0 ? ndcMax.y : ndcMin.y);
+        vec4 onNear = inverseProjection * vec4(ndc, -1.0, 1.0);
+        vec3 ray = onNear.xyz / onNear.w;
+        for (int d = 0; d < 2; ++d) {
+            vec3 corner = ray * (depths[d] / -ray.z);
+            boxMin = min(boxMin, corner);
+            boxMax = max(boxMax, corner);
+        }
+    }
+
+    uint count = 0u;
+    for (uint l = 0u; l < lightCount; ++l)
+        if (touches(l, boxMin, boxMax))
+            count++;
+    uint offset = count > 0u ? atomicAdd(nextIndex, count) : 0u;
+    count = offset < indexCapacity ? min(count, indexCapacity - offset) : 0u;
+
+    uint written = 0u;
+    for (uint l = 0u; l < lightCount && written < count; ++l)
+        if (touches(l, boxMin, boxMax))
+            indices[offset + written++] = l;
+    grid[cluster] = uvec2(offset, count);
+}
+)";
+
+// Compila o compute shader de classificação. Retorna 0 se falhar
+static GLuint createBinningProgram()
+{
+    GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(shader, 1, &binningSource, NULL);
+    glCompileShader(shader);
+    GLint success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    GLchar infoLog[512];
+    if (!success) {
+        glGetShaderInfoLog(shader, 512, NULL, infoLog);
+        cout << "ClusteredLights: erro ao compilar o compute shader\n" << infoLog << endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+    GLuint program = glCreateProgram();
+    glAttachShader(program, shader);
+    glLinkProgram(program);
+    glDeleteShader(shader);
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glGetProgramInfoLog(program, 512, NULL, infoLog);
+        cout << "ClusteredLights: erro ao linkar o compute shader\n" << infoLog << endl;
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+// Cria um texture buffer vazio com o formato indicado
+static void createTextureBuffer(GLuint &buffer, GLuint &tex, GLenum format)
+{
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, 16, NULL, GL_STREAM_DRAW);
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_BUFFER, tex);
+    glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+// Reenvia o conteúdo de um texture buffer (orphaning para não esperar a GPU).
+// Retorna os bytes enviados
+template <typename T>
+static size_t uploadTextureBuffer(GLuint buffer, const vector<T>& data)
+{
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    size_t bytes = std::max<size_t>(data.size() * sizeof(T), 16);
+    glBufferData(GL_TEXTURE_BUFFER, bytes, NULL, GL_STREAM_DRAW);
+    if (!data.empty())
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, data.size() * sizeof(T), data.data());
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    return data.size() * sizeof(T);
+}
+
+bool ClusteredLights::init(GLADloadproc loader)
+{
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    createTextureBuffer(lightsBuffer, lightsTex, GL_RGBA32F);
+    createTextureBuffer(gridBuffer, gridTex, GL_RG32UI);
+    createTextureBuffer(indexBuffer, indexTex, GL_R32UI);
+    clusterGrid.assign(CLUSTER_COUNT * 2, 0);
+    clusterFill.assign(CLUSTER_COUNT, 0);
+    if (lightsTex == 0 || gridTex == 0 || indexTex == 0)
+        return false;
+
+    // Classificação na GPU só com OpenGL 4.3 (compute shaders e SSBOs)
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    if (loader && (major > 4 || (major == 4 && minor >= 3))) {
+        dispatchCompute = (PFN_DISPATCHCOMPUTE)loader("glDispatchCompute");
+        bindBufferBase = (PFN_BINDBUFFERBASE)loader("glBindBufferBase");
+        memoryBarrier = (PFN_MEMORYBARRIER)loader("glMemoryBarrier");
+        if (dispatchCompute && bindBufferBase && memoryBarrier)
+            binningProgram = createBinningProgram();
+    }
+    if (binningProgram != 0) {
+        // A grade tem tamanho fixo; o contador é zerado a cada quadro
+        glBindBuffer(GL_TEXTURE_BUFFER, gridBuffer);
+        glBufferData(GL_TEXTURE_BUFFER, CLUSTER_COUNT * 2 * sizeof(GLuint), NULL, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        glGenBuffers(1, &counterBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, counterBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GLuint), NULL, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+    else
+        cout << "ClusteredLights: compute shaders indisponiveis (OpenGL " << major << "." << minor
+             << "), classificacao das luzes na CPU" << endl;
+    return true;
+}
+
+void ClusteredLights::release()
+{
+    GLuint buffers[4] = { lightsBuffer, gridBuffer, indexBuffer, counterBuffer };
+    GLuint textures[3] = { lightsTex, gridTex, indexTex };
+    glDeleteBuffers(4, buffers);
+    glDeleteTextures(3, textures);
+    glDeleteProgram(binningProgram);
+    lightsBuffer = gridBuffer = indexBuffer = counterBuffer = 0;
+    lightsTex = gridTex = indexTex = 0;
+    binningProgram = 0;
+    indexCapacity = 0;
+}
+
+void ClusteredLights::update(const LightTable& table, const mat4& view, const mat4& projection,
+                             float nearZ, float farZ)
+{
+    nearPlane = nearZ;
+    farPlane = farZ;
+    if (binningProgram != 0)
+        binOnGpu(table, view, projection);
+    else
+        binOnCpu(table, view, projection);
+}
+
+void ClusteredLights::binOnGpu(const LightTable& table, const mat4& view, const mat4& projection)
+{
+    lightData.clear();
+    for (size_t i = 0; i < table.size(); ++i) {
+        const PointLight& light = table[i];
+        if (!light.enabled)
+            continue;
+        lightData.push_back(vec4(light.position, light.radius));
+        lightData.push_back(vec4(light.color * light.intensity, light.ambient));
+    }
+    uploadedLights = lightData.size() / 2;
+    lightIndices.clear();
+    uploadedBytes = uploadTextureBuffer(lightsBuffer, lightData);
+
+    // Pior caso: todas as luzes em todos os clusters, limitado ao tamanho do texture buffer.
+    // Só cresce, para não realocar a cada quadro
+    GLuint needed = (GLuint)std::min<size_t>(std::max<size_t>(uploadedLights, 1) * CLUSTER_COUNT, (size_t)maxTexels);
+    if (needed > indexCapacity) {
+        indexCapacity = needed;
+        glBindBuffer(GL_TEXTURE_BUFFER, indexBuffer);
+        glBufferData(GL_TEXTURE_BUFFER, indexCapacity * sizeof(GLuint), NULL, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        if (indexCapacity == (GLuint)maxTexels && !warnedOverflow) {
+            cout << "ClusteredLights: listas de indices limitadas a GL_MAX_TEXTURE_BUFFER_SIZE (" << maxTexels
+                 << "), luzes excedentes podem ser ignoradas" << endl;
+            warnedOverflow = true;
+        }
+    }
+
+    GLuint zero = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, counterBuffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(GLuint), &zero);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    uploadedBytes += sizeof(GLuint);
+
+    mat4 inverseProjection = inverse(projection);
+    glUseProgram(binningProgram);
+    glUniformMatrix4fv(glGetUniformLocation(binningProgram, "view"), 1, GL_FALSE, &view[0][0]);
+    glUniformMatrix4fv(glGetUniformLocation(binningProgram, "inverseProjection"), 1, GL_FALSE, &inverseProjection[0][0]);
+    glUniform3i(glGetUniformLocation(binningProgram, "clusterDims"), TILES_X, TILES_Y, SLICES);
+    glUniform2f(glGetUniformLocation(binningProgram, "clusterDepthRange"), nearPlane, farPlane);
+    glUniform1ui(glGetUniformLocation(binningProgram, "lightCount"), (GLuint)uploadedLights);
+    glUniform1ui(glGetUniformLocation(binningProgram, "indexCapacity"), indexCapacity);
+    bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, lightsBuffer);
+    bindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, gridBuffer);
+    bindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, indexBuffer);
+    bindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, counterBuffer);
+    dispatchCompute((CLUSTER_COUNT + BINNING_GROUP_SIZE - 1) / BINNING_GROUP_SIZE, 1, 1);
+    glUseProgram(0);
+
+    // O fragment shader lê a grade e as listas por texture buffers, e o contador é
+    // reescrito por glBufferSubData no próximo quadro
+    memoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+}
+
+void ClusteredLights::binOnCpu(const LightTable& table, const mat4& view, const mat4& projection)
+{
+    const float sliceScale = SLICES / log(farPlane / nearPlane);
+
+    lightData.clear();
+    lightRanges.clear();
+    std::fill(clusterFill.begin(), clusterFill.end(), 0u);
+
+    // 1) Calcula o intervalo de clusters de cada luz habilitada e conta as luzes por cluster
+    for (size_t i = 0; i < table.size(); ++i) {
+        const PointLight& light = table[i];
+        if (!light.enabled)
+            continue;
+
+        int range[6] = { 0, TILES_X - 1, 0, TILES_Y - 1, 0, SLICES - 1 };
+        if (light.radius > 0.0f) {
+            vec3 center = vec3(view * vec4(light.position, 1.0f));
+            float zMin = -center.z - light.radius; // distâncias positivas à frente da câmera
+            float zMax = -center.z + light.radius;
+            if (zMax < nearPlane || zMin > farPlane)
+                continue;
+            zMin = std::max(zMin, nearPlane);
+            zMax = std::min(zMax, farPlane);
+
+            // Projeta os cantos da caixa envolvente; cantos atrás do plano near são
+            // trazidos para ele, o que só aumenta a área projetada (conservador)
+            vec2 ndcMin(1.0f), ndcMax(-1.0f);
+            for (int c = 0; c < 8; ++c) {
+                vec3 corner = center + light.radius * vec3((c & 1) ? 1.0f : -1.0f,
+                                                           (c & 2) ? 1.0f : -1.0f,
+                                                           (c & 4) ? 1.0f : -1.0f);
+                corner.z = std::min(corner.z, -nearPlane);
+                vec4 clip = projection * vec4(corner, 1.0f);
+                vec2 ndc = vec2(clip) / clip.w;
+                ndcMin = glm::min(ndcMin, ndc);
+                ndcMax = glm::max(ndcMax, ndc);
+            }
+            if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f)
+                continue;
+
+            range[0] = glm::clamp((int)floor((ndcMin.x * 0.5f + 0.5f) * TILES_X), 0, TILES_X - 1);
+            range[1] = glm::clamp((int)floor((ndcMax.x * 0.5f + 0.5f) * TILES_X), 0, TILES_X - 1);
+            range[2] = glm::clamp((int)floor((ndcMin.y * 0.5f + 0.5f) * TILES_Y), 0, TILES_Y - 1);
+            range[3] = glm::clamp((int)floor((ndcMax.y * 0.5f + 0.5f) * TILES_Y), 0, TILES_Y - 1);
+            range[4] = glm::clamp((int)floor(log(zMin / nearPlane) * sliceScale), 0, SLICES - 1);
+            range[5] = glm::clamp((int)floor(log(zMax / nearPlane) * sliceScale), 0, SLICES - 1);
+        }
+
+        for (int z = range[4]; z <= range[5]; ++z)
+            for (int y = range[2]; y <= range[3]; ++y)
+                for (int x = range[0]; x <= range[1]; ++x)
+                    clusterFill[(z * TILES_Y + y) * TILES_X + x]++;
+
+        lightRanges.insert(lightRanges.end(), range, range + 6);
+        lightData.push_back(vec4(light.position, light.radius));
+        lightData.push_back(vec4(light.color * light.intensity, light.ambient));
+    }
+    uploadedLights = lightData.size() / 2;
+
+    // 2) Soma de prefixos: posição inicial da lista de cada cluster
+    GLuint total = 0;
+    for (int c = 0; c < CLUSTER_COUNT; ++c) {
+        clusterGrid[2 * c] = total;
+        clusterGrid[2 * c + 1] = clusterFill[c];
+        total += clusterFill[c];
+        clusterFill[c] = 0;
+    }
+    if (total > (GLuint)maxTexels) {
+        if (!warnedOverflow) {
+            cout << "ClusteredLights: lista de indices excede GL_MAX_TEXTURE_BUFFER_SIZE (" << total
+                 << " > " << maxTexels << "), luzes excedentes serao ignoradas" << endl;
+            warnedOverflow = true;
+        }
+    }
+    lightIndices.resize(std::min<GLuint>(total, (GLuint)maxTexels));
+
+    // 3) Preenche as listas de índices
+    for (size_t l = 0; l < uploadedLights; ++l) {
+        const int* range = &lightRanges[6 * l];
+        for (int z = range[4]; z <= range[5]; ++z)
+            for (int y = range[2]; y <= range[3]; ++y)
+                for (int x = range[0]; x <= range[1]; ++x) {
+                    int c = (z * TILES_Y + y) * TILES_X + x;
+                    GLuint slot = clusterGrid[2 * c] + clusterFill[c];
+                    if (slot < lightIndices.size()) {
+                        lightIndices[slot] = (GLuint)l;
+                        clusterFill[c]++;
+                    }
+                }
+    }
+    for (int c = 0; c < CLUSTER_COUNT; ++c)
+        clusterGrid[2 * c + 1] = clusterFill[c];
+
+    uploadedBytes = uploadTextureBuffer(lightsBuffer, lightData) + uploadTextureBuffer(gridBuffer, clusterGrid) +
+                    uploadTextureBuffer(indexBuffer, lightIndices);
+}
+
+void ClusteredLights::bind(GLuint program, int firstUnit, int screenWidth, int screenHeight) const
+{
+    glActiveTexture(GL_TEXTURE0 + firstUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, lightsTex);
+    glActiveTexture(GL_TEXTURE0 + firstUnit + 1);
+    glBindTexture(GL_TEXTURE_BUFFER, gridTex);
+    glActiveTexture(GL_TEXTURE0 + firstUnit + 2);
+    glBindTexture(GL_TEXTURE_BUFFER, indexTex);
+    glActiveTexture(GL_TEXTURE0);
+
+    glUniform1i(glGetUniformLocation(program, "clusterLightData"), firstUnit);
+    glUniform1i(glGetUniformLocation(program, "clusterGrid"), firstUnit + 1);
+    glUniform1i(glGetUniformLocation(program, "clusterLightIndices"), firstUnit + 2);
+    glUniform3i(glGetUniformLocation(program, "clusterDims"), TILES_X, TILES_Y, SLICES);
+    glUniform2f(glGetUniformLocation(program, "clusterScreenSize"), (GLfloat)screenWidth, (GLfloat)screenHeight);
+    glUniform2f(glGetUniformLocation(program, "clusterDepthRange"), nearPlane, farPlane);
+}
+
+const char* ClusteredLights::glslSource()
+{
+    return R"(
+uniform samplerBuffer clusterLightData;     // (posição, raio), (cor * intensidade, peso ambiente)
+uniform usamplerBuffer clusterGrid;         // (offset, quantidade) por cluster
+uniform usamplerBuffer clusterLightIndices; // listas de índices de luz
+uniform ivec3 clusterDims;
+uniform vec2 clusterScreenSize;
+uniform vec2 clusterDepthRange;             // near, far
+
+// Acumula a iluminação das luzes do cluster do fragmento atual.
+// As componentes retornadas ainda devem ser multiplicadas por Ka, Kd e Ks
+void clusteredLighting(vec3 P, vec3 N, vec3 V, float shininess,
+                       out vec3 ambient, out vec3 diffuse, out vec3 specular)
+{
+    ambient = vec3(0.0);
+    diffuse = vec3(0.0);
+    specular = vec3(0.0);
+
+    float n = clusterDepthRange.x, f = clusterDepthRange.y;
+    float zNdc = gl_FragCoord.z * 2.0 - 1.0;
+    float zView = 2.0 * n * f / (f + n - zNdc * (f - n));
+    ivec2 tile = clamp(ivec2(gl_FragCoord.xy / clusterScreenSize * vec2(clusterDims.xy)), ivec2(0), clusterDims.xy - 1);
+    int slice = clamp(int(log(zView / n) * float(clusterDims.z) / log(f / n)), 0, clusterDims.z - 1);
+    int cluster = (slice * clusterDims.y + tile.y) * clusterDims.x + tile.x;
+
+    uvec2 range = texelFetch(clusterGrid, cluster).xy;
+    for (uint i = 0u; i < range.y; ++i) {
+        int light = int(texelFetch(clusterLightIndices, int(range.x + i)).r);
+        vec4 posRadius = texelFetch(clusterLightData, 2 * light);
+        vec4 colorAmbient = texelFetch(clusterLightData, 2 * light + 1);
+
+        vec3 toLight = posRadius.xyz - P;
+        float dist = length(toLight);
+        float atten = 1.0;
+        if (posRadius.w > 0.0) {
+            atten = clamp(1.0 - dist / posRadius.w, 0.0, 1.0);
+            atten *= atten;
+            if (atten <= 0.0) continue;
+        }
+        vec3 L = toLight / max(dist, 1e-5);
+        vec3 lightColor = colorAmbient.rgb * atten;
+        ambient += colorAmbient.a * lightColor;
+        diffuse += max(dot(N, L), 0.0) * lightColor;
+        vec3 R = reflect(-L, N);
+        specular += pow(max(dot(R, V), 0.0), shininess) * lightColor;
+    }
+}
+)";
+}
@@ -0,0 +1,109 @@
+/* Iluminação forward+ em clusters
+ *
+ * A tela é dividida em blocos (tiles) e a profundidade em fatias exponenciais.
+ * Cada luz pontual é associada apenas aos clusters que o seu raio de alcance toca,
+ * e o fragment shader percorre só a lista de luzes do cluster em que está.
+ *
+ * Com OpenGL 4.3 ou mais a classificação é feita por um compute shader (uma invocação
+ * por cluster), que escreve a grade e as listas de índices em SSBOs. As entradas do
+ * compute (ausentes na GLAD 4.0) são carregadas pelo loader passado a init().
+ * Abaixo do 4.3 a classificação cai para a CPU, que envia as mesmas listas.
+ *
+ * Nos dois casos o fragment shader lê os buffers por texture buffers (samplerBuffer /
+ * usamplerBuffer), então o código GLSL de glslSource() funciona com #version 400.
+ */
+
+#ifndef CLUSTERED_LIGHTS_H
+#define CLUSTERED_LIGHTS_H
+
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Luz pontual da tabela de luzes
+// radius <= 0 indica uma luz sem atenuação, que afeta todos os clusters
+struct PointLight {
+    glm::vec3 position = glm::vec3(0.0f);
+    float radius = 0.0f;
+    glm::vec3 color = glm::vec3(1.0f);
+    float intensity = 1.0f;
+    float ambient = 0.0f; // peso da componente ambiente desta luz
+    bool enabled = true;
+};
+
+// Tabela dinâmica de luzes (substitui os vetores fixos como lightEnabled[3])
+class LightTable {
+public:
+    int add(const PointLight& light)
+    {
+        lights.push_back(light);
+        return (int)lights.size() - 1;
+    }
+    void resize(size_t count) { lights.resize(count); }
+    void toggle(int index) { lights[index].enabled = !lights[index].enabled; }
+    size_t size() const { return lights.size(); }
+    PointLight& operator[](size_t index) { return lights[index]; }
+    const PointLight& operator[](size_t index) const { return lights[index]; }
+
+private:
+    std::vector<PointLight> lights;
+};
+
+class ClusteredLights {
+public:
+    static const int TILES_X = 16;
+    static const int TILES_Y = 9;
+    static const int SLICES = 24;
+    static const int CLUSTER_COUNT = TILES_X * TILES_Y * SLICES;
+
+    // Cria os buffers e, se o contexto for 4.3 ou mais, o compute shader de
+    // classificação (loader: glfwGetProcAddress). Deve ser chamada com o contexto ativo
+    bool init(GLADloadproc loader);
+    void release();
+
+    // Envia as luzes habilitadas e as classifica nos clusters (na GPU ou na CPU).
+    // A classificação na GPU deixa o programa 0 ativo
+    void update(const LightTable& table, const glm::mat4& view, const glm::mat4& projection,
+                float nearPlane, float farPlane);
+
+    // Associa os texture buffers às unidades firstUnit, firstUnit+1 e firstUnit+2
+    // e define os uniforms usados pelo código GLSL de glslSource()
+    void bind(GLuint program, int firstUnit, int screenWidth, int screenHeight) const;
+
+    // Código GLSL (sem #version) com a função clusteredLighting()
+    static const char* glslSource();
+
+    // Classificação feita pelo compute shader. Nesse caso a quantidade de índices
+    // fica na GPU e lastIndexCount() retorna 0
+    bool gpuBinning() const { return binningProgram != 0; }
+
+    size_t lastLightCount() const { return uploadedLights; }
+    size_t lastIndexCount() const { return lightIndices.size(); }
+    size_t lastUploadedBytes() const { return uploadedBytes; }
+
+private:
+    void binOnCpu(const LightTable& table, const glm::mat4& view, const glm::mat4& projection);
+    void binOnGpu(const LightTable& table, const glm::mat4& view, const glm::mat4& projection);
+
+    GLuint lightsBuffer = 0, lightsTex = 0;
+    GLuint gridBuffer = 0, gridTex = 0;
+    GLuint indexBuffer = 0, indexTex = 0;
+    GLuint counterBuffer = 0;  // próximo índice livre (atomicAdd do compute shader)
+    GLuint binningProgram = 0; // 0: classificação na CPU
+    GLuint indexCapacity = 0;  // índices alocados em indexBuffer (classificação na GPU)
+    GLint maxTexels = 65536;
+    float nearPlane = 0.1f, farPlane = 100.0f;
+    size_t uploadedLights = 0;
+    size_t uploadedBytes = 0;
+    bool warnedOverflow = false;
+
+    // Dados de CPU reaproveitados entre quadros
+    std::vector<glm::vec4> lightData;          // 2 texels por luz
+    std::vector<int> lightRanges;              // 6 inteiros por luz (x0, x1, y0, y1, z0, z1)
+    std::vector<GLuint> clusterGrid;           // (offset, quantidade) por cluster
+    std::vector<GLuint> clusterFill;
+    std::vector<GLuint> lightIndices;
+};
+
+#endif
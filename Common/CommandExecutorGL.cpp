@@ -0,0 +1,68 @@
+/* Execução das listas de comandos no OpenGL - implementação
+ * Ver CommandExecutorGL.h
+ */
+
+#include "CommandExecutorGL.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+using namespace std;
+using namespace glm;
+
+const CommandExecutorGL::Locations& CommandExecutorGL::locationsOf(GLuint program)
+{
+    auto it = locations.find(program);
+    if (it != locations.end())
+        return it->second;
+    Locations found;
+    found.model = glGetUniformLocation(program, "model");
+    found.normalMatrix = glGetUniformLocation(program, "normalMatrix");
+    found.ka = glGetUniformLocation(program, "Ka");
+    found.kd = glGetUniformLocation(program, "Kd");
+    found.ks = glGetUniformLocation(program, "Ks");
+    found.shininess = glGetUniformLocation(program, "shininess");
+    return locations.emplace(program, found).first->second;
+}
+
+void CommandExecutorGL::execute(const CommandQueue& queue, const function<void(GLuint)>& onProgram)
+{
+    GLuint currentProgram = 0, currentTexture = 0, currentVertexArray = 0;
+    const Locations* current = nullptr;
+    stateChanges = 0;
+    drawCalls = 0;
+    triangles = 0;
+
+    for (const CommandQueue::SortedCommand& entry : queue.sorted()) {
+        const DrawCommand& command = queue.command(entry);
+        if (command.program != currentProgram || !current) {
+            currentProgram = command.program;
+            glUseProgram(currentProgram);
+            current = &locationsOf(currentProgram);
+            if (onProgram)
+                onProgram(currentProgram);
+            ++stateChanges;
+        }
+        if (command.texture != 0 && command.texture != currentTexture) {
+            currentTexture = command.texture;
+            glBindTexture(GL_TEXTURE_2D, currentTexture);
+            ++stateChanges;
+        }
+        if (command.vertexArray != currentVertexArray) {
+            currentVertexArray = command.vertexArray;
+            glBindVertexArray(currentVertexArray);
+            ++stateChanges;
+        }
+
+        const DrawUniforms& uniforms = queue.uniforms(entry);
+        glUniformMatrix4fv(current->model, 1, GL_FALSE, value_ptr(uniforms.model));
+        glUniformMatrix3fv(current->normalMatrix, 1, GL_FALSE, value_ptr(uniforms.normalMatrix));
+        glUniform3fv(current->ka, 1, value_ptr(uniforms.ka));
+        glUniform3fv(current->kd, 1, value_ptr(uniforms.kd));
+        glUniform3fv(current->ks, 1, value_ptr(uniforms.ks));
+        glUniform1f(current->shininess, uniforms.shininess);
+        glDrawArrays(GL_TRIANGLES, command.first, command.count);
+        ++drawCalls;
+        triangles += command.count / 3;
+    }
+    glBindVertexArray(0);
+}
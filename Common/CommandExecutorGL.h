@@ -0,0 +1,45 @@
+/* Execução das listas de comandos no OpenGL
+ *
+ * Percorre os comandos já ordenados de uma CommandQueue na thread do OpenGL e só
+ * troca programa, textura e VAO quando eles mudam. As posições dos uniforms de
+ * cada programa são consultadas uma vez e guardadas.
+ */
+
+#ifndef COMMAND_EXECUTOR_GL_H
+#define COMMAND_EXECUTOR_GL_H
+
+#include <functional>
+#include <unordered_map>
+
+#include <glad/glad.h>
+
+#include "CommandList.h"
+
+class CommandExecutorGL {
+public:
+    // onProgram é chamada logo depois de cada troca de programa, para os uniforms
+    // do passo (projection, view, luzes...). A textura é ligada na unidade ativa
+    void execute(const CommandQueue& queue, const std::function<void(GLuint)>& onProgram = nullptr);
+
+    // Descarta as posições guardadas. Deve ser chamada quando programas são apagados:
+    // o OpenGL pode reaproveitar o identificador em um programa novo
+    void clear() { locations.clear(); }
+
+    // Trocas de estado (programa + textura + VAO), draw calls e triângulos da última execução
+    size_t lastStateChanges() const { return stateChanges; }
+    size_t lastDrawCalls() const { return drawCalls; }
+    size_t lastTriangles() const { return triangles; }
+
+private:
+    struct Locations {
+        GLint model, normalMatrix, ka, kd, ks, shininess;
+    };
+    const Locations& locationsOf(GLuint program);
+
+    std::unordered_map<GLuint, Locations> locations;
+    size_t stateChanges = 0;
+    size_t drawCalls = 0;
+    size_t triangles = 0;
+};
+
+#endif
@@ -0,0 +1,60 @@
+/* Listas de comandos de desenho - implementação
+ * Ver CommandList.h
+ */
+
+#include "CommandList.h"
+
+#include <algorithm>
+
+using namespace std;
+
+uint64_t drawSortKey(uint32_t program, uint32_t texture, uint32_t vertexArray, float depth)
+{
+    // 10 bits de programa, 14 de textura, 12 de VAO e 28 de profundidade
+    uint64_t quantizedDepth = (uint64_t)(glm::clamp(depth, 0.0f, 1.0f) * ((1 << 28) - 1));
+    return ((uint64_t)(program & 0x3FF) << 54) | ((uint64_t)(texture & 0x3FFF) << 40) |
+           ((uint64_t)(vertexArray & 0xFFF) << 28) | quantizedDepth;
+}
+
+void CommandList::reset()
+{
+    commands.clear();
+    uniforms.clear();
+}
+
+DrawUniforms& CommandList::draw(uint64_t key, uint32_t sequence, uint32_t program, uint32_t vertexArray,
+                                uint32_t texture, int32_t first, int32_t count)
+{
+    DrawCommand command;
+    command.key = key;
+    command.sequence = sequence;
+    command.program = program;
+    command.vertexArray = vertexArray;
+    command.texture = texture;
+    command.first = first;
+    command.count = count;
+    command.uniforms = (uint32_t)uniforms.size();
+    commands.push_back(command);
+    uniforms.emplace_back();
+    return uniforms.back();
+}
+
+void CommandQueue::reset()
+{
+    for (CommandList& list : lists)
+        list.reset();
+}
+
+void CommandQueue::merge()
+{
+    order.clear();
+    for (uint32_t l = 0; l < lists.size(); ++l)
+        for (uint32_t i = 0; i < lists[l].commands.size(); ++i)
+            order.push_back({ lists[l].commands[i].key, lists[l].commands[i].sequence, l, i });
+
+    // A distribuição dos objetos entre as threads muda a cada quadro; o desempate pela
+    // sequência deixa a ordem final igual à de uma gravação serial
+    sort(order.begin(), order.end(), [](const SortedCommand& a, const SortedCommand& b) {
+        return a.key != b.key ? a.key < b.key : a.sequence < b.sequence;
+    });
+}
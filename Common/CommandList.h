@@ -0,0 +1,91 @@
+/* Listas de comandos de desenho gravadas em paralelo
+ *
+ * As chamadas OpenGL precisam acontecer em uma única thread, mas decidir o que
+ * desenhar (percorrer os objetos, culling, montar os uniforms) não. Cada thread
+ * grava comandos compactos na sua própria CommandList (vetores reaproveitados de
+ * um quadro para o outro, sem alocação depois do primeiro quadro); a thread do
+ * OpenGL junta as listas, ordena pela chave e executa (ver CommandExecutorGL.h).
+ *
+ * Esta camada não chama a API gráfica: programas, VAOs e texturas são só ids.
+ */
+
+#ifndef COMMAND_LIST_H
+#define COMMAND_LIST_H
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Uniforms de um desenho com Phong, já empacotados pela thread que gravou
+struct DrawUniforms {
+    glm::mat4 model;
+    glm::mat3 normalMatrix;
+    glm::vec3 ka, kd, ks;
+    float shininess;
+};
+
+struct DrawCommand {
+    uint64_t key;          // ordem de execução (ver drawSortKey)
+    uint32_t sequence;     // desempate entre chaves iguais (ex.: id da entidade), para uma ordem estável
+    uint32_t program;
+    uint32_t vertexArray;
+    uint32_t texture;      // 0 = mantém a textura atual
+    int32_t first;
+    int32_t count;
+    uint32_t uniforms;     // índice em CommandList::uniforms
+};
+
+// Chave que agrupa os desenhos por programa, textura e VAO (menos trocas de estado) e,
+// dentro do mesmo estado, da frente para trás (depth em [0, 1], para o early-Z)
+uint64_t drawSortKey(uint32_t program, uint32_t texture, uint32_t vertexArray, float depth);
+
+// Comandos gravados por uma thread
+class CommandList {
+public:
+    void reset();
+
+    // Grava um desenho e retorna os uniforms para a thread preencher
+    DrawUniforms& draw(uint64_t key, uint32_t sequence, uint32_t program, uint32_t vertexArray,
+                       uint32_t texture, int32_t first, int32_t count);
+
+    std::vector<DrawCommand> commands;
+    std::vector<DrawUniforms> uniforms;
+};
+
+// Uma lista por thread, juntadas e ordenadas pela thread que executa
+class CommandQueue {
+public:
+    explicit CommandQueue(unsigned listCount = 1) : lists(listCount) {}
+
+    // Lista da thread de índice worker (ex.: JobSystem::workerIndex())
+    CommandList& list(unsigned worker) { return lists[worker]; }
+    unsigned listCount() const { return (unsigned)lists.size(); }
+
+    // Esvazia todas as listas (início do quadro)
+    void reset();
+
+    // Junta os comandos de todas as listas em ordem de chave
+    void merge();
+
+    struct SortedCommand {
+        uint64_t key;
+        uint32_t sequence;
+        uint32_t list;
+        uint32_t index;
+    };
+    // Resultado de merge()
+    const std::vector<SortedCommand>& sorted() const { return order; }
+    const DrawCommand& command(const SortedCommand& entry) const { return lists[entry.list].commands[entry.index]; }
+    const DrawUniforms& uniforms(const SortedCommand& entry) const
+    {
+        const CommandList& list = lists[entry.list];
+        return list.uniforms[list.commands[entry.index].uniforms];
+    }
+
+private:
+    std::vector<CommandList> lists;
+    std::vector<SortedCommand> order;
+};
+
+#endif
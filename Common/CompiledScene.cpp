@@ -0,0 +1,371 @@
+/* Cena compilada - implementação
+ * Ver CompiledScene.h
+ */
+
+#include "CompiledScene.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "FrameProfiler.h"
+
+using namespace std;
+using namespace glm;
+
+static const char SCENE_MAGIC[4] = { 'C', 'E', 'N', 'A' };
+static const uint16_t SCENE_VERSION = 1;
+
+static inline uint64_t align8(uint64_t offset)
+{
+    return (offset + 7) & ~(uint64_t)7;
+}
+
+// --- Compilação ---
+
+void compileScene(const SceneConfig& scene, vector<uint8_t>& blob)
+{
+    PROFILE_SCOPE("compileScene");
+    const size_t objectCount = scene.objects.size();
+
+    // Strings: os nomes dos objetos primeiro (a string i é o nome do objeto i), depois os
+    // caminhos, cada um uma vez só
+    vector<const string*> texts;
+    texts.reserve(objectCount + 16);
+    for (StringId id = 0; id < objectCount; ++id)
+        texts.push_back(&scene.objectNames.str(id));
+    unordered_map<string, uint32_t> files;
+    auto fileId = [&texts, &files](const string& path) -> uint32_t {
+        if (path.empty())
+            return SCENE_NONE;
+        auto inserted = files.emplace(path, (uint32_t)texts.size());
+        if (inserted.second)
+            texts.push_back(&inserted.first->first);
+        return inserted.first->second;
+    };
+
+    vector<SceneObjectRecord> objects(objectCount);
+    vector<SceneTrackRecord> tracks;
+    vector<float> times;
+    vector<vec4> values;
+    for (size_t i = 0; i < objectCount; ++i) {
+        const ObjectConfig& cfg = scene.objects[i];
+        SceneObjectRecord& record = objects[i];
+        record.name = (uint32_t)i;
+        record.objFile = fileId(cfg.objFile);
+        record.mtlFile = fileId(cfg.mtlFile);
+        record.textureFile = fileId(cfg.textureFile);
+        record.alphaTextureFile = fileId(cfg.alphaTextureFile);
+        record.parent = cfg.parent;
+        record.orbitTarget = cfg.orbitTarget;
+        record.animation = (uint32_t)cfg.animation;
+        memcpy(record.position, &cfg.position, sizeof(record.position));
+        memcpy(record.rotation, &cfg.rotation, sizeof(record.rotation));
+        memcpy(record.scale, &cfg.scale, sizeof(record.scale));
+        record.orbitRadius = cfg.orbitRadius;
+        record.orbitSpeed = cfg.orbitSpeed;
+        record.firstTrack = (uint32_t)tracks.size();
+        record.trackCount = (uint32_t)cfg.tracks.size();
+        for (const TrackConfig& track : cfg.tracks) {
+            tracks.push_back({ (uint32_t)track.target, (uint32_t)track.times.size(), (uint64_t)times.size() });
+            times.insert(times.end(), track.times.begin(), track.times.end());
+            values.insert(values.end(), track.values.begin(), track.values.end());
+        }
+    }
+
+    SceneBlobHeader header = {};
+    memcpy(header.magic, SCENE_MAGIC, 4);
+    header.version = SCENE_VERSION;
+    header.objectCount = (uint32_t)objectCount;
+    header.trackCount = (uint32_t)tracks.size();
+    header.keyCount = (uint32_t)times.size();
+    header.stringCount = (uint32_t)texts.size();
+    const CameraConfig& camera = scene.camera;
+    float cameraValues[8] = { camera.position.x, camera.position.y, camera.position.z, camera.yaw, camera.pitch,
+                              camera.fov, camera.nearPlane, camera.farPlane };
+    memcpy(header.camera, cameraValues, sizeof(header.camera));
+    memcpy(header.light, &scene.light.position, sizeof(vec3));
+    memcpy(header.light + 3, &scene.light.color, sizeof(vec3));
+
+    // Seções alinhadas em 8 bytes
+    uint64_t offset = align8(sizeof(SceneBlobHeader));
+    header.objectsOffset = offset;
+    offset = align8(offset + objects.size() * sizeof(SceneObjectRecord));
+    header.tracksOffset = offset;
+    offset = align8(offset + tracks.size() * sizeof(SceneTrackRecord));
+    header.timesOffset = offset;
+    offset = align8(offset + times.size() * sizeof(float));
+    header.valuesOffset = offset;
+    offset = align8(offset + values.size() * sizeof(vec4));
+    header.stringsOffset = offset;
+    offset += texts.size() * sizeof(SceneStringSlot);
+    uint64_t textOffset = offset;
+    for (const string* text : texts)
+        offset += text->size() + 1;
+    header.fileSize = align8(offset + 1); // termina em zero: nenhum texto passa do fim
+
+    blob.assign((size_t)header.fileSize, 0);
+    uint8_t* out = blob.data();
+    memcpy(out, &header, sizeof(header));
+    if (!objects.empty())
+        memcpy(out + header.objectsOffset, objects.data(), objects.size() * sizeof(SceneObjectRecord));
+    if (!tracks.empty()) {
+        memcpy(out + header.tracksOffset, tracks.data(), tracks.size() * sizeof(SceneTrackRecord));
+        memcpy(out + header.timesOffset, times.data(), times.size() * sizeof(float));
+        memcpy(out + header.valuesOffset, values.data(), values.size() * sizeof(vec4));
+    }
+    SceneStringSlot* slots = reinterpret_cast<SceneStringSlot*>(out + header.stringsOffset);
+    for (size_t i = 0; i < texts.size(); ++i) {
+        slots[i].offset = textOffset;
+        memcpy(out + textOffset, texts[i]->c_str(), texts[i]->size() + 1);
+        textOffset += texts[i]->size() + 1;
+    }
+}
+
+// Grava em um arquivo temporário e o renomeia por cima de path: quem está com a cena
+// antiga mapeada (CompiledScene::open, inclusive a recarga a quente do TrabalhoGB)
+// continua lendo o arquivo antigo, que não é truncado
+bool saveCompiledScene(const SceneConfig& scene, const string& path)
+{
+    vector<uint8_t> blob;
+    compileScene(scene, blob);
+    string temporary = path + ".tmp";
+    FILE* file = fopen(temporary.c_str(), "wb");
+    if (!file) {
+        cout << "Erro ao gravar cena compilada: " << path << endl;
+        return false;
+    }
+    bool ok = fwrite(blob.data(), 1, blob.size(), file) == blob.size();
+    ok = fclose(file) == 0 && ok;
+    error_code error;
+    if (ok)
+        filesystem::rename(temporary, path, error);
+    if (!ok || error) {
+        filesystem::remove(temporary, error);
+        cout << "Erro ao gravar cena compilada: " << path << endl;
+        return false;
+    }
+    return true;
+}
+
+// --- Leitura ---
+
+bool CompiledScene::open(const string& path)
+{
+    PROFILE_SCOPE("CompiledScene::open");
+    close();
+    // Cópia na escrita: a correção da tabela de strings não volta para o arquivo
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(SceneBlobHeader)) {
+        CloseHandle(handle);
+        return false;
+    }
+    HANDLE view = CreateFileMappingA(handle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    void* mappedView = view ? MapViewOfFile(view, FILE_MAP_COPY, 0, 0, 0) : nullptr;
+    if (!mappedView) {
+        if (view)
+            CloseHandle(view);
+        CloseHandle(handle);
+        return false;
+    }
+    file = handle;
+    mapping = view;
+    size = (size_t)fileSize.QuadPart;
+    data = static_cast<uint8_t*>(mappedView);
+#else
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        return false;
+    struct stat info;
+    if (fstat(descriptor, &info) != 0 || info.st_size < (off_t)sizeof(SceneBlobHeader)) {
+        ::close(descriptor);
+        return false;
+    }
+    // Sem MAP_POPULATE: num mapeamento privado gravável ele copiaria todas as páginas;
+    // assim só as da tabela de strings deixam de ser as do cache de arquivos
+    void* view = mmap(nullptr, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor); // o mapeamento continua valendo
+    if (view == MAP_FAILED)
+        return false;
+    madvise(view, (size_t)info.st_size, MADV_WILLNEED);
+    size = (size_t)info.st_size;
+    data = static_cast<uint8_t*>(view);
+#endif
+    mapped = true;
+    if (!fixUp()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool CompiledScene::openMemory(vector<uint8_t>&& blob)
+{
+    close();
+    memory = std::move(blob);
+    data = memory.data();
+    size = memory.size();
+    if (!fixUp()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void CompiledScene::close()
+{
+    if (mapped) {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle((HANDLE)mapping);
+        CloseHandle((HANDLE)file);
+        mapping = file = nullptr;
+#else
+        munmap(data, size);
+#endif
+    }
+    mapped = false;
+    memory.clear();
+    memory.shrink_to_fit();
+    data = nullptr;
+    size = 0;
+    header = nullptr;
+    objects = nullptr;
+    tracks = nullptr;
+    times = nullptr;
+    values = nullptr;
+    strings = nullptr;
+    camera = CameraConfig();
+    light = LightConfig();
+}
+
+// Os ponteiros apontam para o mapeamento ou para o buffer de memory, que não mudam de
+// lugar com a troca
+void CompiledScene::swap(CompiledScene& other)
+{
+    std::swap(data, other.data);
+    std::swap(size, other.size);
+    memory.swap(other.memory);
+    std::swap(mapped, other.mapped);
+#ifdef _WIN32
+    std::swap(file, other.file);
+    std::swap(mapping, other.mapping);
+#endif
+    std::swap(header, other.header);
+    std::swap(objects, other.objects);
+    std::swap(tracks, other.tracks);
+    std::swap(times, other.times);
+    std::swap(values, other.values);
+    std::swap(strings, other.strings);
+    std::swap(camera, other.camera);
+    std::swap(light, other.light);
+}
+
+// Confere o cabeçalho e os limites das seções e troca os deslocamentos das strings por
+// ponteiros. Os registros dos objetos não são lidos aqui (ver validObject): abrir uma
+// cena de um milhão de objetos toca só a tabela de strings
+bool CompiledScene::fixUp()
+{
+    if (size < sizeof(SceneBlobHeader))
+        return false;
+    const SceneBlobHeader& h = *reinterpret_cast<const SceneBlobHeader*>(data);
+    auto inside = [this](uint64_t offset, uint64_t count, uint64_t elementSize) {
+        return offset % 8 == 0 && offset <= size && count <= (size - offset) / elementSize;
+    };
+    bool valid = memcmp(h.magic, SCENE_MAGIC, 4) == 0 && h.version == SCENE_VERSION && h.fileSize == size &&
+                 data[size - 1] == 0 && inside(h.objectsOffset, h.objectCount, sizeof(SceneObjectRecord)) &&
+                 inside(h.tracksOffset, h.trackCount, sizeof(SceneTrackRecord)) &&
+                 inside(h.timesOffset, h.keyCount, sizeof(float)) &&
+                 inside(h.valuesOffset, h.keyCount, 4 * sizeof(float)) &&
+                 inside(h.stringsOffset, h.stringCount, sizeof(SceneStringSlot));
+    if (!valid)
+        return false;
+
+    SceneStringSlot* slots = reinterpret_cast<SceneStringSlot*>(data + h.stringsOffset);
+    for (uint32_t i = 0; i < h.stringCount; ++i) {
+        if (slots[i].offset >= size)
+            return false;
+        slots[i].text = reinterpret_cast<const char*>(data + slots[i].offset);
+    }
+
+    header = &h;
+    objects = reinterpret_cast<const SceneObjectRecord*>(data + h.objectsOffset);
+    tracks = reinterpret_cast<const SceneTrackRecord*>(data + h.tracksOffset);
+    times = reinterpret_cast<const float*>(data + h.timesOffset);
+    values = reinterpret_cast<const vec4*>(data + h.valuesOffset);
+    strings = slots;
+    camera.position = vec3(h.camera[0], h.camera[1], h.camera[2]);
+    camera.yaw = h.camera[3];
+    camera.pitch = h.camera[4];
+    camera.fov = h.camera[5];
+    camera.nearPlane = h.camera[6];
+    camera.farPlane = h.camera[7];
+    light.position = vec3(h.light[0], h.light[1], h.light[2]);
+    light.color = vec3(h.light[3], h.light[4], h.light[5]);
+    return true;
+}
+
+bool CompiledScene::validObject(size_t index) const
+{
+    const SceneBlobHeader& h = *header;
+    const SceneObjectRecord& record = objects[index];
+    auto stringOk = [&h](uint32_t id) { return id == SCENE_NONE || id < h.stringCount; };
+    auto objectOk = [&h](uint32_t id) { return id == SCENE_NONE || id < h.objectCount; };
+    if (!stringOk(record.name) || !stringOk(record.objFile) || !stringOk(record.mtlFile) ||
+        !stringOk(record.textureFile) || !stringOk(record.alphaTextureFile) || !objectOk(record.parent) ||
+        !objectOk(record.orbitTarget) || record.animation > ANIMATION_ORBIT || record.firstTrack > h.trackCount ||
+        record.trackCount > h.trackCount - record.firstTrack)
+        return false;
+    for (uint32_t t = record.firstTrack; t < record.firstTrack + record.trackCount; ++t) {
+        const SceneTrackRecord& track = tracks[t];
+        if (track.target >= TRACK_TARGET_COUNT || track.firstKey > h.keyCount ||
+            track.keyCount > h.keyCount - track.firstKey)
+            return false;
+    }
+    return true;
+}
+
+bool loadScene(const string& path, CompiledScene& scene, vector<string>* files)
+{
+    PROFILE_SCOPE("loadScene");
+    char magic[4] = {};
+    ifstream file(path, ios::binary);
+    file.read(magic, 4);
+    file.close();
+    if (memcmp(magic, SCENE_MAGIC, 4) == 0) {
+        if (!scene.open(path)) {
+            cout << "Cena compilada invalida: " << path << endl;
+            return false;
+        }
+        if (files)
+            *files = { path };
+        return true;
+    }
+
+    SceneConfig config;
+    if (!loadSceneConfig(path, config))
+        return false;
+    if (files)
+        *files = config.files;
+    vector<uint8_t> blob;
+    compileScene(config, blob);
+    return scene.openMemory(std::move(blob));
+}
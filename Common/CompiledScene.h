@@ -0,0 +1,144 @@
+/* Cena compilada: arquivo binário (.cena) carregado com um único mmap
+ *
+ * compileScene() achata um SceneConfig (prefabs, vetores de instâncias e includes já
+ * resolvidos) em um bloco de bytes little-endian:
+ *
+ *     SceneBlobHeader | objetos | trilhas | tempos | valores | tabela de strings | texto
+ *
+ * Os objetos são registros de tamanho fixo (SceneObjectRecord) que citam arquivos e
+ * nomes pelo índice na tabela de strings, sem repetir o texto: cada caminho aparece uma
+ * vez no arquivo, qualquer que seja o número de objetos que o usam. Pais e alvos de
+ * órbita são índices de objetos.
+ *
+ * CompiledScene::open() mapeia o arquivo inteiro (cópia na escrita) e faz uma única
+ * passada de correção: confere o cabeçalho e os limites das seções, e troca os
+ * deslocamentos da tabela de strings por ponteiros. Os objetos são lidos depois direto
+ * do mapeamento, sem alocação por objeto, e só as páginas usadas saem do disco; quem
+ * lê um objeto confere os seus índices com validObject(). Uma cena texto também pode
+ * ser aberta assim (loadScene compila em memória), e o resto do programa lê só
+ * CompiledScene.
+ */
+
+#ifndef COMPILED_SCENE_H
+#define COMPILED_SCENE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SceneConfig.h"
+
+const uint32_t SCENE_NONE = 0xFFFFFFFFu; // string ou objeto ausente
+
+struct SceneBlobHeader {
+    char magic[4];          // "CENA"
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t objectCount;
+    uint32_t trackCount;
+    uint32_t keyCount;      // chaves de todas as trilhas
+    uint32_t stringCount;
+    uint64_t fileSize;
+    uint64_t objectsOffset; // SceneObjectRecord[objectCount]
+    uint64_t tracksOffset;  // SceneTrackRecord[trackCount]
+    uint64_t timesOffset;   // float[keyCount]
+    uint64_t valuesOffset;  // float[4 * keyCount]
+    uint64_t stringsOffset; // SceneStringSlot[stringCount]
+    float camera[8];        // posição, yaw, pitch, fov, near, far
+    float light[6];         // posição, cor
+};
+static_assert(sizeof(SceneBlobHeader) == 128, "cabecalho da cena compilada deve ter 128 bytes");
+
+struct SceneObjectRecord {
+    uint32_t name;          // strings
+    uint32_t objFile;
+    uint32_t mtlFile;
+    uint32_t textureFile;
+    uint32_t alphaTextureFile;
+    uint32_t parent;        // objetos
+    uint32_t orbitTarget;
+    uint32_t animation;     // AnimationKind
+    float position[3];
+    float rotation[3];      // graus (Euler, como no arquivo texto)
+    float scale[3];
+    float orbitRadius;
+    float orbitSpeed;
+    uint32_t firstTrack;    // trilhas [firstTrack, firstTrack + trackCount)
+    uint32_t trackCount;
+    uint32_t reserved;
+};
+static_assert(sizeof(SceneObjectRecord) == 88, "registro de objeto deve ter 88 bytes");
+
+struct SceneTrackRecord {
+    uint32_t target;        // TrackTarget
+    uint32_t keyCount;
+    uint64_t firstKey;      // em tempos e valores
+};
+static_assert(sizeof(SceneTrackRecord) == 16, "registro de trilha deve ter 16 bytes");
+
+// No arquivo, o deslocamento do texto (terminado em zero); depois de open(), o ponteiro
+union SceneStringSlot {
+    uint64_t offset;
+    const char* text;
+};
+static_assert(sizeof(SceneStringSlot) == 8, "entrada da tabela de strings deve ter 8 bytes");
+
+// Bytes do arquivo .cena de scene
+void compileScene(const SceneConfig& scene, std::vector<uint8_t>& blob);
+// false se o arquivo não pode ser gravado
+bool saveCompiledScene(const SceneConfig& scene, const std::string& path);
+
+class CompiledScene {
+public:
+    CompiledScene() = default;
+    ~CompiledScene() { close(); }
+    CompiledScene(const CompiledScene&) = delete;
+    CompiledScene& operator=(const CompiledScene&) = delete;
+
+    // Mapeia um .cena; false se ele não existe ou não é válido
+    bool open(const std::string& path);
+    // Usa os bytes de compileScene (o vetor é movido para cá)
+    bool openMemory(std::vector<uint8_t>&& blob);
+    void close();
+    // Troca as cenas (ex.: a recarregada por outra thread entra no lugar da atual)
+    void swap(CompiledScene& other);
+
+    size_t objectCount() const { return header ? header->objectCount : 0; }
+    const SceneObjectRecord& object(size_t index) const { return objects[index]; }
+    // false se o objeto cita strings, objetos ou trilhas fora do arquivo (corrompido)
+    bool validObject(size_t index) const;
+    const SceneTrackRecord& track(size_t index) const { return tracks[index]; }
+    const float* keyTimes(const SceneTrackRecord& track) const { return times + track.firstKey; }
+    const glm::vec4* keyValues(const SceneTrackRecord& track) const { return values + track.firstKey; }
+    // Texto da string (vazio para SCENE_NONE)
+    const char* str(uint32_t id) const { return id == SCENE_NONE ? "" : strings[id].text; }
+    size_t sizeBytes() const { return size; }
+
+    // Câmera e luz do arquivo (podem ser mudadas pelo programa, ex.: --camera)
+    CameraConfig camera;
+    LightConfig light;
+
+private:
+    bool fixUp();
+
+    uint8_t* data = nullptr;
+    size_t size = 0;
+    std::vector<uint8_t> memory; // openMemory
+    bool mapped = false;
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+    const SceneBlobHeader* header = nullptr;
+    const SceneObjectRecord* objects = nullptr;
+    const SceneTrackRecord* tracks = nullptr;
+    const float* times = nullptr;
+    const glm::vec4* values = nullptr;
+    const SceneStringSlot* strings = nullptr;
+};
+
+// Abre path como .cena (pelo "CENA" no início) ou como cena texto, compilada em memória.
+// files recebe os arquivos lidos (o .cena, ou o texto e os seus includes)
+bool loadScene(const std::string& path, CompiledScene& scene, std::vector<std::string>* files = nullptr);
+
+#endif
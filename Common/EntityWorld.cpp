@@ -0,0 +1,384 @@
+/* Mundo de entidades orientado a dados - implementação
+ * Ver EntityWorld.h
+ */
+
+#include "EntityWorld.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "JobSystem.h"
+#include "NormalMatrix.h"
+#include "QuatMatrix.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ENTITY_WORLD_SSE 1
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+using namespace glm;
+
+Entity EntityWorld::create(const string& name)
+{
+    Entity entity = (Entity)names.size();
+    names.push_back(name);
+    parents.push_back(INVALID_ENTITY);
+    dirty.push_back(1);
+    positions.push_back(vec3(0.0f));
+    rotations.push_back(quat(1.0f, 0.0f, 0.0f, 0.0f));
+    scales.push_back(vec3(1.0f));
+    localMatrices.push_back(mat4(1.0f));
+    models.push_back(mat4(1.0f));
+    normalMatrices.push_back(mat3(1.0f));
+    vaos.push_back(0);
+    vertexCounts.push_back(0);
+    textures.push_back(0);
+    alphaTextures.push_back(0);
+    materials.push_back(Material());
+    animations.push_back(ANIMATION_NONE);
+    orbitCenters.push_back(vec3(0.0f));
+    orbitRadii.push_back(0.0f);
+    orbitSpeeds.push_back(0.0f);
+    orbitAngles.push_back(0.0f);
+    boundingRadii.push_back(0.0f);
+    visible.push_back(1);
+    previousOrbitAngles.push_back(0.0f);
+    if (!name.empty())
+        byName[name] = entity;
+    hierarchyChanged = true;
+    return entity;
+}
+
+void EntityWorld::reserve(size_t count)
+{
+    names.reserve(count);
+    parents.reserve(count);
+    dirty.reserve(count);
+    positions.reserve(count);
+    rotations.reserve(count);
+    scales.reserve(count);
+    localMatrices.reserve(count);
+    models.reserve(count);
+    normalMatrices.reserve(count);
+    vaos.reserve(count);
+    vertexCounts.reserve(count);
+    textures.reserve(count);
+    alphaTextures.reserve(count);
+    materials.reserve(count);
+    animations.reserve(count);
+    transformOrder.reserve(count);
+    parentSlots.reserve(count);
+    rigidWorlds.reserve(count);
+    orbitCenters.reserve(count);
+    orbitRadii.reserve(count);
+    orbitSpeeds.reserve(count);
+    orbitAngles.reserve(count);
+    boundingRadii.reserve(count);
+    visible.reserve(count);
+    previousOrbitAngles.reserve(count);
+}
+
+void EntityWorld::clear()
+{
+    *this = EntityWorld();
+}
+
+void EntityWorld::destroy(Entity entity)
+{
+    if (!names[entity].empty())
+        byName.erase(names[entity]);
+    names[entity].clear();
+    vaos[entity] = 0;
+    vertexCounts[entity] = 0;
+    textures[entity] = 0;
+    alphaTextures[entity] = 0;
+    animations[entity] = ANIMATION_NONE;
+    visible[entity] = 0;
+    if (parents[entity] != INVALID_ENTITY) {
+        parents[entity] = INVALID_ENTITY;
+        hierarchyChanged = true;
+    }
+}
+
+Entity EntityWorld::find(const string& name) const
+{
+    auto it = byName.find(name);
+    return it != byName.end() ? it->second : INVALID_ENTITY;
+}
+
+void EntityWorld::setParent(Entity child, Entity parent)
+{
+    // Um ancestral do novo pai não pode ser o próprio filho
+    for (Entity e = parent; e != INVALID_ENTITY; e = parents[e])
+        if (e == child)
+            return;
+    parents[child] = parent;
+    dirty[child] = 1;
+    hierarchyChanged = true;
+}
+
+void stepOrbits(EntityWorld& world, float step, Entity skip, size_t first, size_t count)
+{
+    size_t last = first + std::min(count, world.size() - first);
+    const AnimationKind* animations = world.animations.data();
+    const float* speeds = world.orbitSpeeds.data();
+    float* angles = world.orbitAngles.data();
+    float* previousAngles = world.previousOrbitAngles.data();
+
+    for (size_t i = first; i < last; ++i) {
+        if (animations[i] != ANIMATION_ORBIT || i == skip)
+            continue;
+        previousAngles[i] = angles[i];
+        angles[i] += speeds[i] * step;
+    }
+}
+
+void applyOrbits(EntityWorld& world, float alpha, Entity skip, size_t first, size_t count)
+{
+    size_t last = first + std::min(count, world.size() - first);
+    const AnimationKind* animations = world.animations.data();
+    vec3* positions = world.positions.data();
+    quat* rotations = world.rotations.data();
+
+    for (size_t i = first; i < last; ++i) {
+        if (animations[i] != ANIMATION_ORBIT || i == skip)
+            continue;
+        float angle = mix(world.previousOrbitAngles[i], world.orbitAngles[i], alpha);
+        const vec3& center = world.orbitCenters[i];
+        float radius = world.orbitRadii[i];
+        positions[i].x = center.x + radius * cos(angle);
+        positions[i].z = center.z + radius * sin(angle);
+
+        // O objeto aponta para a direção do movimento
+        rotations[i] = angleAxis(angle + half_pi<float>(), vec3(0.0f, 1.0f, 0.0f));
+        world.dirty[i] = 1;
+    }
+}
+
+void updateOrbits(EntityWorld& world, float deltaTime, Entity skip, size_t first, size_t count)
+{
+    stepOrbits(world, deltaTime, skip, first, count);
+    applyOrbits(world, 1.0f, skip, first, count);
+}
+
+// Refaz a ordem em largura: raízes primeiro, depois cada nível. Dentro de um nível as
+// entidades ficam na ordem de criação, para que a travessia leia os componentes
+// (indexados pelo id) em ordem crescente de endereço
+static void rebuildHierarchy(EntityWorld& world)
+{
+    size_t count = world.size();
+    vector<uint32_t> childStart(count + 1, 0), children(count);
+    for (size_t i = 0; i < count; ++i)
+        if (world.parents[i] != INVALID_ENTITY)
+            ++childStart[world.parents[i] + 1];
+    for (size_t i = 0; i < count; ++i)
+        childStart[i + 1] += childStart[i];
+    vector<uint32_t> fill(childStart.begin(), childStart.end() - 1);
+    for (size_t i = 0; i < count; ++i)
+        if (world.parents[i] != INVALID_ENTITY)
+            children[fill[world.parents[i]]++] = (uint32_t)i;
+
+    vector<Entity>& order = world.transformOrder;
+    order.clear();
+    world.levelStarts.clear();
+    for (size_t i = 0; i < count; ++i)
+        if (world.parents[i] == INVALID_ENTITY)
+            order.push_back((Entity)i);
+    // A própria lista de saída serve de fila, um nível por vez
+    for (size_t levelStart = 0; levelStart < order.size();) {
+        size_t levelEnd = order.size();
+        world.levelStarts.push_back((uint32_t)levelStart);
+        sort(order.begin() + levelStart, order.begin() + levelEnd);
+        for (size_t slot = levelStart; slot < levelEnd; ++slot) {
+            Entity parent = order[slot];
+            order.insert(order.end(), children.begin() + childStart[parent], children.begin() + childStart[parent + 1]);
+        }
+        levelStart = levelEnd;
+    }
+    world.levelStarts.push_back((uint32_t)order.size());
+
+    vector<uint32_t> slotOf(count);
+    for (size_t slot = 0; slot < order.size(); ++slot)
+        slotOf[order[slot]] = (uint32_t)slot;
+    world.parentSlots.resize(order.size());
+    for (size_t slot = 0; slot < order.size(); ++slot) {
+        Entity parent = world.parents[order[slot]];
+        world.parentSlots[slot] = parent != INVALID_ENTITY ? slotOf[parent] : INVALID_ENTITY;
+    }
+    world.rigidWorlds.assign(count, mat4(1.0f));
+    fill_n(world.dirty.begin(), count, 1);
+    world.hierarchyChanged = false;
+}
+
+// result = a * b com as colunas de b combinando as colunas de a
+static inline void multiplyMatrices(const mat4& a, const mat4& b, mat4& result)
+{
+#ifdef ENTITY_WORLD_SSE
+    __m128 a0 = _mm_loadu_ps(&a[0][0]), a1 = _mm_loadu_ps(&a[1][0]);
+    __m128 a2 = _mm_loadu_ps(&a[2][0]), a3 = _mm_loadu_ps(&a[3][0]);
+    for (int c = 0; c < 4; ++c) {
+        __m128 column = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, _mm_set1_ps(b[c][0])), _mm_mul_ps(a1, _mm_set1_ps(b[c][1]))),
+                                   _mm_add_ps(_mm_mul_ps(a2, _mm_set1_ps(b[c][2])), _mm_mul_ps(a3, _mm_set1_ps(b[c][3]))));
+        _mm_storeu_ps(&result[c][0], column);
+    }
+#else
+    result = a * b;
+#endif
+}
+
+// Chama work(primeiro id, quantidade) para cada sequência de ids consecutivos de entities[0, count)
+template <typename F>
+static void forEachRun(const Entity* entities, size_t count, F&& work)
+{
+    for (size_t runStart = 0; runStart < count;) {
+        size_t runEnd = runStart + 1;
+        while (runEnd < count && entities[runEnd] == entities[runEnd - 1] + 1)
+            ++runEnd;
+        work(entities[runStart], runEnd - runStart);
+        runStart = runEnd;
+    }
+}
+
+// Entidades por job: abaixo disso a divisão custa mais do que economiza
+static const size_t ENTITIES_PER_JOB = 4096;
+
+// body(begin, end) em [0, count), dividido entre as threads se houver um JobSystem
+template <typename F>
+static void forRange(JobSystem* jobs, size_t count, F&& body)
+{
+    if (jobs)
+        jobs->parallelFor(count, ENTITIES_PER_JOB, body);
+    else if (count > 0)
+        body((size_t)0, count);
+}
+
+size_t updateTransforms(EntityWorld& world, JobSystem* jobs)
+{
+    if (world.hierarchyChanged || world.transformOrder.size() != world.size())
+        rebuildHierarchy(world);
+
+    const Entity* order = world.transformOrder.data();
+    const uint32_t* parentSlots = world.parentSlots.data();
+    const vec3* scales = world.scales.data();
+    uint8_t* dirty = world.dirty.data();
+    mat4* localMatrices = world.localMatrices.data();
+    mat4* models = world.models.data();
+    mat4* rigidWorlds = world.rigidWorlds.data();
+
+    // Entidades (e suas posições na ordem em largura) recalculadas neste quadro. Ficam no
+    // mundo para reaproveitar a memória sem estado global entre mundos diferentes
+    vector<Entity>& changed = world.changedEntities;
+    vector<uint32_t>& changedSlots = world.changedSlots;
+    changed.clear();
+    changedSlots.clear();
+
+    // 1) Propaga as marcações: o pai vem antes na ordem em largura, então a marcação já desceu até ele
+    for (size_t slot = 0, count = world.transformOrder.size(); slot < count; ++slot) {
+        Entity entity = order[slot];
+        uint32_t parentSlot = parentSlots[slot];
+        if (parentSlot != INVALID_ENTITY && dirty[order[parentSlot]])
+            dirty[entity] = 1;
+        if (dirty[entity]) {
+            changed.push_back(entity);
+            changedSlots.push_back((uint32_t)slot);
+        }
+    }
+
+    // 2) Matrizes locais (T * R) em lote, dos quatérnios. Só as entidades que mudaram de
+    // verdade precisariam, mas os filhos de uma entidade alterada entram junto para
+    // manter as sequências de ids longas
+    const quat* rotations = world.rotations.data();
+    const vec3* positions = world.positions.data();
+    forRange(jobs, changed.size(), [&](size_t begin, size_t end) {
+        forEachRun(changed.data() + begin, end - begin, [&](Entity first, size_t count) {
+            composeRigidMatrices(rotations + first, positions + first, localMatrices + first, count);
+        });
+    });
+
+    // 3) Matrizes de mundo em ordem de largura. A matriz sem escala é herdada pelos filhos;
+    // a escala só entra na matriz do próprio objeto. Dentro de um nível as entidades são
+    // independentes, então cada nível é dividido entre as threads
+    auto composeWorlds = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Entity entity = changed[i];
+            uint32_t slot = changedSlots[i];
+            uint32_t parentSlot = parentSlots[slot];
+            if (parentSlot != INVALID_ENTITY)
+                multiplyMatrices(rigidWorlds[parentSlot], localMatrices[entity], rigidWorlds[slot]);
+            else
+                rigidWorlds[slot] = localMatrices[entity];
+
+            const mat4& rigid = rigidWorlds[slot];
+            const vec3& scale = scales[entity];
+            mat4& model = models[entity];
+            model[0] = rigid[0] * scale.x;
+            model[1] = rigid[1] * scale.y;
+            model[2] = rigid[2] * scale.z;
+            model[3] = rigid[3];
+            dirty[entity] = 0;
+        }
+    };
+    if (!jobs) {
+        composeWorlds(0, changed.size());
+    } else {
+        // changedSlots é crescente: cada nível é um trecho contíguo da lista
+        size_t levelBegin = 0;
+        for (size_t level = 1; level < world.levelStarts.size() && levelBegin < changed.size(); ++level) {
+            size_t levelEnd = lower_bound(changedSlots.begin() + levelBegin, changedSlots.end(),
+                                          world.levelStarts[level]) - changedSlots.begin();
+            jobs->parallelFor(levelEnd - levelBegin, ENTITIES_PER_JOB, [&](size_t begin, size_t end) {
+                composeWorlds(levelBegin + begin, levelBegin + end);
+            });
+            levelBegin = levelEnd;
+        }
+    }
+
+    // 4) Matrizes de normais em lote, uma chamada por sequência de ids consecutivos
+    // (com a ordem de criação dentro de cada nível, as sequências costumam ser longas)
+    mat3* normalMatrices = world.normalMatrices.data();
+    forRange(jobs, changed.size(), [&](size_t begin, size_t end) {
+        forEachRun(changed.data() + begin, end - begin, [&](Entity first, size_t count) {
+            computeNormalMatrices(models + first, normalMatrices + first, count);
+        });
+    });
+    return changed.size();
+}
+
+size_t cullEntities(EntityWorld& world, const mat4& viewProjection, JobSystem* jobs)
+{
+    // Planos do frustum (Gribb e Hartmann): linha 3 +/- linhas 0, 1 e 2, normalizados
+    vec4 planes[6];
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int side = 0; side < 2; ++side) {
+            vec4 plane;
+            for (int c = 0; c < 4; ++c)
+                plane[c] = viewProjection[c][3] + (side == 0 ? 1.0f : -1.0f) * viewProjection[c][axis];
+            planes[axis * 2 + side] = plane / length(vec3(plane));
+        }
+    }
+
+    const mat4* models = world.models.data();
+    const vec3* scales = world.scales.data();
+    const float* radii = world.boundingRadii.data();
+    uint8_t* visible = world.visible.data();
+    atomic<size_t> visibleCount(0);
+    forRange(jobs, world.size(), [&](size_t begin, size_t end) {
+        size_t count = 0;
+        for (size_t i = begin; i < end; ++i) {
+            bool inside = true;
+            if (radii[i] > 0.0f) {
+                // A matriz herdada do pai não tem escala: o raio só muda com a escala da própria entidade
+                vec3 scale = abs(scales[i]);
+                float radius = radii[i] * std::max(scale.x, std::max(scale.y, scale.z));
+                vec4 center = vec4(vec3(models[i][3]), 1.0f);
+                for (int p = 0; p < 6 && inside; ++p)
+                    inside = dot(planes[p], center) >= -radius;
+            }
+            visible[i] = inside;
+            count += inside;
+        }
+        visibleCount += count;
+    });
+    return visibleCount;
+}
@@ -0,0 +1,142 @@
+/* Mundo de entidades orientado a dados (ECS simplificado)
+ *
+ * Cada entidade é apenas um índice. Os componentes ficam em vetores contíguos
+ * separados (estrutura de vetores, SoA), todos indexados pelo id da entidade,
+ * e os sistemas percorrem esses vetores linearmente. Assim a atualização de
+ * muitas entidades lê só os dados que usa, em sequência na memória.
+ *
+ * Substitui as variáveis globais por objeto (moonPosition, marsVAO,
+ * flamingoOrbitAngle, ...): a cena é criada a partir do arquivo de configuração.
+ *
+ * Hierarquia: cada entidade pode ter um pai (ex.: o flamingo é filho de Marte).
+ * Posição, rotação e escala são locais ao pai; a matriz do filho herda a posição e
+ * a rotação do pai, mas não a escala. Só as entidades marcadas com markDirty() (e os
+ * seus descendentes) têm as matrizes recalculadas, percorrendo a hierarquia em
+ * largura (pais sempre antes dos filhos) em vetores contíguos.
+ */
+
+#ifndef ENTITY_WORLD_H
+#define ENTITY_WORLD_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+class JobSystem;
+
+typedef uint32_t Entity;
+const Entity INVALID_ENTITY = 0xFFFFFFFFu;
+
+// Material de Phong
+struct Material {
+    glm::vec3 ka = glm::vec3(0.2f); // Coeficiente ambiente
+    glm::vec3 kd = glm::vec3(0.8f); // Coeficiente difuso
+    glm::vec3 ks = glm::vec3(1.0f); // Coeficiente especular
+    float shininess = 32.0f;        // Brilho da especular
+};
+
+// Tipo de animação de uma entidade
+enum AnimationKind : uint8_t {
+    ANIMATION_NONE,
+    ANIMATION_ORBIT,
+};
+
+class EntityWorld {
+public:
+    // Cria uma entidade com componentes padrão (posição na origem, escala 1, sem malha)
+    Entity create(const std::string& name);
+    void reserve(size_t count);
+    void clear();
+
+    // Tira a entidade da cena sem mudar os ids das outras: ela deixa de ser desenhada e
+    // animada e perde o nome, mas o id não é reaproveitado. Os filhos devem ser removidos
+    // ou trocar de pai antes
+    void destroy(Entity entity);
+    size_t size() const { return names.size(); }
+
+    // Procura uma entidade pelo nome (INVALID_ENTITY se não existir)
+    Entity find(const std::string& name) const;
+
+    // Define o pai de uma entidade (INVALID_ENTITY = raiz). Não pode criar ciclos
+    void setParent(Entity child, Entity parent);
+
+    // Deve ser chamada sempre que posição, rotação ou escala de uma entidade mudar
+    void markDirty(Entity entity) { dirty[entity] = 1; }
+
+    // --- Nome ---
+    std::vector<std::string> names;
+
+    // --- Transformação local (rotação em quatérnio normalizado) ---
+    std::vector<Entity> parents;          // INVALID_ENTITY = raiz
+    std::vector<uint8_t> dirty;           // 1 = matriz desatualizada
+    std::vector<glm::vec3> positions;
+    std::vector<glm::quat> rotations;
+    std::vector<glm::vec3> scales;
+    std::vector<glm::mat4> localMatrices; // T * R local, recalculada só quando a entidade muda
+    std::vector<glm::mat4> models;        // matriz de mundo, saída de updateTransforms()
+    std::vector<glm::mat3> normalMatrices; // saída de updateTransforms()
+
+    // --- Hierarquia em largura (mantida por updateTransforms()) ---
+    // transformOrder[slot] é a entidade na posição slot; parentSlots[slot] é a posição do pai
+    // e rigidWorlds[slot] a matriz de mundo sem a escala, herdada pelos filhos
+    std::vector<Entity> transformOrder;
+    std::vector<uint32_t> parentSlots;
+    std::vector<glm::mat4> rigidWorlds;
+    std::vector<uint32_t> levelStarts;    // primeira posição de cada nível (+ o total no fim)
+    bool hierarchyChanged = true;
+    // Rascunho de updateTransforms(): entidades recalculadas no quadro e suas posições
+    std::vector<Entity> changedEntities;
+    std::vector<uint32_t> changedSlots;
+
+    // --- Visibilidade ---
+    std::vector<float> boundingRadii;     // raio da malha no espaço do objeto (0 = sempre visível)
+    std::vector<uint8_t> visible;         // saída de cullEntities()
+
+    // --- Desenho ---
+    std::vector<GLuint> vaos;            // 0 = entidade sem malha
+    std::vector<GLsizei> vertexCounts;
+    std::vector<GLuint> textures;
+    std::vector<GLuint> alphaTextures;   // textura com teste alfa desenhada por cima (0 = nenhuma)
+    std::vector<Material> materials;
+
+    // --- Animação ---
+    std::vector<AnimationKind> animations;
+    std::vector<glm::vec3> orbitCenters; // centro da órbita no espaço do pai (origem do pai, em geral)
+    std::vector<float> orbitRadii;
+    std::vector<float> orbitSpeeds;      // radianos por segundo
+    std::vector<float> orbitAngles;
+    std::vector<float> previousOrbitAngles; // ângulo no tick anterior, para a interpolação
+
+private:
+    std::unordered_map<std::string, Entity> byName;
+};
+
+// Sistema de animação em passo fixo: avança um tick das órbitas de [first, first + count),
+// guardando o ângulo anterior. A entidade skip (ex.: a selecionada pelo usuário) não é animada
+void stepOrbits(EntityWorld& world, float step, Entity skip = INVALID_ENTITY,
+                size_t first = 0, size_t count = SIZE_MAX);
+
+// Posiciona as entidades em órbita no espaço local (em volta do pai), com o ângulo
+// interpolado entre o tick anterior e o atual (alpha em [0, 1]), e as marca como alteradas
+void applyOrbits(EntityWorld& world, float alpha, Entity skip = INVALID_ENTITY,
+                 size_t first = 0, size_t count = SIZE_MAX);
+
+// stepOrbits() + applyOrbits() sem interpolação, com um passo de deltaTime
+void updateOrbits(EntityWorld& world, float deltaTime, Entity skip = INVALID_ENTITY,
+                  size_t first = 0, size_t count = SIZE_MAX);
+
+// Sistema de transformação: recalcula as matrizes de mundo e de normais das entidades
+// alteradas e dos seus descendentes. Retorna quantas entidades foram recalculadas.
+// Com jobs, cada etapa é dividida entre as threads (as matrizes de mundo nível a nível)
+size_t updateTransforms(EntityWorld& world, JobSystem* jobs = nullptr);
+
+// Sistema de visibilidade: testa a esfera envolvente de cada entidade contra os 6 planos
+// do frustum de viewProjection e preenche visible. Retorna quantas entidades são visíveis
+size_t cullEntities(EntityWorld& world, const glm::mat4& viewProjection, JobSystem* jobs = nullptr);
+
+#endif
@@ -0,0 +1,201 @@
+/* Observador de arquivos para recarga a quente - implementação
+ * Ver FileWatcher.h
+ */
+
+#include "FileWatcher.h"
+
+#include <iostream>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Caminho absoluto sem "." e "..": o mesmo arquivo citado de pastas diferentes
+// (../assets/x.obj, assets/x.obj) tem uma entrada só
+static string normalizedPath(const string& path)
+{
+    error_code error;
+    filesystem::path absolute = filesystem::absolute(path, error);
+    return (error ? filesystem::path(path) : absolute).lexically_normal().string();
+}
+
+bool FileWatcher::start()
+{
+    if (thread.joinable())
+        return false;
+    quit = false;
+#ifdef __linux__
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0) {
+        cout << "inotify indisponivel: mudancas detectadas pela data dos arquivos" << endl;
+    }
+    else {
+        lock_guard<mutex> lock(filesMutex);
+        for (const auto& file : files)
+            addDirectoryWatch(file.second.directory);
+    }
+#endif
+    thread = std::thread(&FileWatcher::run, this);
+    return true;
+}
+
+void FileWatcher::stop()
+{
+    if (!thread.joinable())
+        return;
+    quit = true;
+    thread.join();
+#ifdef __linux__
+    if (inotifyFd >= 0)
+        close(inotifyFd);
+#endif
+    inotifyFd = -1;
+    lock_guard<mutex> lock(filesMutex);
+    directories.clear();
+    ready.clear();
+}
+
+void FileWatcher::watch(const string& path, Importer importer)
+{
+    string key = normalizedPath(path);
+    lock_guard<mutex> lock(filesMutex);
+    WatchedFile& file = files[key];
+    if (file.importers.empty()) {
+        file.directory = filesystem::path(key).parent_path().string();
+        error_code error;
+        file.modified = filesystem::last_write_time(key, error);
+        addDirectoryWatch(file.directory);
+    }
+    file.importers.push_back(move(importer));
+}
+
+bool FileWatcher::watching(const string& path) const
+{
+    string key = normalizedPath(path);
+    lock_guard<mutex> lock(filesMutex);
+    return files.count(key) != 0;
+}
+
+// Com filesMutex travado. Uma observação por pasta, para todos os arquivos dela
+void FileWatcher::addDirectoryWatch(const string& directory)
+{
+#ifdef __linux__
+    if (inotifyFd < 0)
+        return;
+    for (const auto& watched : directories)
+        if (watched.second == directory)
+            return;
+    int descriptor = inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (descriptor < 0)
+        cout << "Erro ao observar a pasta " << directory << endl;
+    else
+        directories[descriptor] = directory;
+#else
+    (void)directory;
+#endif
+}
+
+void FileWatcher::run()
+{
+    Clock::time_point nextPoll = Clock::now();
+    while (!quit) {
+#ifdef __linux__
+        if (inotifyFd >= 0) {
+            // Acorda pelo menos a cada DEBOUNCE_MS para importar os arquivos já estáveis
+            pollfd descriptor = { inotifyFd, POLLIN, 0 };
+            if (poll(&descriptor, 1, DEBOUNCE_MS) > 0)
+                readEvents();
+            importReady();
+            continue;
+        }
+#endif
+        this_thread::sleep_for(chrono::milliseconds(DEBOUNCE_MS));
+        if (Clock::now() >= nextPoll) {
+            pollTimes();
+            nextPoll = Clock::now() + chrono::milliseconds(POLL_INTERVAL_MS);
+        }
+        importReady();
+    }
+}
+
+void FileWatcher::readEvents()
+{
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+    for (;;) {
+        ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0)
+            return;
+        Clock::time_point deadline = Clock::now() + chrono::milliseconds(DEBOUNCE_MS);
+        lock_guard<mutex> lock(filesMutex);
+        for (char* next = buffer; next < buffer + length;) {
+            const inotify_event* event = (const inotify_event*)next;
+            next += sizeof(inotify_event) + event->len;
+            auto directory = directories.find(event->wd);
+            if (directory == directories.end() || event->len == 0)
+                continue;
+            auto file = files.find((filesystem::path(directory->second) / event->name).string());
+            if (file == files.end())
+                continue;
+            file->second.pending = true;
+            file->second.deadline = deadline;
+        }
+    }
+#endif
+}
+
+void FileWatcher::pollTimes()
+{
+    Clock::time_point deadline = Clock::now() + chrono::milliseconds(DEBOUNCE_MS);
+    lock_guard<mutex> lock(filesMutex);
+    for (auto& file : files) {
+        error_code error;
+        filesystem::file_time_type modified = filesystem::last_write_time(file.first, error);
+        if (error || modified == file.second.modified)
+            continue;
+        file.second.modified = modified;
+        file.second.pending = true;
+        file.second.deadline = deadline;
+    }
+}
+
+// Executa os importadores dos arquivos sem eventos há DEBOUNCE_MS, fora da trava
+// (a importação pode demorar e watch() pode ser chamada enquanto isso)
+void FileWatcher::importReady()
+{
+    vector<Importer> importers;
+    {
+        Clock::time_point now = Clock::now();
+        lock_guard<mutex> lock(filesMutex);
+        for (auto& file : files) {
+            if (!file.second.pending || file.second.deadline > now)
+                continue;
+            file.second.pending = false;
+            importers.insert(importers.end(), file.second.importers.begin(), file.second.importers.end());
+        }
+    }
+    for (const Importer& importer : importers) {
+        Apply apply = importer();
+        if (!apply)
+            continue;
+        lock_guard<mutex> lock(filesMutex);
+        ready.push_back(move(apply));
+    }
+}
+
+size_t FileWatcher::applyReloads()
+{
+    vector<Apply> applies;
+    {
+        lock_guard<mutex> lock(filesMutex);
+        applies.swap(ready);
+    }
+    for (const Apply& apply : applies)
+        apply();
+    applied += applies.size();
+    return applies.size();
+}
@@ -0,0 +1,92 @@
+/* Observador de arquivos para recarga a quente (cena, shaders, malhas e texturas)
+ *
+ * watch(caminho, importador) registra um arquivo. Uma thread própria espera por
+ * mudanças: no Linux com inotify nas pastas dos arquivos (IN_CLOSE_WRITE, IN_MOVED_TO
+ * e IN_CREATE, para pegar também os editores que gravam um arquivo novo e o renomeiam
+ * por cima do antigo); nos outros sistemas comparando a data de modificação a cada
+ * POLL_INTERVAL_MS.
+ *
+ * Os eventos de um arquivo são agrupados por DEBOUNCE_MS (um salvamento costuma gerar
+ * vários) e então o importador é executado nessa thread: ele lê e decodifica o arquivo
+ * (sem OpenGL) e devolve o passo de aplicação. Os passos ficam em fila até a thread do
+ * OpenGL chamar applyReloads() no início do quadro, onde são executados em ordem: a
+ * troca acontece sempre entre dois quadros, e só o recurso que mudou é reimportado.
+ *
+ * O importador pode devolver um passo vazio (arquivo inválido ou incompleto): o recurso
+ * antigo continua em uso e nada é enfileirado.
+ */
+
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class FileWatcher {
+public:
+    typedef std::function<void()> Apply;
+    typedef std::function<Apply()> Importer;
+
+    static constexpr int DEBOUNCE_MS = 100;
+    static constexpr int POLL_INTERVAL_MS = 500; // sem inotify
+
+    FileWatcher() = default;
+    ~FileWatcher() { stop(); }
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Inicia a thread do observador; false se ela já está rodando
+    bool start();
+    // Para a thread e descarta os passos ainda não aplicados
+    void stop();
+    bool running() const { return thread.joinable(); }
+    // true se as mudanças vêm do inotify (false: comparação das datas)
+    bool usingInotify() const { return inotifyFd >= 0; }
+
+    // Registra um importador para path (um arquivo pode ter vários). Pode ser chamada
+    // antes ou depois de start(), de qualquer thread
+    void watch(const std::string& path, Importer importer);
+    bool watching(const std::string& path) const;
+
+    // Executa os passos de aplicação prontos, na ordem em que ficaram prontos.
+    // Retorna quantos foram executados. Só na thread que os passos esperam (a do OpenGL)
+    size_t applyReloads();
+
+    // Quantas recargas já foram aplicadas
+    size_t reloadCount() const { return applied; }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct WatchedFile {
+        std::vector<Importer> importers;
+        std::string directory;
+        bool pending = false;
+        Clock::time_point deadline;                  // fim do agrupamento dos eventos
+        std::filesystem::file_time_type modified;    // sem inotify
+    };
+
+    void run();
+    void addDirectoryWatch(const std::string& directory);
+    void readEvents();
+    void pollTimes();
+    void importReady();
+
+    mutable std::mutex filesMutex; // files, directories e ready
+    std::map<std::string, WatchedFile> files;      // caminho absoluto normalizado
+    std::map<int, std::string> directories;        // descritor do inotify -> pasta
+    std::vector<Apply> ready;
+    std::thread thread;
+    std::atomic<bool> quit{false};
+    int inotifyFd = -1;
+    size_t applied = 0;
+};
+
+#endif
@@ -0,0 +1,143 @@
+/* Alocadores para dados temporários - implementação
+ * Ver FrameAllocator.h
+ */
+
+#include "FrameAllocator.h"
+
+#include <cstdint>
+
+using namespace std;
+
+static size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+LinearArena::LinearArena(size_t capacity) : size(capacity)
+{
+    if (size > 0)
+        buffer = static_cast<char*>(::operator new(size));
+}
+
+LinearArena::~LinearArena()
+{
+    reset();
+    ::operator delete(buffer);
+}
+
+void* LinearArena::allocate(size_t bytes, size_t alignment)
+{
+    if (bytes == 0)
+        bytes = 1;
+    uintptr_t base = reinterpret_cast<uintptr_t>(buffer);
+    size_t current = offset.load(memory_order_relaxed);
+    for (;;) {
+        size_t start = alignUp(base + current, alignment) - base;
+        size_t end = start + bytes;
+        if (end > size)
+            return allocateOverflow(bytes, alignment);
+        if (offset.compare_exchange_weak(current, end, memory_order_relaxed))
+            return buffer + start;
+    }
+}
+
+void* LinearArena::allocateOverflow(size_t bytes, size_t alignment)
+{
+    lock_guard<mutex> lock(overflowMutex);
+    char* block = static_cast<char*>(::operator new(bytes + alignment));
+    overflowBlocks.push_back(block);
+    overflowSize += bytes + alignment;
+    return reinterpret_cast<char*>(alignUp(reinterpret_cast<uintptr_t>(block), alignment));
+}
+
+void LinearArena::reset()
+{
+    for (void* block : overflowBlocks)
+        ::operator delete(block);
+    overflowBlocks.clear();
+
+    // A arena não coube no quadro: cresce de uma vez para os próximos não transbordarem
+    if (overflowSize > 0) {
+        ::operator delete(buffer);
+        size = alignUp(size + overflowSize + size / 2, 4096);
+        buffer = static_cast<char*>(::operator new(size));
+        overflowSize = 0;
+    }
+    offset.store(0, memory_order_relaxed);
+}
+
+FrameAllocator::FrameAllocator(size_t bytesPerFrame)
+    : arenas{ LinearArena(bytesPerFrame), LinearArena(bytesPerFrame) }
+{
+}
+
+void FrameAllocator::beginFrame()
+{
+    ++frame;
+    current().reset();
+}
+
+FixedPool::FixedPool(size_t blockSize, size_t blocksPerChunk)
+    : block(alignUp(std::max(blockSize, sizeof(FreeBlock)), alignof(max_align_t))),
+      perChunk(std::max<size_t>(blocksPerChunk, 1))
+{
+}
+
+FixedPool::~FixedPool()
+{
+    for (char* chunk : chunks)
+        ::operator delete(chunk);
+}
+
+void* FixedPool::allocate()
+{
+    if (!freeList) {
+        char* chunk = static_cast<char*>(::operator new(block * perChunk));
+        chunks.push_back(chunk);
+        for (size_t i = perChunk; i-- > 0;) {
+            FreeBlock* free = reinterpret_cast<FreeBlock*>(chunk + i * block);
+            free->next = freeList;
+            freeList = free;
+        }
+    }
+    FreeBlock* result = freeList;
+    freeList = result->next;
+    ++live;
+    return result;
+}
+
+void FixedPool::release(void* released)
+{
+    FreeBlock* free = static_cast<FreeBlock*>(released);
+    free->next = freeList;
+    freeList = free;
+    --live;
+}
+
+PoolSet::PoolSet(size_t blocksPerChunk)
+{
+    for (size_t i = 0; i < MAX_BLOCK / GRANULARITY; ++i)
+        pools[i] = new FixedPool((i + 1) * GRANULARITY, blocksPerChunk);
+}
+
+PoolSet::~PoolSet()
+{
+    for (FixedPool* pool : pools)
+        delete pool;
+}
+
+void* PoolSet::allocate(size_t bytes)
+{
+    if (bytes > MAX_BLOCK)
+        return ::operator new(bytes);
+    return pools[bytes == 0 ? 0 : (bytes - 1) / GRANULARITY]->allocate();
+}
+
+void PoolSet::release(void* block, size_t bytes)
+{
+    if (bytes > MAX_BLOCK) {
+        ::operator delete(block);
+        return;
+    }
+    pools[bytes == 0 ? 0 : (bytes - 1) / GRANULARITY]->release(block);
+}
@@ -0,0 +1,197 @@
+/* Alocadores para dados temporários: arena linear por quadro e pools de blocos fixos
+ *
+ * Dados que só vivem durante um quadro (ou durante o carregamento de uma malha) não
+ * precisam passar pelo malloc a cada vez:
+ *
+ *  - LinearArena reserva um bloco uma vez e cada alocação só avança um ponteiro
+ *    (atômico, então as threads do JobSystem podem alocar juntas). Não há free:
+ *    reset() libera tudo de uma vez;
+ *  - FrameAllocator alterna duas arenas: o que foi alocado no quadro N continua
+ *    válido durante o quadro N + 1 (para quem consome o quadro anterior) e a arena
+ *    é reaproveitada no N + 2;
+ *  - FixedPool / ObjectPool guardam blocos de um tamanho só em uma lista livre, e
+ *    PoolSet agrupa pools por classe de tamanho para os nós de std::map e std::list.
+ *
+ * ArenaAllocator e PoolAllocator adaptam esses alocadores para os contêineres da STL.
+ * Ver AllocationCounter.h para verificar que um trecho não aloca no heap.
+ */
+
+#ifndef FRAME_ALLOCATOR_H
+#define FRAME_ALLOCATOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+class LinearArena {
+public:
+    explicit LinearArena(size_t capacity = 0);
+    ~LinearArena();
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    // Pode ser chamada por várias threads ao mesmo tempo. Se a arena encher, a alocação
+    // vai para um bloco extra do heap e o próximo reset() aumenta a arena para caber tudo
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T* allocateArray(size_t count) { return static_cast<T*>(allocate(count * sizeof(T), alignof(T))); }
+
+    // Descarta todas as alocações (nenhuma thread pode estar alocando)
+    void reset();
+
+    size_t used() const { return std::min(offset.load(std::memory_order_relaxed), size); }
+    size_t capacity() const { return size; }
+    size_t overflowBytes() const { return overflowSize; }
+
+private:
+    void* allocateOverflow(size_t size, size_t alignment);
+
+    char* buffer = nullptr;
+    size_t size = 0;
+    std::atomic<size_t> offset{0};
+
+    std::mutex overflowMutex;
+    std::vector<void*> overflowBlocks;
+    size_t overflowSize = 0;
+};
+
+// Duas arenas alternadas a cada quadro
+class FrameAllocator {
+public:
+    explicit FrameAllocator(size_t bytesPerFrame = 1 << 20);
+
+    // Início do quadro: a arena do quadro anterior passa a ser previous() e a de dois
+    // quadros atrás é esvaziada e reaproveitada como current()
+    void beginFrame();
+
+    LinearArena& current() { return arenas[frame & 1]; }
+    LinearArena& previous() { return arenas[(frame + 1) & 1]; }
+    unsigned long long frameIndex() const { return frame; }
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) { return current().allocate(size, alignment); }
+    template <typename T>
+    T* allocateArray(size_t count) { return current().allocateArray<T>(count); }
+
+private:
+    LinearArena arenas[2];
+    unsigned long long frame = 0;
+};
+
+// Blocos de tamanho fixo, alocados em grupos (chunks) e reaproveitados por uma lista livre.
+// Não é thread-safe: cada thread ou sistema usa o seu
+class FixedPool {
+public:
+    explicit FixedPool(size_t blockSize, size_t blocksPerChunk = 256);
+    ~FixedPool();
+    FixedPool(const FixedPool&) = delete;
+    FixedPool& operator=(const FixedPool&) = delete;
+
+    void* allocate();
+    void release(void* block);
+
+    size_t blockSize() const { return block; }
+    size_t liveBlocks() const { return live; }
+
+private:
+    struct FreeBlock { FreeBlock* next; };
+
+    size_t block, perChunk;
+    std::vector<char*> chunks;
+    FreeBlock* freeList = nullptr;
+    size_t live = 0;
+};
+
+// Pool de objetos de um tipo
+template <typename T>
+class ObjectPool {
+public:
+    explicit ObjectPool(size_t objectsPerChunk = 256) : pool(sizeof(T), objectsPerChunk) {}
+
+    template <typename... Args>
+    T* create(Args&&... args) { return new (pool.allocate()) T(std::forward<Args>(args)...); }
+    void destroy(T* object)
+    {
+        object->~T();
+        pool.release(object);
+    }
+    size_t liveObjects() const { return pool.liveBlocks(); }
+
+private:
+    FixedPool pool;
+};
+
+// Pools por classe de tamanho (múltiplos de 16 bytes até MAX_BLOCK). Pedidos maiores
+// vão para o heap
+class PoolSet {
+public:
+    static const size_t GRANULARITY = 16;
+    static const size_t MAX_BLOCK = 256;
+
+    explicit PoolSet(size_t blocksPerChunk = 256);
+    ~PoolSet();
+    PoolSet(const PoolSet&) = delete;
+    PoolSet& operator=(const PoolSet&) = delete;
+
+    void* allocate(size_t size);
+    void release(void* block, size_t size);
+
+private:
+    FixedPool* pools[MAX_BLOCK / GRANULARITY];
+};
+
+// Adaptador STL sobre uma LinearArena: deallocate não faz nada (a memória volta no reset).
+// Um vector que cresce deixa os buffers antigos na arena até o reset: reserve() evita isso
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    explicit ArenaAllocator(LinearArena& arena) : arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t count) { return arena->allocateArray<T>(count); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+    LinearArena* arena;
+};
+
+// Adaptador STL sobre um PoolSet, para contêineres de nós (map, set, list)
+template <typename T>
+class PoolAllocator {
+public:
+    typedef T value_type;
+
+    explicit PoolAllocator(PoolSet& pools) : pools(&pools) {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) : pools(other.pools) {}
+
+    T* allocate(size_t count) { return static_cast<T*>(pools->allocate(count * sizeof(T))); }
+    void deallocate(T* block, size_t count) { pools->release(block, count * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const { return pools == other.pools; }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>& other) const { return pools != other.pools; }
+
+    PoolSet* pools;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+template <typename K, typename V, typename Compare = std::less<K>>
+using PoolMap = std::map<K, V, Compare, PoolAllocator<std::pair<const K, V>>>;
+
+#endif
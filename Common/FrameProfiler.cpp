@@ -0,0 +1,383 @@
+/* Profiler de quadros - implementação
+ * Ver FrameProfiler.h
+ */
+
+#include "FrameProfiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+
+#include <glad/glad.h>
+
+#include "SpscRing.h"
+
+using namespace std;
+
+// Escopos por thread entre dois endFrame(); acima disso são descartados
+static const size_t THREAD_RING_CAPACITY = 1 << 14;
+
+namespace {
+
+struct ScopeEvent {
+    const char* name;
+    uint64_t begin, end;
+    uint32_t depth;
+};
+
+struct ThreadEvents {
+    SpscRing<ScopeEvent> ring{ THREAD_RING_CAPACITY };
+    uint32_t track = 0; // linha no trace (ordem em que a thread gravou o primeiro escopo)
+    atomic<uint64_t> dropped{0};
+};
+
+struct GpuQuery {
+    const char* name;
+    uint32_t depth;
+    GLuint begin, end;
+};
+
+// Consultas de um quadro; reaproveitadas dois quadros depois
+struct GpuFrame {
+    vector<GpuQuery> queries;
+    size_t used = 0;
+    uint64_t frame = 0;
+    int64_t offset = 0; // relógio da CPU - relógio da GPU, em ns, no início do quadro
+    uint64_t start = 0; // início do quadro na CPU
+};
+
+struct TraceEvent {
+    const char* name;
+    uint32_t track;
+    uint64_t begin, duration;
+};
+
+struct CounterSample {
+    uint64_t time;
+    uint64_t values[PROFILE_COUNTER_COUNT];
+};
+
+const uint32_t GPU_TRACK = 999; // depois das threads
+
+const char* COUNTER_NAMES[PROFILE_COUNTER_COUNT] = { "draw calls", "trocas de estado", "triangulos", "bytes enviados" };
+
+}
+
+static mutex threadsMutex;
+static vector<unique_ptr<ThreadEvents>> threads;
+static thread_local ThreadEvents* localEvents = nullptr;
+static thread_local uint32_t localDepth = 0;
+
+static ThreadEvents* mainEvents = nullptr;
+static uint64_t frameIndex = 0;
+static uint64_t frameStart = 0;
+static atomic<uint64_t> counters[PROFILE_COUNTER_COUNT];
+static ProfileFrame last;
+static vector<ScopeEvent> drained;
+
+static GpuFrame gpuFrames[2];
+static GpuFrame* gpuCurrent = nullptr;
+static uint32_t gpuDepth = 0;
+
+// Captura em andamento: quadros [captureFirst, captureLast], escrita em captureLast + 1
+static bool captureActive = false;
+static uint64_t captureFirst = 0, captureLast = 0;
+static string capturePath;
+static vector<TraceEvent> captureEvents;
+static vector<CounterSample> captureCounters;
+
+static ThreadEvents& threadEvents()
+{
+    if (!localEvents) {
+        lock_guard<mutex> lock(threadsMutex);
+        threads.push_back(unique_ptr<ThreadEvents>(new ThreadEvents()));
+        localEvents = threads.back().get();
+        localEvents->track = (uint32_t)threads.size() - 1;
+    }
+    return *localEvents;
+}
+
+const char* profileCounterName(ProfileCounter counter)
+{
+    return COUNTER_NAMES[counter];
+}
+
+uint64_t FrameProfiler::now()
+{
+    static const chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+    return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - epoch).count();
+}
+
+ProfileScope::ProfileScope(const char* scopeName)
+    : name(scopeName), begin(FrameProfiler::now())
+{
+    ++localDepth;
+}
+
+ProfileScope::~ProfileScope()
+{
+    --localDepth;
+    FrameProfiler::recordScope(name, begin, FrameProfiler::now(), localDepth);
+}
+
+void FrameProfiler::recordScope(const char* name, uint64_t begin, uint64_t end, uint32_t depth)
+{
+    ThreadEvents& events = threadEvents();
+    if (!events.ring.push(ScopeEvent{ name, begin, end, depth }))
+        events.dropped.fetch_add(1, memory_order_relaxed);
+}
+
+void FrameProfiler::count(ProfileCounter counter, uint64_t value)
+{
+    counters[counter].fetch_add(value, memory_order_relaxed);
+}
+
+// --- GPU ---
+
+int FrameProfiler::beginGpuScope(const char* name)
+{
+    if (!gpuCurrent)
+        return -1;
+    GpuFrame& frame = *gpuCurrent;
+    if (frame.used == frame.queries.size()) {
+        GLuint ids[2];
+        glGenQueries(2, ids);
+        frame.queries.push_back(GpuQuery{ nullptr, 0, ids[0], ids[1] });
+    }
+    GpuQuery& query = frame.queries[frame.used];
+    query.name = name;
+    query.depth = gpuDepth++;
+    glQueryCounter(query.begin, GL_TIMESTAMP);
+    return (int)frame.used++;
+}
+
+void FrameProfiler::endGpuScope(int query)
+{
+    if (query < 0 || !gpuCurrent)
+        return;
+    --gpuDepth;
+    glQueryCounter(gpuCurrent->queries[query].end, GL_TIMESTAMP);
+}
+
+// Lê as consultas de um quadro anterior, se a GPU já terminou todas (elas terminam em
+// ordem, então basta a última)
+static void readGpuFrame(GpuFrame& frame)
+{
+    last.gpu.clear();
+    last.gpuMilliseconds = 0.0;
+    if (frame.used == 0)
+        return;
+    GLint available = 0;
+    glGetQueryObjectiv(frame.queries[frame.used - 1].end, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        frame.used = 0;
+        return;
+    }
+
+    bool captured = captureActive && frame.frame >= captureFirst && frame.frame <= captureLast;
+    uint64_t first = UINT64_MAX, lastEnd = 0;
+    for (size_t i = 0; i < frame.used; ++i) {
+        const GpuQuery& query = frame.queries[i];
+        GLuint64 begin = 0, end = 0;
+        glGetQueryObjectui64v(query.begin, GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(query.end, GL_QUERY_RESULT, &end);
+        uint64_t cpuBegin = (uint64_t)((int64_t)begin + frame.offset);
+        uint64_t duration = end > begin ? end - begin : 0;
+        first = std::min<uint64_t>(first, begin);
+        lastEnd = std::max<uint64_t>(lastEnd, end);
+        last.gpu.push_back(ProfileScopeTime{ query.name, query.depth,
+                                             ((double)cpuBegin - (double)frame.start) * 1e-6, duration * 1e-6 });
+        if (captured)
+            captureEvents.push_back(TraceEvent{ query.name, GPU_TRACK, cpuBegin, duration });
+    }
+    last.gpuMilliseconds = (lastEnd - first) * 1e-6;
+    frame.used = 0;
+}
+
+// --- Quadros ---
+
+void FrameProfiler::beginFrame()
+{
+    mainEvents = &threadEvents();
+    frameStart = now();
+
+    // Sem a GLAD carregada (benchmarks, ferramentas), só a CPU é medida
+    if (!GLAD_GL_VERSION_3_3)
+        return;
+    gpuCurrent = &gpuFrames[frameIndex % 2];
+    gpuCurrent->used = 0;
+    gpuCurrent->frame = frameIndex;
+    gpuCurrent->start = frameStart;
+    GLint64 gpuNow = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+    gpuCurrent->offset = (int64_t)now() - gpuNow;
+    gpuDepth = 0;
+}
+
+static void finishCapture();
+
+void FrameProfiler::endFrame()
+{
+    uint64_t frameEnd = now();
+    bool captured = captureActive && frameIndex >= captureFirst && frameIndex <= captureLast;
+
+    // O quadro inteiro, na linha da thread principal, em volta dos escopos dela
+    if (captured && mainEvents)
+        captureEvents.push_back(TraceEvent{ "quadro", mainEvents->track, frameStart, frameEnd - frameStart });
+
+    // Escopos de todas as threads desde o último endFrame()
+    last.cpu.clear();
+    drained.resize(THREAD_RING_CAPACITY);
+    {
+        lock_guard<mutex> lock(threadsMutex);
+        for (const unique_ptr<ThreadEvents>& events : threads) {
+            size_t count = events->ring.pop(drained.data(), drained.size());
+            for (size_t i = 0; i < count; ++i) {
+                const ScopeEvent& event = drained[i];
+                if (captured)
+                    captureEvents.push_back(TraceEvent{ event.name, events->track, event.begin, event.end - event.begin });
+                if (events.get() == mainEvents && event.begin >= frameStart)
+                    last.cpu.push_back(ProfileScopeTime{ event.name, event.depth, (event.begin - frameStart) * 1e-6,
+                                                         (event.end - event.begin) * 1e-6 });
+            }
+        }
+    }
+
+    // Tempos da GPU do quadro anterior (o deste quadro ainda está na fila da GPU)
+    if (frameIndex > 0 && GLAD_GL_VERSION_3_3)
+        readGpuFrame(gpuFrames[(frameIndex - 1) % 2]);
+    gpuCurrent = nullptr;
+
+    last.index = frameIndex;
+    last.cpuMilliseconds = (frameEnd - frameStart) * 1e-6;
+    CounterSample sample;
+    sample.time = frameStart;
+    for (int c = 0; c < PROFILE_COUNTER_COUNT; ++c)
+        last.counters[c] = sample.values[c] = counters[c].exchange(0, memory_order_relaxed);
+    if (captured)
+        captureCounters.push_back(sample);
+
+    if (captureActive && frameIndex == captureLast + 1)
+        finishCapture();
+    ++frameIndex;
+}
+
+const ProfileFrame& FrameProfiler::lastFrame()
+{
+    return last;
+}
+
+uint64_t FrameProfiler::droppedScopes()
+{
+    lock_guard<mutex> lock(threadsMutex);
+    uint64_t dropped = 0;
+    for (const unique_ptr<ThreadEvents>& events : threads)
+        dropped += events->dropped.load(memory_order_relaxed);
+    return dropped;
+}
+
+void FrameProfiler::release()
+{
+    // Captura interrompida pelo fim do programa: espera a GPU do último quadro e grava
+    if (captureActive) {
+        if (frameIndex > 0 && GLAD_GL_VERSION_3_3) {
+            glFinish();
+            readGpuFrame(gpuFrames[(frameIndex - 1) % 2]);
+        }
+        finishCapture();
+    }
+    for (GpuFrame& frame : gpuFrames) {
+        for (const GpuQuery& query : frame.queries) {
+            GLuint ids[2] = { query.begin, query.end };
+            glDeleteQueries(2, ids);
+        }
+        frame = GpuFrame();
+    }
+    gpuCurrent = nullptr;
+}
+
+// --- Chrome trace ---
+
+bool FrameProfiler::capture(int frames, const string& path)
+{
+    if (captureActive || frames < 1)
+        return false;
+    captureActive = true;
+    captureFirst = frameIndex;
+    captureLast = frameIndex + (uint64_t)frames - 1;
+    capturePath = path;
+    return true;
+}
+
+bool FrameProfiler::capturing()
+{
+    return captureActive;
+}
+
+// Os nomes são literais do programa, mas aspas e barras ainda quebrariam o JSON
+static void writeJsonString(FILE* file, const char* text)
+{
+    fputc('"', file);
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\')
+            fputc('\\', file);
+        if ((unsigned char)*c >= 0x20)
+            fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+static bool writeCapture()
+{
+    FILE* file = fopen(capturePath.c_str(), "w");
+    if (!file)
+        return false;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    // Nomes das linhas: a thread do primeiro escopo, as outras e a GPU
+    uint32_t mainTrack = mainEvents ? mainEvents->track : 0;
+    size_t threadCount;
+    {
+        lock_guard<mutex> lock(threadsMutex);
+        threadCount = threads.size();
+    }
+    for (uint32_t track = 0; track < threadCount; ++track) {
+        fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", track);
+        if (track == mainTrack)
+            fprintf(file, "\"principal\"}},\n");
+        else
+            fprintf(file, "\"thread %u\"}},\n", track);
+    }
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"GPU\"}}", GPU_TRACK);
+
+    // Tempos em microssegundos, como o formato pede
+    for (const TraceEvent& event : captureEvents) {
+        fprintf(file, ",\n{\"name\":");
+        writeJsonString(file, event.name);
+        fprintf(file, ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                event.track == GPU_TRACK ? "gpu" : "cpu", event.track, event.begin * 1e-3, event.duration * 1e-3);
+    }
+    for (const CounterSample& sample : captureCounters) {
+        for (int c = 0; c < PROFILE_COUNTER_COUNT; ++c)
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"valor\":%llu}}",
+                    COUNTER_NAMES[c], sample.time * 1e-3, (unsigned long long)sample.values[c]);
+    }
+    fprintf(file, "\n]}\n");
+    bool ok = !ferror(file);
+    return fclose(file) == 0 && ok;
+}
+
+static void finishCapture()
+{
+    if (writeCapture())
+        cout << "Perfil gravado em " << capturePath << " (" << captureEvents.size() << " eventos)" << endl;
+    else
+        cout << "Erro ao gravar o perfil em " << capturePath << endl;
+    captureActive = false;
+    captureEvents = vector<TraceEvent>();
+    captureCounters = vector<CounterSample>();
+}
@@ -0,0 +1,114 @@
+/* Profiler de quadros: escopos de CPU, tempos de GPU e contadores
+ *
+ * CPU: PROFILE_SCOPE("nome") mede o bloco em que está (RAII). Cada thread grava os
+ * seus escopos em um anel próprio (SpscRing, sem travas); a thread principal recolhe
+ * os anéis em endFrame(). Os nomes devem ser literais: só o ponteiro é guardado.
+ *
+ * GPU: PROFILE_GPU_SCOPE("nome") marca o início e o fim do trecho com
+ * glQueryCounter(GL_TIMESTAMP). As consultas de um quadro ficam em um de dois
+ * conjuntos: elas são lidas no fim do quadro seguinte e só se já estão prontas
+ * (GL_QUERY_RESULT_AVAILABLE); senão o quadro fica sem tempos de GPU, mas nunca se
+ * espera pela GPU. Só na thread do OpenGL.
+ *
+ * Contadores: FrameProfiler::count(PROFILE_DRAW_CALLS, n), ... somados por quadro.
+ *
+ * capture(quadros, arquivo) grava os próximos quadros em JSON do Chrome trace (abrir
+ * em chrome://tracing ou ui.perfetto.dev): uma linha por thread, uma para a GPU e os
+ * contadores. ProfilerOverlay.h desenha o último quadro sobre a cena.
+ */
+
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum ProfileCounter {
+    PROFILE_DRAW_CALLS,
+    PROFILE_STATE_CHANGES,
+    PROFILE_TRIANGLES,
+    PROFILE_UPLOAD_BYTES, // bytes enviados à GPU (buffers e texturas)
+    PROFILE_COUNTER_COUNT
+};
+
+// Nome do contador no trace e no terminal
+const char* profileCounterName(ProfileCounter counter);
+
+// Um escopo do último quadro, em milissegundos desde o início do quadro
+struct ProfileScopeTime {
+    const char* name;
+    uint32_t depth;
+    double start;
+    double duration;
+};
+
+struct ProfileFrame {
+    uint64_t index = 0;
+    double cpuMilliseconds = 0.0; // beginFrame() até endFrame()
+    double gpuMilliseconds = 0.0; // do primeiro ao último escopo de GPU; 0 se não chegou
+    std::vector<ProfileScopeTime> cpu; // só os da thread principal
+    std::vector<ProfileScopeTime> gpu; // do quadro anterior (lidos com um quadro de atraso)
+    uint64_t counters[PROFILE_COUNTER_COUNT] = {};
+};
+
+class FrameProfiler {
+public:
+    // Início e fim de cada quadro, na thread principal com o contexto OpenGL ativo
+    static void beginFrame();
+    static void endFrame();
+
+    static void count(ProfileCounter counter, uint64_t value);
+
+    // Grava os próximos frames quadros (incluindo os escopos desde o último endFrame)
+    // em path; o arquivo é escrito quando os tempos de GPU do último quadro chegam.
+    // false se já há uma captura em andamento
+    static bool capture(int frames, const std::string& path);
+    static bool capturing();
+
+    static const ProfileFrame& lastFrame();
+
+    // Escopos descartados porque o anel de alguma thread encheu
+    static uint64_t droppedScopes();
+
+    // Remove as consultas da GPU (com o contexto ativo, antes de destruí-lo)
+    static void release();
+
+    // Nanossegundos desde o início do programa (relógio dos escopos)
+    static uint64_t now();
+
+    // Usados por ProfileScope e GpuProfileScope
+    static void recordScope(const char* name, uint64_t begin, uint64_t end, uint32_t depth);
+    static int beginGpuScope(const char* name);
+    static void endGpuScope(int query);
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name);
+    ~ProfileScope();
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name;
+    uint64_t begin;
+};
+
+class GpuProfileScope {
+public:
+    explicit GpuProfileScope(const char* name) : query(FrameProfiler::beginGpuScope(name)) {}
+    ~GpuProfileScope() { FrameProfiler::endGpuScope(query); }
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+    int query;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_GPU_SCOPE(name) GpuProfileScope PROFILE_CONCAT(gpuProfileScope, __LINE__)(name)
+
+#endif
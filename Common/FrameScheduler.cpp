@@ -0,0 +1,60 @@
+/* Agendamento de quadros - implementação
+ * Ver FrameScheduler.h
+ */
+
+#include "FrameScheduler.h"
+
+#include <chrono>
+
+using namespace std;
+
+double schedulerSeconds()
+{
+    static const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+FixedTimestep::FixedTimestep(double step, int maxTicksPerFrame)
+    : stepSeconds(step), maxTicks(maxTicksPerFrame)
+{
+}
+
+int FixedTimestep::advance(double frameTime)
+{
+    accumulator += frameTime;
+    int ticks = 0;
+    while (accumulator >= stepSeconds && ticks < maxTicks) {
+        accumulator -= stepSeconds;
+        ++ticks;
+    }
+    if (accumulator >= stepSeconds)
+        accumulator = 0.0; // atraso grande demais: descarta em vez de acumular
+    tickCount += ticks;
+    return ticks;
+}
+
+void SimulationThread::start(double step, function<void(double)> tick)
+{
+    stop();
+    quit = false;
+    thread = std::thread([this, step, tick] {
+        double next = schedulerSeconds();
+        while (!quit) {
+            tick(step);
+            next += step;
+            double now = schedulerSeconds();
+            if (now > next + 8 * step)
+                next = now; // mesma regra do FixedTimestep: não tenta recuperar atrasos grandes
+            else if (next > now)
+                this_thread::sleep_for(chrono::duration<double>(next - now));
+        }
+    });
+}
+
+void SimulationThread::stop()
+{
+    if (!thread.joinable())
+        return;
+    quit = true;
+    thread.join();
+}
@@ -0,0 +1,99 @@
+/* Agendamento de quadros: simulação em passo fixo separada do desenho
+ *
+ * Antes o movimento avançava com o deltaTime do quadro dentro do laço de desenho,
+ * então o resultado da simulação (órbitas, trajetórias) e o seu custo dependiam da
+ * taxa de quadros. Aqui a simulação avança sempre em passos fixos (ticks):
+ *
+ *  - FixedTimestep acumula o tempo dos quadros e diz quantos ticks rodar; o que
+ *    sobra no acumulador vira o fator alpha para interpolar o desenho entre o
+ *    estado do tick anterior e o do atual;
+ *  - SimulationThread roda os ticks em uma thread própria, no seu próprio ritmo;
+ *  - TripleBuffer troca o estado entre a thread da simulação e a do desenho sem
+ *    travas: a simulação sempre tem um buffer livre para escrever e o desenho
+ *    sempre lê o último estado completo publicado.
+ */
+
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+// Relógio monotônico em segundos (compartilhado entre as threads)
+double schedulerSeconds();
+
+class FixedTimestep {
+public:
+    // maxTicksPerFrame evita a "espiral da morte": se o quadro demorar demais,
+    // o tempo excedente é descartado em vez de acumulado
+    explicit FixedTimestep(double step = 1.0 / 60.0, int maxTicksPerFrame = 8);
+
+    // Soma o tempo do quadro e retorna quantos ticks de step() segundos devem rodar
+    int advance(double frameTime);
+
+    double step() const { return stepSeconds; }
+    // Fração do próximo tick já decorrida, em [0, 1): peso do estado atual na interpolação
+    float alpha() const { return (float)(accumulator / stepSeconds); }
+    unsigned long long ticks() const { return tickCount; }
+
+private:
+    double stepSeconds;
+    int maxTicks;
+    double accumulator = 0.0;
+    unsigned long long tickCount = 0;
+};
+
+// Executa tick(step) a cada step segundos em uma thread separada
+class SimulationThread {
+public:
+    ~SimulationThread() { stop(); }
+
+    void start(double step, std::function<void(double)> tick);
+    void stop();
+    bool running() const { return thread.joinable(); }
+
+private:
+    std::thread thread;
+    std::atomic<bool> quit{false};
+};
+
+// Buffer triplo sem travas para um escritor e um leitor
+template <typename T>
+class TripleBuffer {
+public:
+    // Escritor: preenche writeBuffer() e chama publish()
+    T& writeBuffer() { return buffers[writeIndex]; }
+    void publish() { writeIndex = middle.exchange(writeIndex | FRESH) & INDEX_MASK; }
+
+    // Leitor: fetch() pega o último estado publicado (se houver um novo) e readBuffer() o lê
+    bool fetch()
+    {
+        if (!(middle.load() & FRESH))
+            return false;
+        readIndex = middle.exchange(readIndex) & INDEX_MASK;
+        return true;
+    }
+    const T& readBuffer() const { return buffers[readIndex]; }
+
+    // Preenche os três buffers com o mesmo estado (só com o escritor parado)
+    void reset(const T& value)
+    {
+        for (T& buffer : buffers)
+            buffer = value;
+        writeIndex = 0;
+        readIndex = 1;
+        middle = 2u;
+    }
+
+private:
+    static const unsigned INDEX_MASK = 3u;
+    static const unsigned FRESH = 4u; // o buffer do meio tem um estado ainda não lido
+
+    T buffers[3];
+    unsigned writeIndex = 0;
+    unsigned readIndex = 1;
+    std::atomic<unsigned> middle{2u};
+};
+
+#endif
@@ -0,0 +1,242 @@
+/* Contexto OpenGL sem janela - implementação
+ * Ver HeadlessContext.h
+ */
+
+#include "HeadlessContext.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifdef HEADLESS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+using namespace std;
+
+#ifdef HEADLESS_EGL
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+// Procura name na lista de extensões separadas por espaço (sem casar prefixos)
+static bool hasExtension(const char* extensions, const char* name)
+{
+    if (!extensions)
+        return false;
+    size_t length = strlen(name);
+    for (const char* found = strstr(extensions, name); found; found = strstr(found + length, name)) {
+        bool starts = found == extensions || found[-1] == ' ';
+        bool ends = found[length] == ' ' || found[length] == '\0';
+        if (starts && ends)
+            return true;
+    }
+    return false;
+}
+
+static void* loadProc(const char* name)
+{
+    return (void*)eglGetProcAddress(name);
+}
+
+#endif
+
+GLADloadproc HeadlessContext::procAddress()
+{
+#ifdef HEADLESS_EGL
+    return loadProc;
+#else
+    return nullptr;
+#endif
+}
+
+bool HeadlessContext::create(int width, int height)
+{
+    destroy();
+#ifndef HEADLESS_EGL
+    (void)width;
+    (void)height;
+    cout << "Renderizacao sem janela indisponivel: compilado sem EGL" << endl;
+    return false;
+#else
+    // Plataforma surfaceless: não precisa de servidor gráfico nem de placa de vídeo
+    EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+    if (hasExtension(eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS), "EGL_MESA_platform_surfaceless")) {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (getPlatformDisplay)
+            eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+    if (eglDisplay == EGL_NO_DISPLAY)
+        eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    EGLint major = 0, minor = 0;
+    if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) {
+        cout << "EGL: nenhum display disponivel" << endl;
+        return false;
+    }
+    display = eglDisplay;
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        cout << "EGL: OpenGL (desktop) nao suportado" << endl;
+        destroy();
+        return false;
+    }
+
+    // A cor e a profundidade do quadro ficam no framebuffer próprio: a configuração só
+    // precisa aceitar OpenGL (e um pbuffer, se o contexto não puder ficar sem superfície)
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    eglChooseConfig(eglDisplay, configAttributes, &config, 1, &configCount);
+
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 4,
+        EGL_CONTEXT_MINOR_VERSION, 0,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext eglContext = eglCreateContext(eglDisplay, configCount > 0 ? config : EGL_NO_CONFIG_KHR,
+                                             EGL_NO_CONTEXT, contextAttributes);
+    if (eglContext == EGL_NO_CONTEXT) {
+        cout << "EGL: nao foi possivel criar um contexto OpenGL 4.0 core (erro 0x" << hex << eglGetError()
+             << dec << ")" << endl;
+        destroy();
+        return false;
+    }
+    context = eglContext;
+
+    EGLSurface eglSurface = EGL_NO_SURFACE;
+    if (!hasExtension(eglQueryString(eglDisplay, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context")) {
+        const EGLint pbufferAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        if (configCount > 0)
+            eglSurface = eglCreatePbufferSurface(eglDisplay, config, pbufferAttributes);
+        if (eglSurface == EGL_NO_SURFACE) {
+            cout << "EGL: sem contexto sem superficie e sem pbuffer" << endl;
+            destroy();
+            return false;
+        }
+        surface = eglSurface;
+    }
+    if (!eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext) || !gladLoadGLLoader(loadProc)) {
+        cout << "EGL: falha ao ativar o contexto OpenGL" << endl;
+        destroy();
+        return false;
+    }
+
+    // Framebuffer do quadro, no lugar do da janela
+    glGenFramebuffers(1, &fbo);
+    glGenRenderbuffers(1, &colorBuffer);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        cout << "Framebuffer do quadro incompleto" << endl;
+        destroy();
+        return false;
+    }
+    frameWidth = width;
+    frameHeight = height;
+    glViewport(0, 0, width, height);
+
+    cout << "Contexto sem janela: EGL " << major << "." << minor << ", " << glGetString(GL_RENDERER) << endl;
+    return true;
+#endif
+}
+
+void HeadlessContext::destroy()
+{
+#ifdef HEADLESS_EGL
+    if (context && fbo) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteRenderbuffers(1, &colorBuffer);
+        glDeleteRenderbuffers(1, &depthBuffer);
+    }
+    if (display) {
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (surface)
+            eglDestroySurface(display, surface);
+        if (context)
+            eglDestroyContext(display, context);
+        eglTerminate(display);
+    }
+#endif
+    display = context = surface = nullptr;
+    fbo = colorBuffer = depthBuffer = 0;
+    frameWidth = frameHeight = 0;
+}
+
+bool HeadlessContext::extensionSupported(const char* name) const
+{
+    if (!context)
+        return false;
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+        if (extension && strcmp(extension, name) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool HeadlessContext::readFrame(vector<uint8_t>& rgb) const
+{
+    if (!fbo)
+        return false;
+    size_t rowSize = (size_t)frameWidth * 3;
+    rgb.resize(rowSize * frameHeight);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, frameWidth, frameHeight, GL_RGB, GL_UNSIGNED_BYTE, rgb.data());
+
+    // O OpenGL devolve a linha de baixo primeiro
+    for (int top = 0, bottom = frameHeight - 1; top < bottom; ++top, --bottom)
+        swap_ranges(rgb.begin() + top * rowSize, rgb.begin() + (top + 1) * rowSize, rgb.begin() + bottom * rowSize);
+    return true;
+}
+
+// --- Imagens ---
+
+bool writeFrameImage(const string& path, int width, int height, const vector<uint8_t>& rgb)
+{
+    if (width <= 0 || height <= 0 || rgb.size() < (size_t)width * height * 3)
+        return false;
+    size_t dot = path.find_last_of('.');
+    string extension = dot == string::npos ? string() : path.substr(dot + 1);
+    transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension != "png" && extension != "ppm" && extension != "raw")
+        return false;
+
+    if (extension == "png")
+        return stbi_write_png(path.c_str(), width, height, 3, rgb.data(), width * 3) != 0;
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+    bool ok = true;
+    if (extension == "ppm")
+        ok = fprintf(file, "P6\n%d %d\n255\n", width, height) > 0;
+    size_t size = (size_t)width * height * 3;
+    ok = ok && fwrite(rgb.data(), 1, size, file) == size;
+    return fclose(file) == 0 && ok;
+}
@@ -0,0 +1,68 @@
+/* Contexto OpenGL sem janela, para renderização em lote (servidores de build, CI)
+ *
+ * HeadlessContext cria um contexto OpenGL 4.0 core pelo EGL, sem display: primeiro a
+ * plataforma surfaceless da Mesa (funciona no llvmpipe, sem GPU); se ela não existir,
+ * o display padrão com um pbuffer de 1x1 só para ativar o contexto. Os quadros são
+ * desenhados em um framebuffer próprio (cor RGBA8, profundidade 24 + stencil 8) do
+ * tamanho pedido, que fica ligado no lugar do framebuffer da janela: o código de
+ * desenho não muda.
+ *
+ * readFrame() lê o quadro em RGB de cima para baixo e writeFrameImage() grava em .png
+ * (pelo stb_image_write, do mesmo repositório do stb_image), .ppm ou .raw (os bytes RGB,
+ * sem cabeçalho).
+ *
+ * O EGL só entra com HEADLESS_EGL definido (o CMake define quando encontra a libEGL,
+ * fora do Windows e do macOS); sem ele, create() falha com uma mensagem.
+ */
+
+#ifndef HEADLESS_CONTEXT_H
+#define HEADLESS_CONTEXT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+class HeadlessContext {
+public:
+    HeadlessContext() = default;
+    ~HeadlessContext() { destroy(); }
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    // Cria o contexto, carrega a GLAD e deixa o framebuffer do quadro ligado, com o
+    // viewport do tamanho dele. false (com a causa no cout) se não houver EGL/OpenGL 4.0
+    bool create(int width, int height);
+    void destroy();
+
+    // Função de carga para a GLAD / ShaderVariants::enableBinaryCache
+    static GLADloadproc procAddress();
+
+    // Equivalente a glfwExtensionSupported, pela lista do contexto atual
+    bool extensionSupported(const char* name) const;
+
+    GLuint framebuffer() const { return fbo; }
+    int width() const { return frameWidth; }
+    int height() const { return frameHeight; }
+
+    // Espera a GPU terminar o quadro e copia a cor para rgb (width * height * 3 bytes,
+    // primeira linha em cima)
+    bool readFrame(std::vector<uint8_t>& rgb) const;
+
+private:
+    void* display = nullptr;
+    void* context = nullptr;
+    void* surface = nullptr;
+    GLuint fbo = 0;
+    GLuint colorBuffer = 0;
+    GLuint depthBuffer = 0;
+    int frameWidth = 0;
+    int frameHeight = 0;
+};
+
+// Grava um quadro RGB (de cima para baixo) no formato da extensão de path: .png, .ppm
+// ou .raw. false se a extensão não é conhecida ou a escrita falhou
+bool writeFrameImage(const std::string& path, int width, int height, const std::vector<uint8_t>& rgb);
+
+#endif
@@ -0,0 +1,186 @@
+/* Sistema de jobs com roubo de trabalho - implementação
+ * Ver JobSystem.h
+ */
+
+#include "JobSystem.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std;
+
+// Worker da thread atual e o sistema a que ele pertence (nulo nas threads que não são
+// workers: a dona de cada sistema é o 0 dele)
+static thread_local unsigned currentWorker = 0;
+static thread_local const JobSystem* currentSystem = nullptr;
+
+// Fixa a thread atual em um núcleo
+static void pinCurrentThread(unsigned core)
+{
+#ifdef _WIN32
+    SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << (core % (8 * sizeof(DWORD_PTR))));
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core % CPU_SETSIZE, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)core;
+#endif
+}
+
+// --- Fila Chase-Lev (versão com atomics do C11 de Lê et al., 2013) ---
+
+bool WorkStealingDeque::push(Job* job)
+{
+    int64_t b = bottom.load(memory_order_relaxed);
+    int64_t t = top.load(memory_order_acquire);
+    if (b - t >= CAPACITY)
+        return false;
+    jobs[b & (CAPACITY - 1)].store(job, memory_order_relaxed);
+    // release: quem ler o novo bottom (acquire em steal) enxerga o job inteiro
+    bottom.store(b + 1, memory_order_release);
+    return true;
+}
+
+Job* WorkStealingDeque::pop()
+{
+    int64_t b = bottom.load(memory_order_relaxed) - 1;
+    bottom.store(b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t t = top.load(memory_order_relaxed);
+    if (t > b) {
+        bottom.store(b + 1, memory_order_relaxed);
+        return nullptr;
+    }
+    Job* job = jobs[b & (CAPACITY - 1)].load(memory_order_relaxed);
+    if (t == b) {
+        // Último job: disputa com os ladrões
+        if (!top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+            job = nullptr;
+        bottom.store(b + 1, memory_order_relaxed);
+    }
+    return job;
+}
+
+Job* WorkStealingDeque::steal()
+{
+    int64_t t = top.load(memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t b = bottom.load(memory_order_acquire);
+    if (t >= b)
+        return nullptr;
+    Job* job = jobs[t & (CAPACITY - 1)].load(memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+        return nullptr;
+    return job;
+}
+
+// --- JobSystem ---
+
+JobSystem::JobSystem(unsigned threadCount, bool pinThreads)
+{
+    if (threadCount == 0)
+        threadCount = max(1u, thread::hardware_concurrency());
+    for (unsigned i = 0; i < threadCount; ++i)
+        queues.push_back(new WorkStealingDeque());
+    owner = this_thread::get_id();
+    for (unsigned i = 1; i < threadCount; ++i)
+        workers.emplace_back(&JobSystem::workerLoop, this, i, pinThreads);
+}
+
+JobSystem::~JobSystem()
+{
+    quit = true;
+    {
+        lock_guard<mutex> lock(sleepMutex);
+        wakeUp.notify_all();
+    }
+    for (thread& worker : workers)
+        worker.join();
+    for (WorkStealingDeque* queue : queues)
+        delete queue;
+}
+
+unsigned JobSystem::workerIndex()
+{
+    return currentWorker;
+}
+
+int JobSystem::queueIndex() const
+{
+    if (currentSystem == this)
+        return (int)currentWorker;
+    return ownedByCurrentThread() ? 0 : -1;
+}
+
+void JobSystem::run(Job* job)
+{
+    int queue = queueIndex();
+    assert(queue >= 0 && "JobSystem: jobs enviados por uma thread que nao e a dona");
+    if (queue < 0 || !queues[queue]->push(job)) {
+        // Thread de fora (não pode empilhar na fila de ninguém) ou fila cheia: executa na hora
+        job->function(*job);
+        if (job->counter)
+            job->counter->fetch_sub(1, memory_order_release);
+        return;
+    }
+    queuedJobs.fetch_add(1);
+    if (sleepingWorkers.load() > 0) {
+        lock_guard<mutex> lock(sleepMutex);
+        wakeUp.notify_one();
+    }
+}
+
+// worker < 0 (thread de fora): só rouba, sem tocar em uma fila que não é dela
+bool JobSystem::executeOne(int worker)
+{
+    unsigned first = worker < 0 ? 0 : (unsigned)worker;
+    Job* job = worker < 0 ? nullptr : queues[first]->pop();
+    for (unsigned i = worker < 0 ? 0 : 1; !job && i < queues.size(); ++i)
+        job = queues[(first + i) % queues.size()]->steal();
+    if (!job)
+        return false;
+
+    queuedJobs.fetch_sub(1);
+    job->function(*job);
+    if (job->counter)
+        job->counter->fetch_sub(1, memory_order_release);
+    return true;
+}
+
+void JobSystem::wait(atomic<int>& counter)
+{
+    int worker = queueIndex();
+    while (counter.load(memory_order_acquire) > 0)
+        if (!executeOne(worker))
+            this_thread::yield();
+}
+
+void JobSystem::workerLoop(unsigned worker, bool pin)
+{
+    currentWorker = worker;
+    currentSystem = this;
+    if (pin)
+        pinCurrentThread(worker);
+
+    int idleSpins = 0;
+    while (!quit) {
+        if (executeOne(worker)) {
+            idleSpins = 0;
+        } else if (++idleSpins < 64) {
+            this_thread::yield();
+        } else {
+            // Sem trabalho por um tempo: dorme até run() enfileirar algo
+            unique_lock<mutex> lock(sleepMutex);
+            sleepingWorkers.fetch_add(1);
+            wakeUp.wait(lock, [this] { return quit || queuedJobs.load() > 0; });
+            sleepingWorkers.fetch_sub(1);
+            idleSpins = 0;
+        }
+    }
+}
@@ -0,0 +1,137 @@
+/* Sistema de jobs com roubo de trabalho (work stealing)
+ *
+ * Um conjunto fixo de threads (workers), cada uma com a sua fila Chase-Lev: a dona
+ * empilha e desempilha jobs em uma ponta sem travas, e as outras threads, quando
+ * ficam sem trabalho, roubam da outra ponta. A thread que cria o JobSystem (a
+ * principal) é o worker 0 e também executa jobs enquanto espera.
+ *
+ * Dependências são contadores atômicos: cada job decrementa o seu contador ao
+ * terminar e wait() só retorna quando ele chega a zero, executando outros jobs
+ * nesse meio-tempo. parallelFor() divide um intervalo em blocos e espera todos.
+ *
+ * Só a thread dona (a que criou o JobSystem ou a última que chamou setOwner()) e os
+ * próprios workers podem enviar jobs: a fila do worker 0 é da dona e só ela empilha
+ * nela. Um envio de outra thread dispara o assert e, sem asserts, o job é executado na
+ * hora por quem o enviou, sem passar pelas filas.
+ */
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Unidade de trabalho. A memória do job é de quem o envia e deve viver até ele terminar
+struct Job {
+    void (*function)(const Job&) = nullptr;
+    void* data = nullptr;
+    size_t begin = 0, end = 0;
+    std::atomic<int>* counter = nullptr; // decrementado quando o job termina (pode ser nulo)
+};
+
+// Fila Chase-Lev de capacidade fixa: push/pop só pela thread dona, steal por qualquer uma
+class WorkStealingDeque {
+public:
+    static const int64_t CAPACITY = 4096; // potência de 2
+
+    bool push(Job* job);   // false se a fila estiver cheia
+    Job* pop();            // nullptr se vazia
+    Job* steal();          // nullptr se vazia ou se perdeu a disputa
+
+private:
+    // Em linhas de cache separadas: top é disputado pelos ladrões, bottom é da dona
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    std::atomic<Job*> jobs[CAPACITY];
+};
+
+class JobSystem {
+public:
+    // threadCount = 0 usa todos os núcleos; pinThreads fixa cada worker em um núcleo
+    explicit JobSystem(unsigned threadCount = 0, bool pinThreads = true);
+    ~JobSystem();
+
+    unsigned threadCount() const { return (unsigned)queues.size(); }
+
+    // Índice da thread atual em [0, threadCount()) (a thread dona é o 0)
+    static unsigned workerIndex();
+
+    // A thread atual passa a ser a dona (worker 0), no lugar da anterior. Só com o
+    // sistema parado: nenhum job pendente e a dona anterior sem enviar mais nada
+    void setOwner() { owner = std::this_thread::get_id(); }
+    bool ownedByCurrentThread() const { return owner.load() == std::this_thread::get_id(); }
+
+    // Enfia o job na fila da thread atual (o contador já deve contar com ele)
+    void run(Job* job);
+
+    // Executa jobs até o contador chegar a zero
+    void wait(std::atomic<int>& counter);
+
+    // Chama body(begin, end) para blocos de grain elementos de [0, count) e espera todos.
+    // grain = 0 escolhe blocos para uns 4 jobs por thread; os blocos crescem se passarem
+    // de MAX_PARALLEL_JOBS
+    template <typename F>
+    void parallelFor(size_t count, size_t grain, F&& body);
+
+private:
+    // Máximo de blocos de um parallelFor: os jobs ficam na pilha de quem chama
+    static const size_t MAX_PARALLEL_JOBS = 256;
+
+    // Fila da thread atual neste sistema; -1 se ela não é a dona nem um worker dele
+    int queueIndex() const;
+    bool executeOne(int worker);
+    void workerLoop(unsigned worker, bool pin);
+
+    template <typename F>
+    static void invokeRange(const Job& job) { (*static_cast<F*>(job.data))(job.begin, job.end); }
+
+    std::vector<WorkStealingDeque*> queues;
+    std::vector<std::thread> workers;
+    std::atomic<std::thread::id> owner;
+    std::atomic<bool> quit{false};
+    std::atomic<int> queuedJobs{0};
+    std::atomic<int> sleepingWorkers{0};
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+};
+
+template <typename F>
+void JobSystem::parallelFor(size_t count, size_t grain, F&& body)
+{
+    if (count == 0)
+        return;
+    if (grain == 0)
+        grain = count / (threadCount() * 4) + 1;
+    if ((count + grain - 1) / grain > MAX_PARALLEL_JOBS)
+        grain = (count + MAX_PARALLEL_JOBS - 1) / MAX_PARALLEL_JOBS;
+    size_t jobCount = (count + grain - 1) / grain;
+    bool allowed = queueIndex() >= 0;
+    assert(allowed && "JobSystem: jobs enviados por uma thread que nao e a dona");
+    if (jobCount == 1 || threadCount() == 1 || !allowed) {
+        body((size_t)0, count);
+        return;
+    }
+
+    // Os jobs ficam na pilha: um parallelFor não aloca no heap
+    typedef typename std::remove_reference<F>::type Body;
+    Job jobs[MAX_PARALLEL_JOBS];
+    std::atomic<int> counter((int)jobCount);
+    for (size_t i = 0; i < jobCount; ++i) {
+        jobs[i].function = &JobSystem::invokeRange<Body>;
+        jobs[i].data = (void*)&body;
+        jobs[i].begin = i * grain;
+        jobs[i].end = i + 1 < jobCount ? (i + 1) * grain : count;
+        jobs[i].counter = &counter;
+        run(&jobs[i]);
+    }
+    wait(counter);
+}
+
+#endif
@@ -0,0 +1,91 @@
+/* Cálculo em lote das matrizes de normais - implementação
+ * Ver NormalMatrix.h
+ */
+
+#include "NormalMatrix.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NORMAL_MATRIX_SSE 1
+#include <emmintrin.h>
+#endif
+
+using namespace glm;
+
+// Inversa transposta de uma matriz por vez
+static inline mat3 normalMatrixOf(const mat4& model)
+{
+    vec3 a = vec3(model[0]), b = vec3(model[1]), c = vec3(model[2]);
+    vec3 bc = cross(b, c), ca = cross(c, a), ab = cross(a, b);
+    float det = dot(a, bc);
+    float invDet = det != 0.0f ? 1.0f / det : 0.0f;
+    return mat3(bc * invDet, ca * invDet, ab * invDet);
+}
+
+void computeNormalMatricesScalar(const mat4* models, mat3* normalMatrices, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        normalMatrices[i] = normalMatrixOf(models[i]);
+}
+
+#ifdef NORMAL_MATRIX_SSE
+// Produto vetorial de 4 pares de vetores em formato SoA (x, y e z em registradores separados)
+static inline void cross4(__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz,
+                          __m128 &rx, __m128 &ry, __m128 &rz)
+{
+    rx = _mm_sub_ps(_mm_mul_ps(ay, bz), _mm_mul_ps(az, by));
+    ry = _mm_sub_ps(_mm_mul_ps(az, bx), _mm_mul_ps(ax, bz));
+    rz = _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx));
+}
+#endif
+
+void computeNormalMatrices(const mat4* models, mat3* normalMatrices, size_t count)
+{
+    size_t i = 0;
+#ifdef NORMAL_MATRIX_SSE
+    for (; i + 4 <= count; i += 4) {
+        // Colunas a, b e c das 4 matrizes. As colunas 4x4 são lidas inteiras e
+        // transpostas para que cada registrador tenha a mesma componente das 4 matrizes
+        __m128 col[3][4];
+        for (int c = 0; c < 3; ++c) {
+            __m128 m0 = _mm_loadu_ps(&models[i + 0][c][0]);
+            __m128 m1 = _mm_loadu_ps(&models[i + 1][c][0]);
+            __m128 m2 = _mm_loadu_ps(&models[i + 2][c][0]);
+            __m128 m3 = _mm_loadu_ps(&models[i + 3][c][0]);
+            _MM_TRANSPOSE4_PS(m0, m1, m2, m3);
+            col[c][0] = m0; // x das 4 matrizes
+            col[c][1] = m1; // y
+            col[c][2] = m2; // z
+        }
+        __m128 bcx, bcy, bcz, cax, cay, caz, abx, aby, abz;
+        cross4(col[1][0], col[1][1], col[1][2], col[2][0], col[2][1], col[2][2], bcx, bcy, bcz);
+        cross4(col[2][0], col[2][1], col[2][2], col[0][0], col[0][1], col[0][2], cax, cay, caz);
+        cross4(col[0][0], col[0][1], col[0][2], col[1][0], col[1][1], col[1][2], abx, aby, abz);
+
+        __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(col[0][0], bcx), _mm_mul_ps(col[0][1], bcy)),
+                                _mm_mul_ps(col[0][2], bcz));
+        // Divisão exata (e não _mm_rcp_ps) para bater com a versão escalar; matrizes singulares viram zero
+        __m128 nonZero = _mm_cmpneq_ps(det, _mm_setzero_ps());
+        __m128 invDet = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), det), nonZero);
+
+        __m128 e0 = _mm_mul_ps(bcx, invDet), e1 = _mm_mul_ps(bcy, invDet), e2 = _mm_mul_ps(bcz, invDet);
+        __m128 e3 = _mm_mul_ps(cax, invDet), e4 = _mm_mul_ps(cay, invDet), e5 = _mm_mul_ps(caz, invDet);
+        __m128 e6 = _mm_mul_ps(abx, invDet), e7 = _mm_mul_ps(aby, invDet), e8 = _mm_mul_ps(abz, invDet);
+
+        // Volta para o formato de uma mat3 (9 floats) por matriz: os elementos 0-3 e 4-7
+        // são transpostos de 4 em 4 e o elemento 8 é gravado isolado
+        _MM_TRANSPOSE4_PS(e0, e1, e2, e3);
+        _MM_TRANSPOSE4_PS(e4, e5, e6, e7);
+        __m128 first[4] = { e0, e1, e2, e3 };
+        __m128 second[4] = { e4, e5, e6, e7 };
+        for (int m = 0; m < 4; ++m) {
+            float* dst = &normalMatrices[i + m][0][0];
+            _mm_storeu_ps(dst, first[m]);
+            _mm_storeu_ps(dst + 4, second[m]);
+            _mm_store_ss(dst + 8, e8);
+            e8 = _mm_shuffle_ps(e8, e8, _MM_SHUFFLE(0, 3, 2, 1));
+        }
+    }
+#endif
+    // Restante (ou tudo, sem SSE)
+    computeNormalMatricesScalar(models + i, normalMatrices + i, count - i);
+}
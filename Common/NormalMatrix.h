@@ -0,0 +1,26 @@
+/* Cálculo em lote das matrizes de normais (inversa transposta da parte 3x3 da model)
+ *
+ * Antes cada vertex shader fazia mat3(transpose(inverse(model))) para cada vértice:
+ * uma inversa 4x4 completa por vértice. Como a matriz é a mesma para todos os vértices
+ * de um objeto, ela é calculada aqui uma única vez por objeto e enviada como uniform
+ * (uniform mat3 normalMatrix).
+ *
+ * Para uma matriz 3x3 de colunas a, b e c, a inversa transposta tem colunas
+ * (b x c, c x a, a x b) / det, com det = a . (b x c). A versão SSE processa
+ * 4 matrizes por vez, uma em cada posição dos registradores.
+ */
+
+#ifndef NORMAL_MATRIX_H
+#define NORMAL_MATRIX_H
+
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+// Calcula normalMatrices[i] = inversa transposta de mat3(models[i]), i em [0, count)
+void computeNormalMatrices(const glm::mat4* models, glm::mat3* normalMatrices, size_t count);
+
+// Mesma conta sem SIMD, uma matriz por vez (referência e fallback)
+void computeNormalMatricesScalar(const glm::mat4* models, glm::mat3* normalMatrices, size_t count);
+
+#endif
@@ -0,0 +1,125 @@
+/* Carregamento de malhas OBJ com material MTL - implementação
+ * Ver ObjLoader.h
+ */
+
+#include "ObjLoader.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "FrameProfiler.h"
+
+using namespace std;
+using namespace glm;
+
+//  Função para carregar um arquivo OBJ e MTL
+bool loadOBJ(const string &objPath, const string &mtlPath, string &textureFileOut,
+             vector<vec3>& outPositions, vector<vec2>& outTexCoords, vector<vec3>& outNormals,
+             Material& outMaterial, LinearArena& scratch)
+{
+    PROFILE_SCOPE("loadOBJ");
+    ifstream objFile(objPath);
+    if (!objFile.is_open())
+    {
+        cout << "Não foi possível abrir OBJ: " << objPath << endl;
+        return false;
+    }
+
+    ArenaVector<vec3> tempPositions{ ArenaAllocator<vec3>(scratch) };
+    ArenaVector<vec2> tempTexCoords{ ArenaAllocator<vec2>(scratch) };
+
+    string line;
+    while (getline(objFile, line))
+    {
+        istringstream iss(line);
+        string prefix;
+        iss >> prefix;
+
+        if (prefix == "v")
+        {
+            vec3 pos;
+            iss >> pos.x >> pos.y >> pos.z;
+            tempPositions.push_back(pos);
+        }
+        else if (prefix == "vt")
+        {
+            vec2 tex;
+            iss >> tex.x >> tex.y;
+            // tex.y = 1.0f - tex.y;
+            tempTexCoords.push_back(tex);
+        }
+        else if (prefix == "f")
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                string v;
+                iss >> v;
+
+                size_t pos1 = v.find('/');
+                size_t pos2 = v.find('/', pos1 + 1);
+
+                int vi = stoi(v.substr(0, pos1)) - 1;
+                int ti = stoi(v.substr(pos1 + 1, pos2 - pos1 - 1)) - 1;
+
+                outPositions.push_back(tempPositions[vi]);
+                outTexCoords.push_back(tempTexCoords[ti]);
+            }
+        }
+    }
+
+    // Inicializa os valores padrão do material
+    outMaterial.ka = vec3(0.2f, 0.2f, 0.2f);
+    outMaterial.kd = vec3(0.8f, 0.8f, 0.8f);
+    outMaterial.ks = vec3(1.0f, 1.0f, 1.0f);
+    outMaterial.shininess = 32.0f;
+
+    ifstream mtlFile(mtlPath);
+    if (!mtlFile.is_open())
+    {
+        cout << "Não foi possível abrir MTL: " << mtlPath << endl;
+        return false;
+    }
+
+    while (getline(mtlFile, line))
+    {
+        istringstream iss(line);
+        string prefix;
+        iss >> prefix;
+
+        if (prefix == "map_Kd")
+        {
+            string texFile;
+            iss >> texFile;
+
+            string mtlDir = mtlPath.substr(0, mtlPath.find_last_of("/\\"));
+            textureFileOut = mtlDir + "/" + texFile;
+        }
+        else if (prefix == "Ka")
+        {
+            iss >> outMaterial.ka.r >> outMaterial.ka.g >> outMaterial.ka.b;
+        }
+        else if (prefix == "Kd")
+        {
+            iss >> outMaterial.kd.r >> outMaterial.kd.g >> outMaterial.kd.b;
+        }
+        else if (prefix == "Ks")
+        {
+            iss >> outMaterial.ks.r >> outMaterial.ks.g >> outMaterial.ks.b;
+        }
+        else if (prefix == "Ns") // Coeficiente de brilho especular
+        {
+            iss >> outMaterial.shininess;
+        }
+    }
+
+    // Calcula normais
+    outNormals.clear();
+    for (size_t i = 0; i < outPositions.size(); i++) {
+        // Normais apontando para fora do centro aproximado do objeto
+        vec3 normal = normalize(outPositions[i]);
+        outNormals.push_back(normal);
+    }
+    
+    return true;
+}
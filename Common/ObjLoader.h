@@ -0,0 +1,27 @@
+/* Carregamento de malhas OBJ com material MTL
+ *
+ * Lê v, vt e f (triângulos "v/vt/vn") do OBJ e devolve os vértices já expandidos
+ * (três por face, sem índices), prontos para um VBO. Do MTL lê Ka, Kd, Ks, Ns e o
+ * map_Kd (caminho relativo à pasta do MTL). As normais apontam para fora da origem
+ * do modelo (as malhas dos exercícios são centradas nela).
+ *
+ * As posições e coordenadas de textura lidas ficam em vetores temporários na arena
+ * scratch: quem chama faz scratch.reset() depois de usar a malha.
+ */
+
+#ifndef OBJ_LOADER_H
+#define OBJ_LOADER_H
+
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "EntityWorld.h"
+#include "FrameAllocator.h"
+
+bool loadOBJ(const std::string& objPath, const std::string& mtlPath, std::string& textureFileOut,
+             std::vector<glm::vec3>& outPositions, std::vector<glm::vec2>& outTexCoords,
+             std::vector<glm::vec3>& outNormals, Material& outMaterial, LinearArena& scratch);
+
+#endif
@@ -0,0 +1,200 @@
+/* Sobreposição do profiler na tela - implementação
+ * Ver ProfilerOverlay.h
+ */
+
+#include "ProfilerOverlay.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "FrameProfiler.h"
+
+using namespace std;
+
+// Escala: a largura do painel é 33,3 ms (dois quadros a 60 Hz)
+static const float PANEL_X = 10.0f, PANEL_Y = 10.0f;
+static const float PANEL_WIDTH = 480.0f;
+static const float PANEL_MILLISECONDS = 1000.0f / 30.0f;
+static const float ROW_HEIGHT = 10.0f;
+static const int CPU_ROWS = 4, GPU_ROWS = 2;
+static const float GRAPH_HEIGHT = 60.0f;
+
+static const float PALETTE[8][4] = {
+    { 0.90f, 0.30f, 0.30f, 0.9f }, { 0.30f, 0.75f, 0.35f, 0.9f }, { 0.35f, 0.50f, 0.95f, 0.9f },
+    { 0.95f, 0.80f, 0.25f, 0.9f }, { 0.75f, 0.40f, 0.90f, 0.9f }, { 0.25f, 0.85f, 0.85f, 0.9f },
+    { 0.95f, 0.55f, 0.20f, 0.9f }, { 0.65f, 0.65f, 0.65f, 0.9f },
+};
+static const char* PALETTE_NAMES[8] = { "vermelho", "verde", "azul", "amarelo", "roxo", "ciano", "laranja", "cinza" };
+static const float BACKGROUND[4] = { 0.0f, 0.0f, 0.0f, 0.6f };
+static const float MARKER[4] = { 1.0f, 1.0f, 1.0f, 0.9f };
+static const float CPU_BAR[4] = { 0.35f, 0.55f, 0.95f, 0.9f };
+static const float GPU_BAR[4] = { 0.95f, 0.55f, 0.20f, 0.9f };
+
+// Cor fixa para cada nome (a mesma em todos os quadros)
+static int paletteIndex(const char* name)
+{
+    unsigned hash = 2166136261u;
+    for (const char* c = name; *c; ++c)
+        hash = (hash ^ (unsigned char)*c) * 16777619u;
+    return (int)(hash % 8);
+}
+
+static const char* overlayVertexSource = R"(
+#version 400 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec4 aColor;
+uniform vec2 screen;
+out vec4 color;
+void main() {
+    // Pixels com a origem no canto superior esquerdo
+    gl_Position = vec4(aPos.x / screen.x * 2.0 - 1.0, 1.0 - aPos.y / screen.y * 2.0, 0.0, 1.0);
+    color = aColor;
+}
+)";
+
+static const char* overlayFragmentSource = R"(
+#version 400 core
+in vec4 color;
+out vec4 FragColor;
+void main() {
+    FragColor = color;
+}
+)";
+
+bool ProfilerOverlay::init()
+{
+    GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertex, 1, &overlayVertexSource, nullptr);
+    glCompileShader(vertex);
+    GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragment, 1, &overlayFragmentSource, nullptr);
+    glCompileShader(fragment);
+    program = glCreateProgram();
+    glAttachShader(program, vertex);
+    glAttachShader(program, fragment);
+    glLinkProgram(program);
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+    GLint linked = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        release();
+        return false;
+    }
+    screenLocation = glGetUniformLocation(program, "screen");
+
+    glGenVertexArrays(1, &vertexArray);
+    glGenBuffers(1, &buffer);
+    glBindVertexArray(vertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return true;
+}
+
+void ProfilerOverlay::release()
+{
+    if (program)
+        glDeleteProgram(program);
+    if (buffer)
+        glDeleteBuffers(1, &buffer);
+    if (vertexArray)
+        glDeleteVertexArrays(1, &vertexArray);
+    program = buffer = vertexArray = 0;
+}
+
+void ProfilerOverlay::addRect(float x, float y, float width, float height, const float color[4])
+{
+    const float corners[6][2] = { { x, y }, { x, y + height }, { x + width, y + height },
+                                  { x, y }, { x + width, y + height }, { x + width, y } };
+    for (const float* corner : corners) {
+        vertices.push_back(corner[0]);
+        vertices.push_back(corner[1]);
+        vertices.insert(vertices.end(), color, color + 4);
+    }
+}
+
+void ProfilerOverlay::draw(int screenWidth, int screenHeight)
+{
+    if (!program)
+        return;
+    const ProfileFrame& frame = FrameProfiler::lastFrame();
+    cpuHistory[historyNext] = (float)frame.cpuMilliseconds;
+    gpuHistory[historyNext] = (float)frame.gpuMilliseconds;
+    historyNext = (historyNext + 1) % HISTORY;
+
+    const float pixelsPerMillisecond = PANEL_WIDTH / PANEL_MILLISECONDS;
+    const float timelineHeight = (CPU_ROWS + GPU_ROWS) * ROW_HEIGHT + 4.0f;
+    const float graphY = PANEL_Y + timelineHeight + 6.0f;
+    vertices.clear();
+    addRect(PANEL_X - 4.0f, PANEL_Y - 4.0f, PANEL_WIDTH + 8.0f, timelineHeight + GRAPH_HEIGHT + 14.0f, BACKGROUND);
+
+    // Linha do tempo do último quadro (escopos além da largura são cortados)
+    auto addScopes = [&](const vector<ProfileScopeTime>& scopes, int rows, float top) {
+        for (const ProfileScopeTime& scope : scopes) {
+            if ((int)scope.depth >= rows || scope.start >= PANEL_MILLISECONDS)
+                continue;
+            float x = PANEL_X + std::max(0.0f, (float)scope.start) * pixelsPerMillisecond;
+            float width = std::min((float)scope.duration * pixelsPerMillisecond, PANEL_X + PANEL_WIDTH - x);
+            addRect(x, top + scope.depth * ROW_HEIGHT, std::max(width, 1.0f), ROW_HEIGHT - 1.0f,
+                    PALETTE[paletteIndex(scope.name)]);
+        }
+    };
+    addScopes(frame.cpu, CPU_ROWS, PANEL_Y);
+    addScopes(frame.gpu, GPU_ROWS, PANEL_Y + CPU_ROWS * ROW_HEIGHT + 4.0f);
+    addRect(PANEL_X + 1000.0f / 60.0f * pixelsPerMillisecond, PANEL_Y, 1.0f, timelineHeight, MARKER);
+
+    // Histórico: uma coluna por quadro, a mais recente à direita
+    const float barWidth = PANEL_WIDTH / HISTORY;
+    const float pixelsPerMillisecondY = GRAPH_HEIGHT / PANEL_MILLISECONDS;
+    for (int i = 0; i < HISTORY; ++i) {
+        int sample = (historyNext + i) % HISTORY;
+        float x = PANEL_X + i * barWidth;
+        float cpu = std::min(cpuHistory[sample] * pixelsPerMillisecondY, GRAPH_HEIGHT);
+        float gpu = std::min(gpuHistory[sample] * pixelsPerMillisecondY, GRAPH_HEIGHT);
+        addRect(x, graphY + GRAPH_HEIGHT - cpu, barWidth - 1.0f, cpu, CPU_BAR);
+        addRect(x + barWidth * 0.5f, graphY + GRAPH_HEIGHT - gpu, barWidth * 0.5f - 1.0f, gpu, GPU_BAR);
+    }
+    addRect(PANEL_X, graphY + GRAPH_HEIGHT - 1000.0f / 60.0f * pixelsPerMillisecondY, PANEL_WIDTH, 1.0f, MARKER);
+
+    GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    GLboolean blend = glIsEnabled(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glUseProgram(program);
+    glUniform2f(screenLocation, (float)screenWidth, (float)screenHeight);
+    glBindVertexArray(vertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STREAM_DRAW);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(vertices.size() / 6));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    FrameProfiler::count(PROFILE_DRAW_CALLS, 1);
+    FrameProfiler::count(PROFILE_UPLOAD_BYTES, vertices.size() * sizeof(float));
+
+    if (depthTest)
+        glEnable(GL_DEPTH_TEST);
+    if (!blend)
+        glDisable(GL_BLEND);
+}
+
+void ProfilerOverlay::printLegend() const
+{
+    const ProfileFrame& frame = FrameProfiler::lastFrame();
+    cout << "Perfil do quadro " << frame.index << ": CPU " << frame.cpuMilliseconds << " ms, GPU "
+         << frame.gpuMilliseconds << " ms" << endl;
+    for (const ProfileScopeTime& scope : frame.cpu)
+        cout << "  CPU " << string(scope.depth * 2, ' ') << scope.name << " (" << PALETTE_NAMES[paletteIndex(scope.name)]
+             << "): " << scope.duration << " ms" << endl;
+    for (const ProfileScopeTime& scope : frame.gpu)
+        cout << "  GPU " << string(scope.depth * 2, ' ') << scope.name << " (" << PALETTE_NAMES[paletteIndex(scope.name)]
+             << "): " << scope.duration << " ms" << endl;
+    for (int c = 0; c < PROFILE_COUNTER_COUNT; ++c)
+        cout << "  " << profileCounterName((ProfileCounter)c) << ": " << frame.counters[c] << endl;
+}
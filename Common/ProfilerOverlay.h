@@ -0,0 +1,43 @@
+/* Sobreposição do profiler na tela
+ *
+ * Desenha o último quadro do FrameProfiler no canto superior esquerdo, sem texto:
+ *  - a linha do tempo do quadro: uma faixa por nível de escopo da CPU (thread
+ *    principal) e outras para a GPU, cada escopo com a cor do seu nome; a largura toda
+ *    é 33,3 ms e a marca branca fica em 16,7 ms (60 quadros/s);
+ *  - o histórico dos últimos quadros: CPU em azul e GPU em laranja, na mesma escala.
+ * Os nomes e os valores das cores aparecem com printLegend().
+ */
+
+#ifndef PROFILER_OVERLAY_H
+#define PROFILER_OVERLAY_H
+
+#include <vector>
+
+#include <glad/glad.h>
+
+class ProfilerOverlay {
+public:
+    // Com o contexto OpenGL ativo
+    bool init();
+    void release();
+
+    // Desenha por cima do que está no framebuffer (sem profundidade, com transparência)
+    void draw(int screenWidth, int screenHeight);
+
+    // Escreve no terminal os escopos do último quadro, com a cor e o tempo de cada um
+    void printLegend() const;
+
+private:
+    static const int HISTORY = 120;
+
+    void addRect(float x, float y, float width, float height, const float color[4]);
+
+    GLuint program = 0, vertexArray = 0, buffer = 0;
+    GLint screenLocation = -1;
+    std::vector<float> vertices; // x, y, r, g, b, a por vértice, reaproveitado entre quadros
+    float cpuHistory[HISTORY] = {};
+    float gpuHistory[HISTORY] = {};
+    int historyNext = 0;
+};
+
+#endif
@@ -0,0 +1,81 @@
+/* Rotações em quatérnios e conversão em lote para matrizes - implementação
+ * Ver QuatMatrix.h
+ */
+
+#include "QuatMatrix.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QUAT_MATRIX_SSE 1
+#include <emmintrin.h>
+#endif
+
+using namespace glm;
+
+quat quatFromEulerDegrees(const vec3& degrees)
+{
+    vec3 r = radians(degrees);
+    return angleAxis(r.x, vec3(1.0f, 0.0f, 0.0f)) *
+           angleAxis(r.y, vec3(0.0f, 1.0f, 0.0f)) *
+           angleAxis(r.z, vec3(0.0f, 0.0f, 1.0f));
+}
+
+// Mesmas fórmulas do mat3_cast do glm
+static inline mat4 rigidMatrixOf(const quat& q, const vec3& position)
+{
+    float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+    return mat4(vec4(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f),
+                vec4(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f),
+                vec4(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f),
+                vec4(position, 1.0f));
+}
+
+void composeRigidMatricesScalar(const quat* rotations, const vec3* positions, mat4* matrices, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        matrices[i] = rigidMatrixOf(rotations[i], positions[i]);
+}
+
+void composeRigidMatrices(const quat* rotations, const vec3* positions, mat4* matrices, size_t count)
+{
+    size_t i = 0;
+#ifdef QUAT_MATRIX_SSE
+    const __m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f), zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        // glm::quat guarda x, y, z, w nessa ordem
+        __m128 x = _mm_loadu_ps(&rotations[i + 0].x);
+        __m128 y = _mm_loadu_ps(&rotations[i + 1].x);
+        __m128 z = _mm_loadu_ps(&rotations[i + 2].x);
+        __m128 w = _mm_loadu_ps(&rotations[i + 3].x);
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+
+        __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+        __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+        __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+        // Elementos das colunas 0, 1 e 2 (linha 3 = 0) das 4 matrizes
+        __m128 c[3][4] = {
+            { _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), _mm_mul_ps(two, _mm_add_ps(xy, wz)),
+              _mm_mul_ps(two, _mm_sub_ps(xz, wy)), zero },
+            { _mm_mul_ps(two, _mm_sub_ps(xy, wz)), _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))),
+              _mm_mul_ps(two, _mm_add_ps(yz, wx)), zero },
+            { _mm_mul_ps(two, _mm_add_ps(xz, wy)), _mm_mul_ps(two, _mm_sub_ps(yz, wx)),
+              _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), zero },
+        };
+
+        // Volta para uma coluna por registrador (transposta 4x4) e grava
+        for (int col = 0; col < 3; ++col) {
+            _MM_TRANSPOSE4_PS(c[col][0], c[col][1], c[col][2], c[col][3]);
+            for (int m = 0; m < 4; ++m)
+                _mm_storeu_ps(&matrices[i + m][col][0], c[col][m]);
+        }
+        for (int m = 0; m < 4; ++m) {
+            const vec3& p = positions[i + m];
+            _mm_storeu_ps(&matrices[i + m][3][0], _mm_set_ps(1.0f, p.z, p.y, p.x));
+        }
+    }
+#endif
+    // Restante (ou tudo, sem SSE)
+    composeRigidMatricesScalar(rotations + i, positions + i, matrices + i, count - i);
+}
@@ -0,0 +1,31 @@
+/* Rotações em quatérnios e conversão em lote para matrizes
+ *
+ * Antes a rotação de cada objeto ficava em três ângulos de Euler (graus) e virava
+ * matriz com três glm::rotate por objeto por quadro (seis senos/cossenos e duas
+ * multiplicações de matrizes). Com quatérnios a rotação incremental das teclas
+ * X/Y/Z é uma multiplicação de quatérnios e a matriz sai de produtos simples,
+ * sem trigonometria, só quando o objeto muda.
+ *
+ * A versão SSE converte 4 quatérnios por vez: os 4 são lidos e transpostos para
+ * que cada registrador tenha a mesma componente (x, y, z ou w) dos 4.
+ */
+
+#ifndef QUAT_MATRIX_H
+#define QUAT_MATRIX_H
+
+#include <cstddef>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Quatérnio equivalente a Rx * Ry * Rz com os ângulos em graus (ordem usada nos arquivos de cena)
+glm::quat quatFromEulerDegrees(const glm::vec3& degrees);
+
+// Calcula matrices[i] = T(positions[i]) * R(rotations[i]), i em [0, count).
+// Os quatérnios devem estar normalizados
+void composeRigidMatrices(const glm::quat* rotations, const glm::vec3* positions, glm::mat4* matrices, size_t count);
+
+// Mesma conta sem SIMD, uma matriz por vez (referência e fallback)
+void composeRigidMatricesScalar(const glm::quat* rotations, const glm::vec3* positions, glm::mat4* matrices, size_t count);
+
+#endif
@@ -0,0 +1,319 @@
+/* Configuração de cena lida de arquivo texto - implementação
+ * Ver SceneConfig.h
+ */
+
+#include "SceneConfig.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "FrameProfiler.h"
+
+using namespace std;
+using namespace glm;
+
+// Includes aninhados além disso são tratados como ciclo
+static const int MAX_INCLUDE_DEPTH = 16;
+
+StringId SceneConfig::objectId(const string& name)
+{
+    StringId id = objectNames.intern(name);
+    if (id >= objects.size())
+        objects.resize(id + 1);
+    return id;
+}
+
+StringId SceneConfig::prefabId(const string& name)
+{
+    StringId id = prefabNames.intern(name);
+    if (id >= prefabs.size())
+        prefabs.resize(id + 1);
+    return id;
+}
+
+StringId SceneConfig::arrayId(const string& name)
+{
+    StringId id = arrayNames.intern(name);
+    if (id >= arrays.size())
+        arrays.resize(id + 1);
+    return id;
+}
+
+void SceneConfig::clear()
+{
+    objectNames.clear();
+    objects.clear();
+    prefabNames.clear();
+    prefabs.clear();
+    arrayNames.clear();
+    arrays.clear();
+    camera = CameraConfig();
+    light = LightConfig();
+    files.clear();
+}
+
+// Lê até count números separados por espaços (strtof, sem istringstream: as cenas
+// grandes têm uma linha por instância); retorna quantos foram lidos
+static int parseFloats(const char* text, float* values, int count)
+{
+    int parsed = 0;
+    for (; parsed < count; ++parsed) {
+        char* end;
+        values[parsed] = strtof(text, &end);
+        if (end == text)
+            break;
+        text = end;
+    }
+    return parsed;
+}
+
+static bool parseVec3(const char* text, vec3& out)
+{
+    float values[3];
+    if (parseFloats(text, values, 3) != 3)
+        return false;
+    out = vec3(values[0], values[1], values[2]);
+    return true;
+}
+
+// Aplica uma propriedade de object.X ou prefab.X a configs[index] (scene.objects ou
+// scene.prefabs). Usa o índice de novo depois de cada objectId, que pode mudar
+// scene.objects de lugar. prefix é o do include em que a linha está
+static void setObjectProperty(SceneConfig& scene, vector<ObjectConfig>& configs, size_t index, const string& prop,
+                              const string& value, const string& key, const string& prefix)
+{
+    if (prop == "file") {
+        configs[index].objFile = value;
+    }
+    else if (prop == "mtl") {
+        configs[index].mtlFile = value;
+    }
+    else if (prop == "texture" || prop == "texture.body") {
+        configs[index].textureFile = value;
+    }
+    else if (prop == "texture.alpha" || prop == "texture.eye") {
+        configs[index].alphaTextureFile = value;
+    }
+    else if (prop == "position" || prop == "rotation" || prop == "scale") {
+        ObjectConfig& cfg = configs[index];
+        vec3& target = prop == "position" ? cfg.position : prop == "rotation" ? cfg.rotation : cfg.scale;
+        if (!parseVec3(value.c_str(), target))
+            cout << "Vetor invalido: " << key << " = " << value << endl;
+    }
+    else if (prop == "parent") {
+        // O pai pode ser declarado depois: já reserva o id
+        StringId parentId = scene.objectId(prefix + value);
+        configs[index].parent = parentId;
+    }
+    else if (prop == "animation") {
+        if (value == "orbit")
+            configs[index].animation = ANIMATION_ORBIT;
+        else if (value == "none")
+            configs[index].animation = ANIMATION_NONE;
+        else
+            cout << "Animacao desconhecida: " << key << " = " << value << endl;
+    }
+    else if (prop == "orbit.target") {
+        StringId targetId = scene.objectId(prefix + value);
+        configs[index].orbitTarget = targetId;
+    }
+    else if (prop == "orbit.radius") {
+        configs[index].orbitRadius = strtof(value.c_str(), nullptr);
+    }
+    else if (prop == "orbit.speed") {
+        configs[index].orbitSpeed = strtof(value.c_str(), nullptr);
+    }
+    else if (prop.compare(0, 6, "track.") == 0) {
+        TrackConfig track;
+        track.target = trackTargetFromName(prop.substr(6));
+        if (track.target == TRACK_TARGET_COUNT || !parseTrackKeys(value, track.target, track.times, track.values))
+            cout << "Trilha de animacao invalida: " << key << endl;
+        else
+            configs[index].tracks.push_back(track);
+    }
+    else if (prop == "prefab") {
+        // Os prefabs não têm prefixo: um arquivo de prefabs incluído serve a cena toda
+        StringId prefab = scene.prefabNames.find(value);
+        if (prefab == INVALID_STRING_ID)
+            cout << "Prefab desconhecido (declarar antes de usar): " << key << " = " << value << endl;
+        else
+            configs[index] = scene.prefabs[prefab];
+    }
+    else {
+        cout << "Propriedade desconhecida: " << key << endl;
+    }
+}
+
+// Cria a próxima instância do vetor ("A[i]") com a configuração dada
+static void addInstance(SceneConfig& scene, const string& arrayName, InstanceArrayConfig& array,
+                        const ObjectConfig& config)
+{
+    StringId id = scene.objectId(arrayName + "[" + to_string(array.count++) + "]");
+    scene.objects[id] = config;
+}
+
+static void setArrayProperty(SceneConfig& scene, const string& arrayName, const string& prop,
+                             const string& value, const string& key)
+{
+    InstanceArrayConfig& array = scene.arrays[scene.arrayId(arrayName)];
+    if (prop == "prefab") {
+        array.prefab = scene.prefabNames.find(value);
+        if (array.prefab == INVALID_STRING_ID)
+            cout << "Prefab desconhecido (declarar antes de usar): " << key << " = " << value << endl;
+    }
+    else if (prop == "origin" || prop == "spacing") {
+        if (!parseVec3(value.c_str(), prop == "origin" ? array.origin : array.spacing))
+            cout << "Vetor invalido: " << key << " = " << value << endl;
+    }
+    else if (prop == "instance") {
+        // posição [; rotação [; escala]]; sem rotação ou escala, ficam as do prefab
+        ObjectConfig instance = array.prefab != INVALID_STRING_ID ? scene.prefabs[array.prefab] : ObjectConfig();
+        vec3* targets[3] = { &instance.position, &instance.rotation, &instance.scale };
+        const char* text = value.c_str();
+        for (int group = 0; group < 3 && text; ++group) {
+            float values[3];
+            int parsed = parseFloats(text, values, 3);
+            if (parsed == 3) {
+                *targets[group] = vec3(values[0], values[1], values[2]);
+            }
+            else if (parsed != 0 || group == 0) {
+                cout << "Instancia invalida: " << key << " = " << value << endl;
+                return;
+            }
+            text = strchr(text, ';');
+            if (text)
+                ++text;
+        }
+        instance.position += array.origin;
+        addInstance(scene, arrayName, array, instance);
+    }
+    else if (prop == "grid") {
+        float counts[3];
+        if (parseFloats(value.c_str(), counts, 3) != 3 || counts[0] < 0 || counts[1] < 0 || counts[2] < 0) {
+            cout << "Grade invalida: " << key << " = " << value << endl;
+            return;
+        }
+        ObjectConfig instance = array.prefab != INVALID_STRING_ID ? scene.prefabs[array.prefab] : ObjectConfig();
+        for (int z = 0; z < (int)counts[2]; ++z)
+            for (int y = 0; y < (int)counts[1]; ++y)
+                for (int x = 0; x < (int)counts[0]; ++x) {
+                    instance.position = array.origin + array.spacing * vec3((float)x, (float)y, (float)z);
+                    addInstance(scene, arrayName, array, instance);
+                }
+    }
+    else {
+        cout << "Propriedade desconhecida: " << key << endl;
+    }
+}
+
+// Lê um arquivo de cena (o principal ou um include) com os nomes prefixados por prefix
+static bool parseSceneFile(const string& configFile, SceneConfig& scene, const string& prefix, int depth)
+{
+    ifstream file(configFile);
+    if (!file.is_open()) {
+        cout << "Erro ao abrir arquivo de configuração: " << configFile << endl;
+        return false;
+    }
+    string directory = filesystem::path(configFile).parent_path().string();
+    scene.files.push_back(configFile);
+
+    string line;
+    string key, value;
+    while (getline(file, line)) {
+        // Ignora linhas vazias e comentários
+        size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == string::npos || line[begin] == '#') continue;
+
+        // Divide a linha em chave e valor, sem os espaços em branco das pontas
+        size_t separatorPos = line.find('=', begin);
+        if (separatorPos == string::npos || separatorPos == begin) continue;
+        size_t keyEnd = line.find_last_not_of(" \t", separatorPos - 1);
+        size_t valueBegin = line.find_first_not_of(" \t", separatorPos + 1);
+        size_t valueEnd = line.find_last_not_of(" \t\r");
+        key.assign(line, begin, keyEnd + 1 - begin);
+        if (valueBegin == string::npos || valueBegin > valueEnd)
+            value.clear();
+        else
+            value.assign(line, valueBegin, valueEnd + 1 - valueBegin);
+
+        // Processa valores baseado na chave
+        if (key.compare(0, 7, "object.") == 0 || key.compare(0, 7, "prefab.") == 0) {
+            // Extrai o nome do objeto (ou prefab) e a propriedade
+            size_t dotPos = key.find('.', 7);
+            if (dotPos == string::npos) continue;
+            string name = key.substr(7, dotPos - 7);
+            string prop = key.substr(dotPos + 1);
+
+            if (key[0] == 'o') {
+                StringId objId = scene.objectId(prefix + name);
+                setObjectProperty(scene, scene.objects, objId, prop, value, key, prefix);
+            }
+            else {
+                StringId prefabId = scene.prefabId(name);
+                setObjectProperty(scene, scene.prefabs, prefabId, prop, value, key, prefix);
+            }
+        }
+        else if (key.compare(0, 6, "array.") == 0) {
+            size_t dotPos = key.find('.', 6);
+            if (dotPos == string::npos) continue;
+            setArrayProperty(scene, prefix + key.substr(6, dotPos - 6), key.substr(dotPos + 1), value, key);
+        }
+        else if (key == "include" || key.compare(0, 8, "include.") == 0) {
+            string includePrefix = key.size() > 8 ? prefix + key.substr(8) + "/" : prefix;
+            filesystem::path path(value);
+            if (path.is_relative())
+                path = filesystem::path(directory) / path;
+            if (depth >= MAX_INCLUDE_DEPTH) {
+                cout << "Includes aninhados demais (ciclo?): " << path.string() << endl;
+                return false;
+            }
+            if (!parseSceneFile(path.string(), scene, includePrefix, depth + 1))
+                return false;
+        }
+        else if (key.compare(0, 7, "camera.") == 0) {
+            string camProp = key.substr(7);
+
+            if (camProp == "position") {
+                parseVec3(value.c_str(), scene.camera.position);
+            }
+            else if (camProp == "yaw") {
+                scene.camera.yaw = strtof(value.c_str(), nullptr);
+            }
+            else if (camProp == "pitch") {
+                scene.camera.pitch = strtof(value.c_str(), nullptr);
+            }
+            else if (camProp == "fov") {
+                scene.camera.fov = strtof(value.c_str(), nullptr);
+            }
+            else if (camProp == "near") {
+                scene.camera.nearPlane = strtof(value.c_str(), nullptr);
+            }
+            else if (camProp == "far") {
+                scene.camera.farPlane = strtof(value.c_str(), nullptr);
+            }
+        }
+        else if (key.compare(0, 6, "light.") == 0) {
+            string lightProp = key.substr(6);
+
+            if (lightProp == "position") {
+                parseVec3(value.c_str(), scene.light.position);
+            }
+            else if (lightProp == "color") {
+                parseVec3(value.c_str(), scene.light.color);
+            }
+        }
+    }
+
+    file.close();
+    return true;
+}
+
+// Função para carregar o arquivo de configuração
+bool loadSceneConfig(const string& configFile, SceneConfig& scene)
+{
+    PROFILE_SCOPE("loadSceneConfig");
+    return parseSceneFile(configFile, scene, "", 0);
+}
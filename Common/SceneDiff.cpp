@@ -0,0 +1,147 @@
+/* Diferença entre duas versões de uma cena compilada - implementação
+ * Ver SceneDiff.h
+ */
+
+#include "SceneDiff.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+#include "FrameProfiler.h"
+
+using namespace std;
+
+size_t SceneDiff::count(SceneOpKind kind) const
+{
+    size_t total = 0;
+    for (const SceneOp& op : ops)
+        total += op.kind == kind ? 1 : 0;
+    return total;
+}
+
+void SceneDiff::clear()
+{
+    ops.clear();
+    matches.clear();
+    lightChanged = false;
+    unchanged = 0;
+}
+
+// Textos iguais (as tabelas de strings das duas cenas são independentes)
+static bool sameString(const CompiledScene& before, uint32_t a, const CompiledScene& after, uint32_t b)
+{
+    if (a == SCENE_NONE || b == SCENE_NONE)
+        return a == b;
+    return strcmp(before.str(a), after.str(b)) == 0;
+}
+
+// Objeto citado (pai ou alvo da órbita) com o mesmo nome nas duas cenas
+static bool sameObject(const CompiledScene& before, uint32_t a, const CompiledScene& after, uint32_t b)
+{
+    if (a == SCENE_NONE || b == SCENE_NONE)
+        return a == b;
+    return sameString(before, before.object(a).name, after, after.object(b).name);
+}
+
+static bool sameTracks(const CompiledScene& before, const SceneObjectRecord& a,
+                       const CompiledScene& after, const SceneObjectRecord& b)
+{
+    if (a.trackCount != b.trackCount)
+        return false;
+    for (uint32_t t = 0; t < a.trackCount; ++t) {
+        const SceneTrackRecord& trackA = before.track(a.firstTrack + t);
+        const SceneTrackRecord& trackB = after.track(b.firstTrack + t);
+        if (trackA.target != trackB.target || trackA.keyCount != trackB.keyCount ||
+            memcmp(before.keyTimes(trackA), after.keyTimes(trackB), trackA.keyCount * sizeof(float)) != 0 ||
+            memcmp(before.keyValues(trackA), after.keyValues(trackB), trackA.keyCount * sizeof(glm::vec4)) != 0)
+            return false;
+    }
+    return true;
+}
+
+// Máscara SceneChange do que difere entre o objeto a de before e o b de after
+static uint32_t objectChanges(const CompiledScene& before, uint32_t a, const CompiledScene& after, uint32_t b)
+{
+    const SceneObjectRecord& x = before.object(a);
+    const SceneObjectRecord& y = after.object(b);
+    uint32_t changes = 0;
+    if (memcmp(x.position, y.position, sizeof(x.position)) != 0 ||
+        memcmp(x.rotation, y.rotation, sizeof(x.rotation)) != 0 || memcmp(x.scale, y.scale, sizeof(x.scale)) != 0)
+        changes |= SCENE_CHANGE_TRANSFORM;
+    if (!sameString(before, x.mtlFile, after, y.mtlFile) || !sameString(before, x.textureFile, after, y.textureFile) ||
+        !sameString(before, x.alphaTextureFile, after, y.alphaTextureFile))
+        changes |= SCENE_CHANGE_MATERIAL;
+    if (!sameString(before, x.objFile, after, y.objFile))
+        changes |= SCENE_CHANGE_MESH;
+    if (x.animation != y.animation || x.orbitRadius != y.orbitRadius || x.orbitSpeed != y.orbitSpeed ||
+        !sameTracks(before, x, after, y))
+        changes |= SCENE_CHANGE_ANIMATION;
+    if (!sameObject(before, x.parent, after, y.parent) || !sameObject(before, x.orbitTarget, after, y.orbitTarget))
+        changes |= SCENE_CHANGE_PARENT;
+    return changes;
+}
+
+bool diffScenes(const CompiledScene& before, const CompiledScene& after, SceneDiff& diff)
+{
+    PROFILE_SCOPE("diffScenes");
+    diff.clear();
+    size_t beforeCount = before.objectCount(), afterCount = after.objectCount();
+    for (size_t i = 0; i < afterCount; ++i)
+        if (!after.validObject(i))
+            return false;
+
+    // Casamento pela posição: sem objetos inseridos ou removidos antes, os nomes coincidem
+    diff.matches.assign(afterCount, SCENE_NONE);
+    vector<uint8_t> matched(beforeCount, 0);
+    size_t common = std::min(beforeCount, afterCount);
+    size_t unmatched = 0;
+    for (size_t i = 0; i < common; ++i) {
+        if (sameString(before, before.object(i).name, after, after.object(i).name)) {
+            diff.matches[i] = (uint32_t)i;
+            matched[i] = 1;
+        }
+        else {
+            ++unmatched;
+        }
+    }
+
+    // Os demais pelo nome (a tabela só tem os objetos que ainda não casaram)
+    if (unmatched > 0 || beforeCount != afterCount) {
+        unordered_map<string_view, uint32_t> byName;
+        byName.reserve(beforeCount - (common - unmatched));
+        for (size_t i = 0; i < beforeCount; ++i)
+            if (!matched[i])
+                byName.emplace(before.str(before.object(i).name), (uint32_t)i);
+        for (size_t i = 0; i < afterCount; ++i) {
+            if (diff.matches[i] != SCENE_NONE)
+                continue;
+            auto it = byName.find(after.str(after.object(i).name));
+            if (it == byName.end())
+                continue;
+            diff.matches[i] = it->second;
+            matched[it->second] = 1;
+            byName.erase(it);
+        }
+    }
+
+    for (size_t i = 0; i < afterCount; ++i) {
+        uint32_t previous = diff.matches[i];
+        if (previous == SCENE_NONE) {
+            diff.ops.push_back(SceneOp{ SCENE_OP_ADD, SCENE_NONE, (uint32_t)i, SCENE_CHANGE_ALL });
+            continue;
+        }
+        uint32_t changes = objectChanges(before, previous, after, (uint32_t)i);
+        if (changes == 0)
+            ++diff.unchanged;
+        else
+            diff.ops.push_back(SceneOp{ SCENE_OP_UPDATE, previous, (uint32_t)i, changes });
+    }
+    for (size_t i = 0; i < beforeCount; ++i)
+        if (!matched[i])
+            diff.ops.push_back(SceneOp{ SCENE_OP_REMOVE, (uint32_t)i, SCENE_NONE, SCENE_CHANGE_ALL });
+
+    diff.lightChanged = before.light.position != after.light.position || before.light.color != after.light.color;
+    return true;
+}
@@ -0,0 +1,66 @@
+/* Diferença entre duas versões de uma cena compilada
+ *
+ * Os objetos são identificados pelo nome ("moon", "anel[3]", "b/sol" de um include),
+ * que é estável entre edições do arquivo, e não pela posição: inserir uma linha no
+ * meio da cena não muda a identidade dos objetos seguintes.
+ *
+ * diffScenes() casa os objetos das duas versões (primeiro na mesma posição, que é o
+ * caso comum; os demais por uma tabela de nomes) e gera o mínimo de operações:
+ *
+ *     SCENE_OP_ADD     objeto novo
+ *     SCENE_OP_REMOVE  objeto que saiu da cena
+ *     SCENE_OP_UPDATE  objeto alterado, com a máscara SceneChange do que mudou
+ *                      (só transformação, só material, troca de malha, ...)
+ *
+ * Objetos iguais não geram operação: quem aplica a diferença (TrabalhoGB, na recarga
+ * da cena) mexe só nas entidades citadas. A comparação é uma passada linear pelos
+ * registros, sem carregar malhas nem texturas.
+ */
+
+#ifndef SCENE_DIFF_H
+#define SCENE_DIFF_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CompiledScene.h"
+
+// O que mudou em um objeto (máscara de bits)
+enum SceneChange : uint32_t {
+    SCENE_CHANGE_TRANSFORM = 1u << 0, // posição, rotação ou escala
+    SCENE_CHANGE_MATERIAL  = 1u << 1, // MTL ou texturas
+    SCENE_CHANGE_MESH      = 1u << 2, // arquivo OBJ
+    SCENE_CHANGE_ANIMATION = 1u << 3, // tipo, parâmetros da órbita ou trilhas
+    SCENE_CHANGE_PARENT    = 1u << 4, // pai ou alvo da órbita (pelo nome)
+    SCENE_CHANGE_ALL       = 0x1Fu,
+};
+
+enum SceneOpKind : uint8_t {
+    SCENE_OP_ADD,
+    SCENE_OP_REMOVE,
+    SCENE_OP_UPDATE,
+};
+
+struct SceneOp {
+    SceneOpKind kind;
+    uint32_t before;  // índice do objeto na cena anterior (SCENE_NONE em ADD)
+    uint32_t after;   // índice do objeto na cena nova (SCENE_NONE em REMOVE)
+    uint32_t changes; // SceneChange; SCENE_CHANGE_ALL em ADD e REMOVE
+};
+
+struct SceneDiff {
+    std::vector<SceneOp> ops;          // ADD e UPDATE na ordem da cena nova, depois os REMOVE
+    std::vector<uint32_t> matches;     // para cada objeto da cena nova, o índice na anterior (SCENE_NONE = novo)
+    bool lightChanged = false;
+    size_t unchanged = 0;              // objetos casados sem mudança
+
+    size_t count(SceneOpKind kind) const;
+    void clear();
+};
+
+// Compara a cena nova (after) com a anterior (before). false se after tem um objeto
+// inválido (validObject): a diferença não deve ser aplicada
+bool diffScenes(const CompiledScene& before, const CompiledScene& after, SceneDiff& diff);
+
+#endif
@@ -0,0 +1,316 @@
+/* Geração procedural de cenas grandes - implementação
+ * Ver SceneGenerator.h
+ */
+
+#include "SceneGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <random>
+#include <tuple>
+
+#include "CompiledScene.h"
+#include "HeadlessContext.h"
+
+using namespace std;
+
+// Malhas dos assets: OBJ, MTL e textura relativos à pasta de assets
+struct AssetMesh {
+    const char* name;
+    const char* objFile;
+    const char* mtlFile;
+    const char* textureFile;
+    uint64_t triangles;
+};
+
+static const AssetMesh ASSET_MESHES[] = {
+    { "moon", "Modelos3D/moon.obj", "Modelos3D/moon.mtl", "tex/moon_diffuse.png", 780 },
+    { "mars", "Modelos3D/mars.obj", "Modelos3D/mars.mtl", "tex/mars_diffuse.png", 3084 },
+    { "suzanne", "Modelos3D/Suzanne.obj", "Modelos3D/Suzanne.mtl", "Modelos3D/Suzanne.png", 967 },
+    { "cube", "Modelos3D/Cube.obj", "Modelos3D/Cube.mtl", "tex/pixelWall.png", 12 },
+};
+
+// Malha resolvida para a cena: caminhos já completos
+struct SceneMesh {
+    string objFile, mtlFile, textureFile;
+    uint64_t triangles;
+};
+
+// Texto gravado em blocos de 1 MB (cenas com milhões de objetos têm gigabytes)
+class TextWriter {
+public:
+    explicit TextWriter(FILE* file) : file(file) { buffer.reserve(CHUNK + 1024); }
+
+    void line(const char* format, ...);
+
+    bool finish()
+    {
+        flush();
+        return !failed;
+    }
+
+    uint64_t bytes = 0;
+
+private:
+    static const size_t CHUNK = 1 << 20;
+
+    void flush()
+    {
+        if (!buffer.empty() && fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size())
+            failed = true;
+        bytes += buffer.size();
+        buffer.clear();
+    }
+
+    FILE* file;
+    string buffer;
+    bool failed = false;
+};
+
+void TextWriter::line(const char* format, ...)
+{
+    char text[1024];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    buffer.append(text, std::min((size_t)std::max(length, 0), sizeof(text) - 1));
+    buffer.push_back('\n');
+    if (buffer.size() >= CHUNK)
+        flush();
+}
+
+uint64_t writeSphereOBJ(const string& path, uint64_t triangleCount)
+{
+    uint64_t slices = std::max<uint64_t>(3, (uint64_t)sqrt(triangleCount / 2.0));
+    uint64_t stacks = std::max<uint64_t>(2, triangleCount / (2 * slices));
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file)
+        return 0;
+    TextWriter writer(file);
+    writer.line("# Esfera UV gerada: %llu x %llu", (unsigned long long)stacks, (unsigned long long)slices);
+    for (uint64_t stack = 0; stack <= stacks; ++stack) {
+        double phi = 3.14159265358979 * stack / stacks;
+        for (uint64_t slice = 0; slice <= slices; ++slice) {
+            double theta = 6.28318530717959 * slice / slices;
+            writer.line("v %.5f %.5f %.5f", sin(phi) * cos(theta), cos(phi), sin(phi) * sin(theta));
+            writer.line("vt %.5f %.5f", (double)slice / slices, 1.0 - (double)stack / stacks);
+        }
+    }
+    for (uint64_t stack = 0; stack < stacks; ++stack) {
+        for (uint64_t slice = 0; slice < slices; ++slice) {
+            unsigned long long a = stack * (slices + 1) + slice + 1, b = a + slices + 1;
+            writer.line("f %llu/%llu %llu/%llu %llu/%llu", a, a, b, b, a + 1, a + 1);
+            writer.line("f %llu/%llu %llu/%llu %llu/%llu", a + 1, a + 1, b, b, b + 1, b + 1);
+        }
+    }
+    bool ok = writer.finish();
+    ok = fclose(file) == 0 && ok;
+    return ok ? 2 * stacks * slices : 0;
+}
+
+bool writePatternTexture(const string& path, int size, uint32_t seed)
+{
+    mt19937 rng(seed);
+    uniform_int_distribution<int> channel(40, 255);
+    uint8_t colors[2][3];
+    for (auto& color : colors)
+        for (uint8_t& c : color)
+            c = (uint8_t)channel(rng);
+    int cell = std::max(1, size / 8);
+    vector<uint8_t> rgb((size_t)size * size * 3);
+    for (int y = 0; y < size; ++y)
+        for (int x = 0; x < size; ++x) {
+            const uint8_t* color = colors[((x / cell) + (y / cell)) & 1];
+            uint8_t* pixel = &rgb[((size_t)y * size + x) * 3];
+            pixel[0] = color[0];
+            pixel[1] = color[1];
+            pixel[2] = color[2];
+        }
+    return writeFrameImage(path, size, size, rgb);
+}
+
+static bool writeMaterial(const string& path, mt19937& rng)
+{
+    uniform_real_distribution<float> unit(0.0f, 1.0f);
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+    float kd[3] = { 0.3f + 0.7f * unit(rng), 0.3f + 0.7f * unit(rng), 0.3f + 0.7f * unit(rng) };
+    float ks = 0.1f + 0.8f * unit(rng);
+    fprintf(file, "# Material gerado\nnewmtl Gerado\n");
+    fprintf(file, "Ns %.1f\n", 8.0f + 248.0f * unit(rng));
+    fprintf(file, "Ka %.3f %.3f %.3f\n", 0.2f + 0.8f * unit(rng), 0.2f + 0.8f * unit(rng), 0.2f + 0.8f * unit(rng));
+    fprintf(file, "Kd %.3f %.3f %.3f\n", kd[0], kd[1], kd[2]);
+    fprintf(file, "Ks %.3f %.3f %.3f\n", ks, ks, ks);
+    return fclose(file) == 0;
+}
+
+bool generateScene(const string& outputDir, const string& sceneName, const SceneGeneratorOptions& options,
+                   GeneratedScene* result)
+{
+    GeneratedScene generated;
+    error_code error;
+    filesystem::create_directories(outputDir, error);
+    if (error) {
+        cout << "Nao foi possivel criar " << outputDir << endl;
+        return false;
+    }
+    string assets = options.assets.empty() ? "." : options.assets;
+    mt19937 rng(options.seed);
+    uniform_real_distribution<float> unit(0.0f, 1.0f);
+    normal_distribution<float> gaussian(0.0f, 1.0f);
+
+    // Malhas: dos assets ou esferas geradas ("esfera:T")
+    vector<SceneMesh> meshes;
+    for (const string& name : options.meshes) {
+        if (name.compare(0, 7, "esfera:") == 0) {
+            uint64_t requested = strtoull(name.c_str() + 7, nullptr, 10);
+            filesystem::create_directories(outputDir + "/malhas", error);
+            SceneMesh mesh;
+            mesh.objFile = outputDir + "/malhas/esfera_" + to_string(requested) + ".obj";
+            mesh.mtlFile = assets + "/" + ASSET_MESHES[0].mtlFile;
+            mesh.textureFile = assets + "/" + ASSET_MESHES[0].textureFile;
+            mesh.triangles = writeSphereOBJ(mesh.objFile, requested);
+            if (mesh.triangles == 0) {
+                cout << "Nao foi possivel gravar " << mesh.objFile << endl;
+                return false;
+            }
+            generated.meshFiles++;
+            meshes.push_back(mesh);
+            continue;
+        }
+        const AssetMesh* asset = nullptr;
+        for (const AssetMesh& candidate : ASSET_MESHES)
+            if (name == candidate.name)
+                asset = &candidate;
+        if (!asset) {
+            cout << "Malha desconhecida: " << name << " (moon, mars, suzanne, cube ou esfera:T)" << endl;
+            return false;
+        }
+        meshes.push_back({ assets + "/" + asset->objFile, assets + "/" + asset->mtlFile,
+                           assets + "/" + asset->textureFile, asset->triangles });
+    }
+    if (meshes.empty()) {
+        cout << "Nenhuma malha pedida" << endl;
+        return false;
+    }
+
+    vector<string> materials, textures;
+    if (options.materialCount > 0)
+        filesystem::create_directories(outputDir + "/materiais", error);
+    for (int i = 0; i < options.materialCount; ++i) {
+        char file[64];
+        snprintf(file, sizeof(file), "/materiais/material_%04d.mtl", i);
+        materials.push_back(outputDir + file);
+        if (!writeMaterial(materials.back(), rng)) {
+            cout << "Nao foi possivel gravar " << materials.back() << endl;
+            return false;
+        }
+    }
+    if (options.textureCount > 0)
+        filesystem::create_directories(outputDir + "/texturas", error);
+    for (int i = 0; i < options.textureCount; ++i) {
+        char file[64];
+        snprintf(file, sizeof(file), "/texturas/textura_%04d.png", i);
+        textures.push_back(outputDir + file);
+        if (!writePatternTexture(textures.back(), 128, options.seed * 7919u + i)) {
+            cout << "Nao foi possivel gravar " << textures.back() << endl;
+            return false;
+        }
+    }
+    generated.materialFiles = materials.size();
+    generated.textureFiles = textures.size();
+
+    // Extensão da cena, para a câmera e o plano far
+    size_t count = options.objectCount;
+    int side = (int)ceil(sqrt((double)std::max<size_t>(count, 1)));
+    float extent = options.layout == LAYOUT_GRID ? 0.5f * side * options.spacing
+                                                 : 0.75f * options.spacing * sqrt((float)std::max<size_t>(count, 1));
+    extent = std::max(extent, 2.0f);
+
+    generated.scenePath = outputDir + "/" + sceneName + ".txt";
+    FILE* file = fopen(generated.scenePath.c_str(), "w");
+    if (!file) {
+        cout << "Nao foi possivel gravar " << generated.scenePath << endl;
+        return false;
+    }
+    TextWriter writer(file);
+    writer.line("# Cena gerada: %zu objetos em %s, semente %u", count,
+                options.layout == LAYOUT_GRID ? "grade" : "galaxia", options.seed);
+    writer.line("camera.position = 0.0 %.3f %.3f", extent * 0.8f, extent * 2.0f + 5.0f);
+    writer.line("camera.yaw = -90.0");
+    writer.line("camera.pitch = %.3f", -57.29578f * atan2(extent * 0.8f, extent * 2.0f + 5.0f));
+    writer.line("camera.fov = 45.0");
+    writer.line("camera.near = 0.1");
+    writer.line("camera.far = %.1f", extent * 4.0f + 100.0f);
+    writer.line("light.position = 0.0 %.3f 0.0", extent + 10.0f);
+    writer.line("light.color = 1.0 1.0 1.0");
+
+    // Um prefab (e um vetor de instâncias com o mesmo nome) por combinação de malha,
+    // material e textura; cada objeto é uma linha "array.tipoK.instance"
+    map<tuple<size_t, size_t, size_t>, int> kinds;
+    vector<size_t> kindCounts;
+    string previous; // nome do objeto anterior, alvo das órbitas
+    for (size_t i = 0; i < count; ++i) {
+        const SceneMesh& mesh = meshes[i % meshes.size()];
+        size_t material = materials.empty() ? 0 : i % materials.size();
+        size_t texture = textures.empty() ? 0 : i % textures.size();
+        auto kind = kinds.emplace(make_tuple(i % meshes.size(), material, texture), (int)kinds.size());
+        int k = kind.first->second;
+        if (kind.second) {
+            writer.line("prefab.tipo%d.file = %s", k, mesh.objFile.c_str());
+            writer.line("prefab.tipo%d.mtl = %s", k, materials.empty() ? mesh.mtlFile.c_str() : materials[material].c_str());
+            writer.line("prefab.tipo%d.texture = %s", k, textures.empty() ? mesh.textureFile.c_str() : textures[texture].c_str());
+            writer.line("prefab.tipo%d.scale = 0.5 0.5 0.5", k);
+            writer.line("array.tipo%d.prefab = tipo%d", k, k);
+            kindCounts.push_back(0);
+        }
+        float x, y, z;
+        if (options.layout == LAYOUT_GRID) {
+            x = ((float)(i % side) - 0.5f * (side - 1)) * options.spacing;
+            y = 0.0f;
+            z = ((float)(i / side) - 0.5f * (side - 1)) * options.spacing;
+        }
+        else {
+            // Braço i % braços, torcido com a distância ao centro e espalhado em volta dele
+            float r = extent * pow(unit(rng), 1.5f);
+            float arm = 6.2831853f * (i % std::max(options.galaxyArms, 1)) / std::max(options.galaxyArms, 1);
+            float angle = arm + 4.0f * r / extent + gaussian(rng) * 0.25f;
+            x = r * cos(angle);
+            z = r * sin(angle);
+            y = gaussian(rng) * options.spacing * (1.0f - 0.8f * r / extent);
+        }
+        writer.line("array.tipo%d.instance = %.3f %.3f %.3f; 0 %.1f 0", k, x, y, z, 360.0f * unit(rng));
+        string name = "tipo" + to_string(k) + "[" + to_string(kindCounts[k]++) + "]";
+        if (i > 0 && unit(rng) < options.orbitFraction) {
+            const char* object = name.c_str();
+            writer.line("object.%s.animation = orbit", object);
+            writer.line("object.%s.orbit.target = %s", object, previous.c_str());
+            writer.line("object.%s.orbit.radius = %.3f", object, options.spacing * 0.6f);
+            writer.line("object.%s.orbit.speed = %.3f", object, 0.2f + unit(rng));
+        }
+        previous = std::move(name);
+        generated.triangles += mesh.triangles;
+    }
+    bool ok = writer.finish();
+    ok = fclose(file) == 0 && ok;
+    generated.objects = count;
+    generated.sceneBytes = writer.bytes;
+
+    if (ok && options.compile) {
+        SceneConfig config;
+        generated.compiledPath = outputDir + "/" + sceneName + ".cena";
+        ok = loadSceneConfig(generated.scenePath, config) && saveCompiledScene(config, generated.compiledPath);
+        generated.compiledBytes = ok ? filesystem::file_size(generated.compiledPath, error) : 0;
+    }
+    if (result)
+        *result = generated;
+    return ok;
+}
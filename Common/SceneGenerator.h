@@ -0,0 +1,71 @@
+/* Geração procedural de cenas grandes para testes de escala
+ *
+ * generateScene() grava em uma pasta um arquivo de cena no formato do SceneConfig.h
+ * e os arquivos que ele usa:
+ *  - N objetos com as malhas pedidas (lua, Marte, Suzanne, cubo dos assets, ou
+ *    "esfera:T", uma esfera UV gerada com cerca de T triângulos), alternadas em ordem;
+ *  - posições em grade no plano XZ ou em uma galáxia espiral com braços;
+ *  - opcionalmente M materiais (arquivos MTL com Ka, Kd, Ks e Ns sorteados) e K
+ *    texturas (PNG com padrões de cores sorteadas), distribuídos entre os objetos;
+ *  - uma fração dos objetos em órbita do objeto anterior (hierarquia);
+ *  - câmera e plano far enquadrando a cena inteira.
+ * Os objetos são instâncias de prefabs (um por combinação de malha, material e
+ * textura), uma linha por objeto; com compile, a cena também é gravada compilada
+ * (CompiledScene.h), para carregar sem ler o texto.
+ * Tudo depende só das opções e da semente: a mesma chamada gera os mesmos arquivos.
+ * Os caminhos dentro da cena são os de outputDir e assets como foram passados
+ * (relativos à pasta de onde o programa que lê a cena é executado, em geral a de build).
+ */
+
+#ifndef SCENE_GENERATOR_H
+#define SCENE_GENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum SceneLayout {
+    LAYOUT_GRID,   // grade quadrada centrada na origem
+    LAYOUT_GALAXY, // disco com braços espirais, mais denso no centro
+};
+
+struct SceneGeneratorOptions {
+    size_t objectCount = 1000;
+    SceneLayout layout = LAYOUT_GRID;
+    float spacing = 2.0f;   // distância entre vizinhos da grade (e densidade média da galáxia)
+    int galaxyArms = 4;
+    std::vector<std::string> meshes = { "moon", "mars", "suzanne" };
+    int materialCount = 0;  // 0 = o MTL de cada malha
+    int textureCount = 0;   // 0 = a textura de cada malha
+    float orbitFraction = 0.0f;
+    uint32_t seed = 1;
+    std::string assets = "../assets";
+    bool compile = false;   // grava também <sceneName>.cena
+};
+
+// Tamanho do que foi gerado
+struct GeneratedScene {
+    std::string scenePath;
+    size_t objects = 0;
+    size_t meshFiles = 0;      // malhas geradas (esferas)
+    size_t materialFiles = 0;
+    size_t textureFiles = 0;
+    uint64_t triangles = 0;    // soma dos triângulos de todos os objetos
+    uint64_t sceneBytes = 0;
+    std::string compiledPath; // vazio sem compile
+    uint64_t compiledBytes = 0;
+};
+
+// Grava outputDir/<sceneName>.txt (e malhas/, materiais/, texturas/). false se alguma
+// malha é desconhecida ou algum arquivo não pode ser escrito
+bool generateScene(const std::string& outputDir, const std::string& sceneName,
+                   const SceneGeneratorOptions& options, GeneratedScene* result = nullptr);
+
+// Esfera UV de raio 1 com cerca de triangleCount triângulos, no formato lido por loadOBJ
+// (v, vt e f v/vt). Retorna o número de triângulos gravados (0 se falhou)
+uint64_t writeSphereOBJ(const std::string& path, uint64_t triangleCount);
+
+// Textura size x size com um xadrez de duas cores sorteadas a partir de seed (PNG, PPM ou RAW)
+bool writePatternTexture(const std::string& path, int size, uint32_t seed);
+
+#endif
@@ -0,0 +1,242 @@
+/* Variantes de shader com cache de programas em disco - implementação
+ * Ver ShaderVariants.h
+ */
+
+#include "ShaderVariants.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+// Entradas do OpenGL 4.1 / GL_ARB_get_program_binary (ausentes na GLAD 4.0)
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+typedef void (APIENTRYP PFN_GETPROGRAMBINARY)(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
+typedef void (APIENTRYP PFN_PROGRAMBINARY)(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+typedef void (APIENTRYP PFN_PROGRAMPARAMETERI)(GLuint program, GLenum pname, GLint value);
+
+static PFN_GETPROGRAMBINARY getProgramBinary = NULL;
+static PFN_PROGRAMBINARY programBinary = NULL;
+static PFN_PROGRAMPARAMETERI programParameteri = NULL;
+
+// Cabeçalho dos arquivos do cache
+static const unsigned CACHE_MAGIC = 0x31435653; // "SVC1"
+struct CacheHeader {
+    unsigned magic;
+    GLenum format;
+    unsigned long long hash;
+    unsigned length;
+};
+
+string ShaderVariants::cacheDirectory;
+int ShaderVariants::hits = 0;
+int ShaderVariants::compiled = 0;
+
+// Hash FNV-1a de 64 bits (identifica o código-fonte e o driver de cada binário)
+static unsigned long long hashString(unsigned long long hash, const char* text)
+{
+    for (; text && *text; ++text) {
+        hash ^= (unsigned char)*text;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static bool compileStage(GLuint shader, const vector<const char*>& sources, const char* stageName, const string& name)
+{
+    glShaderSource(shader, (GLsizei)sources.size(), sources.data(), NULL);
+    glCompileShader(shader);
+    GLint success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        GLchar infoLog[512];
+        glGetShaderInfoLog(shader, 512, NULL, infoLog);
+        cout << "ERROR::SHADER::" << stageName << "::COMPILATION_FAILED (" << name << ")\n" << infoLog << endl;
+    }
+    return success != 0;
+}
+
+ShaderVariants::ShaderVariants(const string& name, const string& version,
+                               const vector<const char*>& vertexSources,
+                               const vector<const char*>& fragmentSources)
+    : name(name), version(version + "\n"), vertexSources(vertexSources), fragmentSources(fragmentSources)
+{
+}
+
+bool ShaderVariants::enableBinaryCache(GLADloadproc loader, const string& directory)
+{
+    getProgramBinary = (PFN_GETPROGRAMBINARY)loader("glGetProgramBinary");
+    programBinary = (PFN_PROGRAMBINARY)loader("glProgramBinary");
+    programParameteri = (PFN_PROGRAMPARAMETERI)loader("glProgramParameteri");
+
+    GLint formats = 0;
+    if (getProgramBinary && programBinary && programParameteri)
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    glGetError(); // descarta GL_INVALID_ENUM de drivers sem suporte
+
+    if (formats <= 0) {
+        cout << "ShaderVariants: driver sem suporte a program binaries, cache em disco desligado" << endl;
+        cacheDirectory.clear();
+        return false;
+    }
+
+    error_code ec;
+    filesystem::create_directories(directory, ec);
+    if (ec) {
+        cout << "ShaderVariants: nao foi possivel criar " << directory << ": " << ec.message() << endl;
+        cacheDirectory.clear();
+        return false;
+    }
+    cacheDirectory = directory;
+    return true;
+}
+
+string ShaderVariants::defines(unsigned features, int lightCount)
+{
+    string result;
+    if (features & SHADER_TEXTURED)   result += "#define TEXTURED\n";
+    if (features & SHADER_ALPHA_TEST) result += "#define ALPHA_TEST\n";
+    if (features & SHADER_NORMAL_MAP) result += "#define NORMAL_MAP\n";
+    if (features & SHADER_INSTANCED)  result += "#define INSTANCED\n";
+    result += "#define NUM_LIGHTS " + to_string(lightCount) + "\n";
+    return result;
+}
+
+GLuint ShaderVariants::get(unsigned features, int lightCount)
+{
+    unsigned long long key = ((unsigned long long)(unsigned)lightCount << 32) | features;
+    auto it = programs.find(key);
+    if (it != programs.end())
+        return it->second;
+
+    GLuint program = build(features, lightCount);
+    if (program != 0)
+        programs[key] = program;
+    return program;
+}
+
+GLuint ShaderVariants::build(unsigned features, int lightCount)
+{
+    string defineLines = defines(features, lightCount);
+
+    // O hash cobre todo o código da variante e o driver em uso: qualquer mudança invalida o binário
+    unsigned long long hash = 14695981039346656037ull;
+    hash = hashString(hash, version.c_str());
+    hash = hashString(hash, defineLines.c_str());
+    for (const char* source : vertexSources) hash = hashString(hash, source);
+    hash = hashString(hash, "|");
+    for (const char* source : fragmentSources) hash = hashString(hash, source);
+    hash = hashString(hash, (const char*)glGetString(GL_VENDOR));
+    hash = hashString(hash, (const char*)glGetString(GL_RENDERER));
+    hash = hashString(hash, (const char*)glGetString(GL_VERSION));
+
+    string path;
+    if (!cacheDirectory.empty()) {
+        char fileName[64];
+        snprintf(fileName, sizeof(fileName), "_%08x_%d.bin", features, lightCount);
+        path = cacheDirectory + "/" + name + fileName;
+        GLuint program = loadBinary(path, hash);
+        if (program != 0) {
+            hits++;
+            return program;
+        }
+    }
+
+    // #version primeiro, depois os #defines da variante e o código
+    vector<const char*> vertexParts = { version.c_str(), defineLines.c_str() };
+    vertexParts.insert(vertexParts.end(), vertexSources.begin(), vertexSources.end());
+    vector<const char*> fragmentParts = { version.c_str(), defineLines.c_str() };
+    fragmentParts.insert(fragmentParts.end(), fragmentSources.begin(), fragmentSources.end());
+
+    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    bool ok = compileStage(vertexShader, vertexParts, "VERTEX", name);
+    ok = compileStage(fragmentShader, fragmentParts, "FRAGMENT", name) && ok;
+
+    GLuint program = glCreateProgram();
+    if (!path.empty())
+        programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    glLinkProgram(program);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!ok || !success) {
+        GLchar infoLog[512];
+        glGetProgramInfoLog(program, 512, NULL, infoLog);
+        cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED (" << name << ")\n" << infoLog << endl;
+        glDeleteProgram(program);
+        return 0;
+    }
+    compiled++;
+
+    if (!path.empty())
+        saveBinary(program, path, hash);
+    return program;
+}
+
+GLuint ShaderVariants::loadBinary(const string& path, unsigned long long hash)
+{
+    ifstream file(path, ios::binary);
+    if (!file.is_open())
+        return 0;
+
+    CacheHeader header;
+    if (!file.read((char*)&header, sizeof(header)) || header.magic != CACHE_MAGIC || header.hash != hash)
+        return 0;
+    vector<char> binary(header.length);
+    if (!file.read(binary.data(), header.length))
+        return 0;
+
+    // O driver pode recusar binários de outra versão: nesse caso o programa é recompilado
+    GLuint program = glCreateProgram();
+    programBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+    GLint success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+void ShaderVariants::saveBinary(GLuint program, const string& path, unsigned long long hash)
+{
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    CacheHeader header;
+    header.magic = CACHE_MAGIC;
+    header.hash = hash;
+    vector<char> binary(length);
+    GLsizei written = 0;
+    getProgramBinary(program, length, &written, &header.format, binary.data());
+    header.length = (unsigned)written;
+
+    ofstream file(path, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        cout << "ShaderVariants: nao foi possivel gravar " << path << endl;
+        return;
+    }
+    file.write((const char*)&header, sizeof(header));
+    file.write(binary.data(), written);
+}
+
+void ShaderVariants::release()
+{
+    for (auto& entry : programs)
+        glDeleteProgram(entry.second);
+    programs.clear();
+}
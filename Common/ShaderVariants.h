@@ -0,0 +1,80 @@
+/* Variantes de shader (permutações) com cache de programas em disco
+ *
+ * Em vez de desvios em tempo de execução no shader (if (useEyeTexture == 1),
+ * if (!lightEnabled[i])), cada combinação de recursos é compilada como um programa
+ * próprio, com #defines inseridos logo após a diretiva #version:
+ *
+ *   TEXTURED, ALPHA_TEST, NORMAL_MAP, INSTANCED e NUM_LIGHTS <n>
+ *
+ * As variantes são geradas sob demanda na primeira vez que são pedidas e ficam
+ * guardadas pela chave (máscara de recursos, número de luzes).
+ *
+ * Quando o driver suporta glGetProgramBinary (OpenGL 4.1 ou GL_ARB_get_program_binary,
+ * que a GLAD 4.0 do projeto não carrega), os programas linkados são salvos em disco
+ * e, nas execuções seguintes, carregados sem recompilar.
+ */
+
+#ifndef SHADER_VARIANTS_H
+#define SHADER_VARIANTS_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+// Recursos opcionais de um shader, combinados em uma máscara de bits
+enum ShaderFeature : unsigned {
+    SHADER_TEXTURED   = 1u << 0,
+    SHADER_ALPHA_TEST = 1u << 1,
+    SHADER_NORMAL_MAP = 1u << 2,
+    SHADER_INSTANCED  = 1u << 3,
+};
+
+class ShaderVariants {
+public:
+    // version: diretiva #version (ex.: "#version 400 core")
+    // As partes de código não devem conter #version; elas são concatenadas na ordem dada
+    ShaderVariants(const std::string& name, const std::string& version,
+                   const std::vector<const char*>& vertexSources,
+                   const std::vector<const char*>& fragmentSources);
+
+    // Programa da combinação pedida (compilado ou lido do cache na primeira chamada)
+    // Retorna 0 se a compilação falhar. A falha não fica no cache: o próximo get() da
+    // variante tenta de novo (o arquivo pode ter sido corrigido)
+    GLuint get(unsigned features, int lightCount = 0);
+
+    // Remove todos os programas criados por este conjunto de variantes
+    void release();
+
+    size_t variantCount() const { return programs.size(); }
+
+    // Habilita o cache de programas em disco. loader é a mesma função passada à GLAD
+    // (glfwGetProcAddress). Deve ser chamada com o contexto OpenGL ativo.
+    // Retorna false se o driver não oferece program binaries (o cache fica desligado)
+    static bool enableBinaryCache(GLADloadproc loader, const std::string& directory);
+
+    // Linhas #define correspondentes a uma combinação de recursos
+    static std::string defines(unsigned features, int lightCount);
+
+    // Quantos programas vieram do cache e quantos foram compilados desde o início
+    static int cacheHits() { return hits; }
+    static int compilations() { return compiled; }
+
+private:
+    GLuint build(unsigned features, int lightCount);
+    GLuint loadBinary(const std::string& path, unsigned long long hash);
+    void saveBinary(GLuint program, const std::string& path, unsigned long long hash);
+
+    std::string name;
+    std::string version;
+    std::vector<const char*> vertexSources;
+    std::vector<const char*> fragmentSources;
+    std::map<unsigned long long, GLuint> programs;
+
+    static std::string cacheDirectory; // vazio = cache desligado
+    static int hits;
+    static int compiled;
+};
+
+#endif
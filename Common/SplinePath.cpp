@@ -0,0 +1,218 @@
+/* Caminhos suaves por splines cúbicas - implementação
+ * Ver SplinePath.h
+ */
+
+#include "SplinePath.h"
+
+#include <cmath>
+
+#include "JobSystem.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPLINE_PATH_SSE 1
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+using namespace glm;
+
+// Agentes por job na atualização em paralelo
+static const size_t AGENTS_PER_JOB = 8192;
+
+bool SplinePath::build(const vector<vec3>& points, SplineKind kind, bool closed)
+{
+    coefficients.clear();
+    lut.clear();
+    totalLength = 0.0f;
+    loop = closed;
+
+    // Pontos de controle de Bézier de cada segmento
+    vector<vec3> controls;
+    if (kind == SPLINE_CATMULL_ROM) {
+        size_t count = points.size();
+        if (closed && count > 2 && points.front() == points.back())
+            --count;
+        if (count < 2)
+            return false;
+        size_t segments = closed ? count : count - 1;
+        auto point = [&](long i) {
+            if (closed)
+                return points[(size_t)((i % (long)count + (long)count) % (long)count)];
+            return points[(size_t)glm::clamp(i, 0L, (long)count - 1)];
+        };
+        for (size_t s = 0; s < segments; ++s) {
+            vec3 p0 = point((long)s - 1), p1 = point((long)s), p2 = point((long)s + 1), p3 = point((long)s + 2);
+            controls.push_back(p1);
+            controls.push_back(p1 + (p2 - p0) / 6.0f);
+            controls.push_back(p2 - (p3 - p1) / 6.0f);
+            controls.push_back(p2);
+        }
+    }
+    else {
+        if (points.size() < 4 || (points.size() - 1) % 3 != 0)
+            return false;
+        if (closed && points.front() != points.back())
+            return false;
+        for (size_t s = 0; s + 3 < points.size(); s += 3)
+            controls.insert(controls.end(), points.begin() + s, points.begin() + s + 4);
+    }
+
+    // Base de potências: p(t) = ((a t + b) t + c) t + d
+    for (size_t i = 0; i < controls.size(); i += 4) {
+        vec3 b0 = controls[i], b1 = controls[i + 1], b2 = controls[i + 2], b3 = controls[i + 3];
+        coefficients.push_back(-b0 + 3.0f * b1 - 3.0f * b2 + b3);
+        coefficients.push_back(3.0f * b0 - 6.0f * b1 + 3.0f * b2);
+        coefficients.push_back(-3.0f * b0 + 3.0f * b1);
+        coefficients.push_back(b0);
+    }
+
+    // Tabela de comprimento de arco, medida por cordas em cada segmento
+    size_t segments = segmentCount();
+    lut.reserve(segments * SAMPLES_PER_SEGMENT + 1);
+    vec3 previous = evaluate(0.0f);
+    lut.push_back({ 0.0f, 0.0f });
+    for (size_t s = 0; s < segments; ++s)
+        for (int k = 1; k <= SAMPLES_PER_SEGMENT; ++k) {
+            vec3 position = evaluate((float)s + (float)k / SAMPLES_PER_SEGMENT);
+            float chord = distance(previous, position);
+            totalLength += chord;
+            previous = position;
+            lut.back().tPerDistance = chord > 0.0f ? (1.0f / SAMPLES_PER_SEGMENT) / chord : 0.0f;
+            lut.push_back({ totalLength, 0.0f });
+        }
+    return true;
+}
+
+vec3 SplinePath::evaluate(float param, vec3* derivative) const
+{
+    size_t segments = segmentCount();
+    size_t s = (size_t)glm::clamp((long)floor(param), 0L, (long)segments - 1);
+    float t = param - (float)s;
+    const vec3* k = &coefficients[4 * s];
+    if (derivative)
+        *derivative = (3.0f * k[0] * t + 2.0f * k[1]) * t + k[2];
+    return ((k[0] * t + k[1]) * t + k[2]) * t + k[3];
+}
+
+void SplinePath::sample(float distanceAlong, uint32_t& cursor, vec3& position, vec3& tangent) const
+{
+    if (coefficients.empty())
+        return;
+    if (loop && totalLength > 0.0f) {
+        // Normalmente quem avança já mantém a distância dentro de uma volta
+        if (distanceAlong < 0.0f || distanceAlong >= totalLength) {
+            distanceAlong = fmod(distanceAlong, totalLength);
+            if (distanceAlong < 0.0f)
+                distanceAlong += totalLength;
+        }
+    }
+    else {
+        distanceAlong = glm::clamp(distanceAlong, 0.0f, totalLength);
+    }
+
+    // Entrada [i, i + 1] da tabela que contém a distância, a partir da anterior
+    const ArcEntry* entries = lut.data();
+    uint32_t last = (uint32_t)lut.size() - 1;
+    uint32_t i = cursor < last && distanceAlong >= entries[cursor].distance ? cursor : 0;
+    while (i + 1 < last && distanceAlong >= entries[i + 1].distance)
+        ++i;
+    cursor = i;
+
+    // Segmento e t saem do índice da entrada, sem floor
+    uint32_t segment = i / SAMPLES_PER_SEGMENT;
+    float t = (float)(i % SAMPLES_PER_SEGMENT) * (1.0f / SAMPLES_PER_SEGMENT) +
+              (distanceAlong - entries[i].distance) * entries[i].tPerDistance;
+
+    const vec3* k = &coefficients[4 * segment];
+    vec3 derivative = (3.0f * k[0] * t + 2.0f * k[1]) * t + k[2];
+    position = ((k[0] * t + k[1]) * t + k[2]) * t + k[3];
+    float speed = glm::length(derivative);
+    if (speed > 1e-6f)
+        tangent = derivative / speed;
+}
+
+quat orientationAlong(const vec3& tangent, const vec3& forward)
+{
+    // Leva forward para +Z, inclina para a subida da tangente e gira para o seu rumo
+    float forwardYaw = atan2(forward.x, forward.z);
+    float yaw = atan2(tangent.x, tangent.z);
+    float pitch = atan2(tangent.y, length(vec2(tangent.x, tangent.z)));
+    const vec3 up(0.0f, 1.0f, 0.0f);
+    return angleAxis(yaw, up) * angleAxis(-pitch, vec3(1.0f, 0.0f, 0.0f)) * angleAxis(-forwardYaw, up);
+}
+
+void PathAgents::add(uint32_t path, float speed, float distance)
+{
+    paths.push_back(path);
+    distances.push_back(distance);
+    speeds.push_back(speed);
+    cursors.push_back(0);
+    positions.push_back(vec3(0.0f));
+    tangents.push_back(vec3(0.0f, 0.0f, 1.0f));
+}
+
+void PathAgents::clear()
+{
+    paths.clear();
+    distances.clear();
+    speeds.clear();
+    cursors.clear();
+    positions.clear();
+    tangents.clear();
+}
+
+// Prende count posições na caixa [lower, upper] com min/max, sem desvios. As posições
+// são tratadas como um vetor de floats x y z x y z ...: a cada 4 posições (12 floats, 3
+// registradores) o padrão dos limites nas pistas se repete
+static void clampPositions(vec3* positions, size_t count, const vec3& lower, const vec3& upper)
+{
+    float* values = &positions[0].x;
+    size_t floats = count * 3, i = 0;
+#ifdef SPLINE_PATH_SSE
+    const __m128 lower0 = _mm_setr_ps(lower.x, lower.y, lower.z, lower.x);
+    const __m128 lower1 = _mm_setr_ps(lower.y, lower.z, lower.x, lower.y);
+    const __m128 lower2 = _mm_setr_ps(lower.z, lower.x, lower.y, lower.z);
+    const __m128 upper0 = _mm_setr_ps(upper.x, upper.y, upper.z, upper.x);
+    const __m128 upper1 = _mm_setr_ps(upper.y, upper.z, upper.x, upper.y);
+    const __m128 upper2 = _mm_setr_ps(upper.z, upper.x, upper.y, upper.z);
+    for (; i + 12 <= floats; i += 12) {
+        __m128 a = _mm_loadu_ps(values + i);
+        __m128 b = _mm_loadu_ps(values + i + 4);
+        __m128 c = _mm_loadu_ps(values + i + 8);
+        _mm_storeu_ps(values + i, _mm_min_ps(_mm_max_ps(a, lower0), upper0));
+        _mm_storeu_ps(values + i + 4, _mm_min_ps(_mm_max_ps(b, lower1), upper1));
+        _mm_storeu_ps(values + i + 8, _mm_min_ps(_mm_max_ps(c, lower2), upper2));
+    }
+#endif
+    for (size_t k = i / 3; k < count; ++k)
+        positions[k] = glm::min(glm::max(positions[k], lower), upper);
+}
+
+void advancePathAgents(const vector<SplinePath>& paths, PathAgents& agents, float step, JobSystem* jobs)
+{
+    const SplinePath* pathData = paths.data();
+    const uint32_t* pathIndices = agents.paths.data();
+    const float* speeds = agents.speeds.data();
+    float* distances = agents.distances.data();
+    uint32_t* cursors = agents.cursors.data();
+    vec3* positions = agents.positions.data();
+    vec3* tangents = agents.tangents.data();
+
+    auto body = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const SplinePath& path = pathData[pathIndices[i]];
+            float distance = distances[i] + speeds[i] * step;
+            // Mantém a distância pequena em caminhos fechados (precisão do float)
+            if (path.closed() && distance >= path.length())
+                distance -= path.length();
+            distances[i] = distance;
+            path.sample(distance, cursors[i], positions[i], tangents[i]);
+        }
+        // O bloco acabou de ser escrito: ainda está na cache
+        clampPositions(positions + begin, end - begin, agents.boundsMin, agents.boundsMax);
+    };
+    if (jobs)
+        jobs->parallelFor(agents.size(), AGENTS_PER_JOB, body);
+    else if (agents.size() > 0)
+        body((size_t)0, agents.size());
+}
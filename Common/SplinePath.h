@@ -0,0 +1,97 @@
+/* Caminhos suaves por splines cúbicas, percorridos com velocidade constante
+ *
+ * Um SplinePath é montado a partir dos pontos de uma trajetória:
+ *  - Catmull-Rom: a curva passa por todos os pontos, com a tangente de cada ponto
+ *    dada pelos vizinhos;
+ *  - Bézier cúbica: os pontos são o polígono de controle P0 C C P1 C C P2 ... (3n + 1
+ *    pontos), a curva passa só por P0, P1, ...
+ * Os dois tipos viram segmentos cúbicos na base de potências (a t³ + b t² + c t + d).
+ *
+ * O parâmetro t não anda com velocidade constante na curva. Por isso cada caminho guarda
+ * uma tabela de comprimento de arco (distância acumulada -> segmento e t), e quem
+ * percorre o caminho avança em distância. A busca na tabela começa na entrada da amostra
+ * anterior (cursor), então é O(1) amortizado com a distância avançando.
+ *
+ * PathAgents guarda muitos agentes (SoA) andando em caminhos, atualizados em lote.
+ */
+
+#ifndef SPLINE_PATH_H
+#define SPLINE_PATH_H
+
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+class JobSystem;
+
+enum SplineKind : uint8_t {
+    SPLINE_CATMULL_ROM,
+    SPLINE_BEZIER,
+};
+
+class SplinePath {
+public:
+    // Entradas da tabela de comprimento de arco por segmento
+    static const int SAMPLES_PER_SEGMENT = 32;
+
+    // closed liga o último ponto ao primeiro (um último ponto igual ao primeiro é
+    // ignorado). Bézier fechada: o último ponto de controle deve ser igual ao primeiro.
+    // Retorna false se os pontos não formam um caminho desse tipo
+    bool build(const std::vector<glm::vec3>& points, SplineKind kind, bool closed);
+
+    float length() const { return totalLength; }
+    bool closed() const { return loop; }
+    size_t segmentCount() const { return coefficients.size() / 4; }
+
+    // Posição e tangente unitária a distance unidades do início (em laço se fechado,
+    // presa nas pontas se aberto). cursor é a entrada da tabela da amostra anterior
+    void sample(float distance, uint32_t& cursor, glm::vec3& position, glm::vec3& tangent) const;
+
+    // Posição e derivada no parâmetro param = segmento + t
+    glm::vec3 evaluate(float param, glm::vec3* derivative = nullptr) const;
+
+private:
+    // Entrada da tabela: distância acumulada e quanto t anda por unidade de distância
+    // até a próxima entrada. A entrada i fica no segmento i / SAMPLES_PER_SEGMENT
+    struct ArcEntry {
+        float distance;
+        float tPerDistance;
+    };
+
+    std::vector<glm::vec3> coefficients; // a, b, c, d de cada segmento
+    std::vector<ArcEntry> lut;
+    float totalLength = 0.0f;
+    bool loop = false;
+};
+
+// Orientação que leva o eixo forward do modelo (horizontal) para a tangente, mantendo o
+// modelo em pé: inclina para a subida e gira em torno de Y para o rumo
+glm::quat orientationAlong(const glm::vec3& tangent, const glm::vec3& forward = glm::vec3(0.0f, 0.0f, 1.0f));
+
+// Agentes andando em caminhos, em vetores separados por campo
+struct PathAgents {
+    std::vector<uint32_t> paths;     // índice do caminho
+    std::vector<float> distances;    // distância percorrida no caminho
+    std::vector<float> speeds;       // unidades por segundo
+    std::vector<uint32_t> cursors;
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> tangents;
+
+    // Caixa em que as posições ficam presas (sem limite por padrão)
+    glm::vec3 boundsMin = glm::vec3(-FLT_MAX);
+    glm::vec3 boundsMax = glm::vec3(FLT_MAX);
+
+    size_t size() const { return paths.size(); }
+    void add(uint32_t path, float speed, float distance = 0.0f);
+    void clear();
+};
+
+// Avança todos os agentes step segundos e atualiza posições e tangentes (presas na
+// caixa dos agentes). Com jobs, só uma thread por vez pode chamar com o mesmo JobSystem
+void advancePathAgents(const std::vector<SplinePath>& paths, PathAgents& agents, float step,
+                       JobSystem* jobs = nullptr);
+
+#endif
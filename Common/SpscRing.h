@@ -0,0 +1,60 @@
+/* Anel sem travas para um produtor e um consumidor
+ *
+ * Usado onde uma thread produz itens e outra os recolhe sem que nenhuma espere a
+ * outra: a gravação de trajetórias (TrajectoryRecorder.h) e os eventos de cada thread
+ * do profiler (FrameProfiler.h). Se o anel está cheio, push() falha e o produtor decide
+ * o que fazer (normalmente, descartar e contar).
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Anel de capacidade potência de 2 para um produtor e um consumidor, sem travas
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity = 1 << 16)
+    {
+        size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+        items.resize(size);
+        mask = size - 1;
+    }
+
+    // Produtor: false se o anel está cheio
+    bool push(const T& item)
+    {
+        size_t tail = writeIndex.load(std::memory_order_relaxed);
+        if (tail - readIndex.load(std::memory_order_acquire) > mask)
+            return false;
+        items[tail & mask] = item;
+        writeIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumidor: copia até maxCount itens para out e retorna quantos
+    size_t pop(T* out, size_t maxCount)
+    {
+        size_t head = readIndex.load(std::memory_order_relaxed);
+        size_t available = writeIndex.load(std::memory_order_acquire) - head;
+        size_t count = available < maxCount ? available : maxCount;
+        for (size_t i = 0; i < count; ++i)
+            out[i] = items[(head + i) & mask];
+        readIndex.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    std::vector<T> items;
+    size_t mask;
+    // Em linhas de cache separadas: cada índice é escrito por uma thread só
+    alignas(64) std::atomic<size_t> writeIndex{0};
+    alignas(64) std::atomic<size_t> readIndex{0};
+};
+
+#endif
@@ -0,0 +1,27 @@
+/* Internação de strings - implementação
+ * Ver StringInterner.h
+ */
+
+#include "StringInterner.h"
+
+using namespace std;
+
+StringId StringInterner::intern(const string& text)
+{
+    auto inserted = ids.emplace(text, (StringId)strings.size());
+    if (inserted.second)
+        strings.push_back(&inserted.first->first);
+    return inserted.first->second;
+}
+
+StringId StringInterner::find(const string& text) const
+{
+    auto it = ids.find(text);
+    return it != ids.end() ? it->second : INVALID_STRING_ID;
+}
+
+void StringInterner::clear()
+{
+    ids.clear();
+    strings.clear();
+}
@@ -0,0 +1,45 @@
+/* Internação de strings: nomes viram ids inteiros densos
+ *
+ * Cada string distinta recebe um id sequencial (0, 1, 2, ...) na primeira vez que é
+ * internada, e todas as referências ao mesmo nome passam a ser o mesmo inteiro. Os
+ * nomes são resolvidos uma vez, ao carregar a configuração; depois disso as tabelas
+ * podem ser vetores indexados pelo id, sem comparar strings.
+ */
+
+#ifndef STRING_INTERNER_H
+#define STRING_INTERNER_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+typedef uint32_t StringId;
+const StringId INVALID_STRING_ID = 0xFFFFFFFFu;
+
+class StringInterner {
+public:
+    StringInterner() = default;
+    // strings aponta para as chaves do próprio mapa: uma cópia apontaria para o original.
+    // Mover é seguro (os nós do mapa vão junto)
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+    StringInterner(StringInterner&&) = default;
+    StringInterner& operator=(StringInterner&&) = default;
+
+    // Id do nome, criando um novo se ele ainda não existir
+    StringId intern(const std::string& text);
+
+    // Id do nome, ou INVALID_STRING_ID se ele nunca foi internado
+    StringId find(const std::string& text) const;
+
+    const std::string& str(StringId id) const { return *strings[id]; }
+    size_t size() const { return strings.size(); }
+    void clear();
+
+private:
+    std::unordered_map<std::string, StringId> ids;
+    std::vector<const std::string*> strings; // chaves de ids (os nós do mapa não mudam de lugar)
+};
+
+#endif
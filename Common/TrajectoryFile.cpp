@@ -0,0 +1,325 @@
+/* Arquivo binário de trajetórias - implementação
+ * Ver TrajectoryFile.h
+ */
+
+#include "TrajectoryFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace glm;
+
+static const char TRAJECTORY_MAGIC[4] = { 'T', 'R', 'J', '1' };
+static const uint16_t TRAJECTORY_VERSION = 1;
+
+// Pontos codificados no buffer antes de cada fwrite
+static const size_t WRITE_BLOCK_POINTS = 64 * 1024;
+
+size_t trajectoryRecordSize(uint16_t flags)
+{
+    size_t position = (flags & TRAJECTORY_QUANTIZED) ? 3 * sizeof(uint16_t) : 3 * sizeof(float);
+    return position + ((flags & TRAJECTORY_TIMES) ? sizeof(float) : 0);
+}
+
+// --- Leitura ---
+
+bool TrajectoryReader::open(const string& path)
+{
+    close();
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(TrajectoryHeader)) {
+        CloseHandle(handle);
+        return false;
+    }
+    HANDLE view = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* mapped = view ? MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!mapped) {
+        if (view)
+            CloseHandle(view);
+        CloseHandle(handle);
+        return false;
+    }
+    file = handle;
+    mapping = view;
+    size = (size_t)fileSize.QuadPart;
+#else
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        return false;
+    struct stat info;
+    if (fstat(descriptor, &info) != 0 || info.st_size < (off_t)sizeof(TrajectoryHeader)) {
+        ::close(descriptor);
+        return false;
+    }
+    void* mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor); // o mapeamento continua valendo
+    if (mapped == MAP_FAILED)
+        return false;
+    madvise(mapped, (size_t)info.st_size, MADV_SEQUENTIAL);
+    size = (size_t)info.st_size;
+#endif
+    data = static_cast<const uint8_t*>(mapped);
+
+    memcpy(&header, data, sizeof(header));
+    recordSize = trajectoryRecordSize(header.flags);
+    bool valid = memcmp(header.magic, TRAJECTORY_MAGIC, 4) == 0 && header.version == TRAJECTORY_VERSION &&
+                 header.pointCount <= (size - sizeof(header)) / recordSize;
+    if (!valid)
+        close();
+    return valid;
+}
+
+void TrajectoryReader::close()
+{
+    if (data) {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle((HANDLE)mapping);
+        CloseHandle((HANDLE)file);
+        mapping = file = nullptr;
+#else
+        munmap((void*)data, size);
+#endif
+    }
+    data = nullptr;
+    size = 0;
+    header = TrajectoryHeader();
+}
+
+size_t TrajectoryReader::read(uint64_t first, size_t count, vec3* points, float* times) const
+{
+    if (first >= header.pointCount)
+        return 0;
+    count = (size_t)std::min<uint64_t>(count, header.pointCount - first);
+    const uint8_t* record = data + sizeof(TrajectoryHeader) + first * recordSize;
+
+    if (quantized()) {
+        vec3 lower(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+        vec3 extent = (vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]) - lower) / 65535.0f;
+        for (size_t i = 0; i < count; ++i, record += recordSize) {
+            uint16_t q[3];
+            memcpy(q, record, sizeof(q));
+            points[i] = lower + vec3(q[0], q[1], q[2]) * extent;
+            if (times && hasTimes())
+                memcpy(&times[i], record + sizeof(q), sizeof(float));
+        }
+    }
+    else {
+        for (size_t i = 0; i < count; ++i, record += recordSize) {
+            memcpy(&points[i], record, sizeof(vec3));
+            if (times && hasTimes())
+                memcpy(&times[i], record + sizeof(vec3), sizeof(float));
+        }
+    }
+    return count;
+}
+
+void TrajectoryReader::stream(size_t chunkPoints, const function<void(const vec3*, const float*, size_t)>& chunk)
+{
+    chunkPoints = std::max<size_t>(chunkPoints, 1);
+    vector<vec3> points(chunkPoints);
+    vector<float> times(hasTimes() ? chunkPoints : 0);
+#ifndef _WIN32
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t released = 0; // bytes do início do mapeamento já devolvidos
+#endif
+    for (uint64_t first = 0; first < header.pointCount; first += chunkPoints) {
+        size_t count = read(first, chunkPoints, points.data(), hasTimes() ? times.data() : nullptr);
+        chunk(points.data(), hasTimes() ? times.data() : nullptr, count);
+#ifndef _WIN32
+        // Páginas inteiras já lidas voltam para o sistema: a memória usada fica no
+        // tamanho de um bloco, não do arquivo
+        size_t consumed = (sizeof(TrajectoryHeader) + (size_t)(first + count) * recordSize) / page * page;
+        if (consumed > released) {
+            madvise((void*)(data + released), consumed - released, MADV_DONTNEED);
+            released = consumed;
+        }
+#endif
+    }
+}
+
+// --- Escrita ---
+
+bool TrajectoryWriter::open(const string& path, uint16_t flags, const vec3& boundsMin, const vec3& boundsMax)
+{
+    close();
+    file = fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+    header = TrajectoryHeader();
+    memcpy(header.magic, TRAJECTORY_MAGIC, 4);
+    header.version = TRAJECTORY_VERSION;
+    header.flags = flags;
+    for (int c = 0; c < 3; ++c) {
+        header.boundsMin[c] = boundsMin[c];
+        header.boundsMax[c] = boundsMax[c];
+    }
+    failed = fwrite(&header, sizeof(header), 1, file) != 1;
+    buffer.reserve(WRITE_BLOCK_POINTS * trajectoryRecordSize(flags));
+    return !failed;
+}
+
+bool TrajectoryWriter::append(const vec3* points, size_t count, const float* times)
+{
+    if (!file)
+        return false;
+    const size_t recordSize = trajectoryRecordSize(header.flags);
+    const bool withTimes = (header.flags & TRAJECTORY_TIMES) != 0;
+    vec3 lower(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+    vec3 extent = vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]) - lower;
+    vec3 scale = vec3(65535.0f) / glm::max(extent, vec3(1e-30f));
+
+    for (size_t first = 0; first < count; first += WRITE_BLOCK_POINTS) {
+        size_t block = std::min(WRITE_BLOCK_POINTS, count - first);
+        buffer.resize(block * recordSize);
+        uint8_t* record = buffer.data();
+        for (size_t i = first; i < first + block; ++i, record += recordSize) {
+            size_t offset;
+            if (header.flags & TRAJECTORY_QUANTIZED) {
+                vec3 q = glm::clamp((points[i] - lower) * scale + 0.5f, vec3(0.0f), vec3(65535.0f));
+                uint16_t packed[3] = { (uint16_t)q.x, (uint16_t)q.y, (uint16_t)q.z };
+                memcpy(record, packed, sizeof(packed));
+                offset = sizeof(packed);
+            }
+            else {
+                memcpy(record, &points[i], sizeof(vec3));
+                offset = sizeof(vec3);
+            }
+            if (withTimes) {
+                float time = times ? times[i] : 0.0f;
+                memcpy(record + offset, &time, sizeof(float));
+            }
+        }
+        if (fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size())
+            failed = true;
+    }
+    header.pointCount += count;
+    return !failed;
+}
+
+bool TrajectoryWriter::close()
+{
+    if (!file)
+        return false;
+    // Total de pontos no cabeçalho, agora que se sabe
+    if (fseek(file, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, file) != 1)
+        failed = true;
+    if (fclose(file) != 0)
+        failed = true;
+    file = nullptr;
+    buffer = vector<uint8_t>();
+    return !failed;
+}
+
+bool loadTrajectoryFile(const string& path, vector<vec3>& points, vector<float>* times)
+{
+    TrajectoryReader reader;
+    if (!reader.open(path))
+        return false;
+    size_t count = (size_t)reader.pointCount();
+    points.resize(count);
+    if (times)
+        times->assign(reader.hasTimes() ? count : 0, 0.0f);
+    reader.read(0, count, points.data(), times && reader.hasTimes() ? times->data() : nullptr);
+    return true;
+}
+
+bool saveTrajectoryFile(const string& path, const vector<vec3>& points, uint16_t flags, const vector<float>* times)
+{
+    if ((flags & TRAJECTORY_TIMES) && (!times || times->size() < points.size()))
+        return false;
+    vec3 lower(0.0f), upper(0.0f);
+    if ((flags & TRAJECTORY_QUANTIZED) && !points.empty()) {
+        lower = upper = points[0];
+        for (const vec3& p : points) {
+            lower = glm::min(lower, p);
+            upper = glm::max(upper, p);
+        }
+    }
+    TrajectoryWriter writer;
+    if (!writer.open(path, flags, lower, upper))
+        return false;
+    writer.append(points.data(), points.size(), times ? times->data() : nullptr);
+    return writer.close();
+}
+
+// --- Gravação em segundo plano ---
+
+AsyncTrajectoryWriter::AsyncTrajectoryWriter()
+{
+    worker = thread([this] { workerLoop(); });
+}
+
+AsyncTrajectoryWriter::~AsyncTrajectoryWriter()
+{
+    {
+        lock_guard<mutex> lock(queueMutex);
+        quit = true;
+    }
+    wakeUp.notify_one();
+    worker.join();
+}
+
+void AsyncTrajectoryWriter::save(string path, vector<vec3> points, uint16_t flags, vector<float> times)
+{
+    {
+        lock_guard<mutex> lock(queueMutex);
+        requests.push_back(Request{ std::move(path), std::move(points), std::move(times), flags });
+    }
+    wakeUp.notify_one();
+}
+
+bool AsyncTrajectoryWriter::popResult(Result& result)
+{
+    lock_guard<mutex> lock(queueMutex);
+    if (results.empty())
+        return false;
+    result = results.front();
+    results.erase(results.begin());
+    return true;
+}
+
+void AsyncTrajectoryWriter::flush()
+{
+    unique_lock<mutex> lock(queueMutex);
+    idle.wait(lock, [this] { return requests.empty() && !busy; });
+}
+
+void AsyncTrajectoryWriter::workerLoop()
+{
+    unique_lock<mutex> lock(queueMutex);
+    while (true) {
+        wakeUp.wait(lock, [this] { return quit || !requests.empty(); });
+        if (requests.empty())
+            return; // quit, sem nada pendente
+        Request request = std::move(requests.front());
+        requests.pop_front();
+        busy = true;
+
+        lock.unlock();
+        bool ok = saveTrajectoryFile(request.path, request.points, request.flags,
+                                     (request.flags & TRAJECTORY_TIMES) ? &request.times : nullptr);
+        lock.lock();
+
+        results.push_back(Result{ request.path, request.points.size(), ok });
+        busy = false;
+        if (requests.empty())
+            idle.notify_all();
+    }
+}
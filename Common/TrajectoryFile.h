@@ -0,0 +1,154 @@
+/* Arquivo binário de trajetórias (.trj)
+ *
+ * Formato (little-endian): um cabeçalho de 48 bytes seguido de um registro de tamanho
+ * fixo por ponto, então o ponto i está em 48 + i * tamanho do registro:
+ *  - posição em 3 floats, ou quantizada em 3 uint16 dentro da caixa do cabeçalho
+ *    (TRAJECTORY_QUANTIZED, erro de até (max - min) / 131070 por eixo);
+ *  - tempo em float, se TRAJECTORY_TIMES.
+ *
+ * A leitura mapeia o arquivo na memória (mmap / MapViewOfFile): só as páginas tocadas
+ * são lidas do disco. stream() percorre o arquivo em blocos e devolve ao sistema as
+ * páginas já usadas, para caminhos maiores que a RAM.
+ *
+ * A escrita é em fluxo (TrajectoryWriter::append em blocos, o total vai no cabeçalho no
+ * close()). AsyncTrajectoryWriter grava em uma thread própria, sem travar o quadro.
+ */
+
+#ifndef TRAJECTORY_FILE_H
+#define TRAJECTORY_FILE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+enum TrajectoryFlags : uint16_t {
+    TRAJECTORY_TIMES = 1,     // cada ponto tem um tempo
+    TRAJECTORY_QUANTIZED = 2, // posições em uint16 dentro de boundsMin..boundsMax
+};
+
+struct TrajectoryHeader {
+    char magic[4];        // "TRJ1"
+    uint16_t version;
+    uint16_t flags;
+    uint64_t pointCount;
+    float boundsMin[3];
+    float boundsMax[3];
+    uint8_t reserved[8];
+};
+static_assert(sizeof(TrajectoryHeader) == 48, "cabecalho do .trj deve ter 48 bytes");
+
+// Bytes de cada ponto com essas flags
+size_t trajectoryRecordSize(uint16_t flags);
+
+class TrajectoryReader {
+public:
+    TrajectoryReader() = default;
+    ~TrajectoryReader() { close(); }
+    TrajectoryReader(const TrajectoryReader&) = delete;
+    TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+
+    // false se o arquivo não existe ou não é um .trj válido
+    bool open(const std::string& path);
+    void close();
+
+    uint64_t pointCount() const { return header.pointCount; }
+    bool hasTimes() const { return (header.flags & TRAJECTORY_TIMES) != 0; }
+    bool quantized() const { return (header.flags & TRAJECTORY_QUANTIZED) != 0; }
+
+    // Decodifica os pontos [first, first + count) (times pode ser nullptr). Retorna
+    // quantos pontos foram lidos
+    size_t read(uint64_t first, size_t count, glm::vec3* points, float* times = nullptr) const;
+
+    // Chama chunk(pontos, tempos, quantidade) para blocos de até chunkPoints pontos, em
+    // ordem; tempos é nullptr se o arquivo não tem tempos
+    void stream(size_t chunkPoints, const std::function<void(const glm::vec3*, const float*, size_t)>& chunk);
+
+private:
+    TrajectoryHeader header = {};
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    size_t recordSize = 0;
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+};
+
+class TrajectoryWriter {
+public:
+    TrajectoryWriter() = default;
+    ~TrajectoryWriter() { close(); }
+    TrajectoryWriter(const TrajectoryWriter&) = delete;
+    TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+    // Quantizado: as posições são presas na caixa boundsMin..boundsMax
+    bool open(const std::string& path, uint16_t flags, const glm::vec3& boundsMin = glm::vec3(0.0f),
+              const glm::vec3& boundsMax = glm::vec3(0.0f));
+    // times é obrigatório com TRAJECTORY_TIMES
+    bool append(const glm::vec3* points, size_t count, const float* times = nullptr);
+    // Grava o total de pontos no cabeçalho e fecha; false se alguma escrita falhou
+    bool close();
+
+private:
+    FILE* file = nullptr;
+    TrajectoryHeader header = {};
+    std::vector<uint8_t> buffer;
+    bool failed = false;
+};
+
+// Lê ou grava um .trj inteiro. Quantizado: a caixa vem dos próprios pontos
+bool loadTrajectoryFile(const std::string& path, std::vector<glm::vec3>& points, std::vector<float>* times = nullptr);
+bool saveTrajectoryFile(const std::string& path, const std::vector<glm::vec3>& points, uint16_t flags = 0,
+                        const std::vector<float>* times = nullptr);
+
+// Grava arquivos .trj em uma thread própria, na ordem em que foram pedidos
+class AsyncTrajectoryWriter {
+public:
+    struct Result {
+        std::string path;
+        size_t pointCount;
+        bool ok;
+    };
+
+    AsyncTrajectoryWriter();
+    ~AsyncTrajectoryWriter(); // termina as gravações pendentes
+
+    // Os pontos são movidos para a fila: o chamador não espera o disco
+    void save(std::string path, std::vector<glm::vec3> points, uint16_t flags = 0,
+              std::vector<float> times = std::vector<float>());
+
+    // Próxima gravação terminada, para avisar na thread principal
+    bool popResult(Result& result);
+
+    // Espera a fila esvaziar
+    void flush();
+
+private:
+    struct Request {
+        std::string path;
+        std::vector<glm::vec3> points;
+        std::vector<float> times;
+        uint16_t flags;
+    };
+
+    void workerLoop();
+
+    std::thread worker;
+    std::mutex queueMutex;
+    std::condition_variable wakeUp;
+    std::condition_variable idle;
+    std::deque<Request> requests;
+    std::vector<Result> results;
+    bool busy = false;
+    bool quit = false;
+};
+
+#endif
@@ -0,0 +1,213 @@
+/* Gravação de trajetórias em alta frequência - implementação
+ * Ver TrajectoryRecorder.h
+ */
+
+#include "TrajectoryRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "TrajectoryFile.h"
+
+using namespace std;
+using namespace glm;
+
+// Amostras tiradas do anel de cada vez e acumuladas por trilha antes de cada append
+static const size_t WRITER_BATCH = 4096;
+
+// Distância de p à reta (segmento) entre a e b
+static float distanceToSegment(const vec3& p, const vec3& a, const vec3& b)
+{
+    vec3 ab = b - a;
+    float lengthSquared = dot(ab, ab);
+    float t = lengthSquared > 0.0f ? glm::clamp(dot(p - a, ab) / lengthSquared, 0.0f, 1.0f) : 0.0f;
+    return distance(p, a + t * ab);
+}
+
+size_t simplifyTrajectory(vector<vec3>& points, vector<float>* times, float tolerance)
+{
+    size_t count = points.size();
+    if (count < 3 || tolerance <= 0.0f)
+        return count;
+
+    // Pilha explícita de intervalos: caminhos com milhões de pontos não cabem em recursão
+    vector<uint8_t> keep(count, 0);
+    keep[0] = keep[count - 1] = 1;
+    vector<pair<size_t, size_t>> ranges;
+    ranges.push_back(make_pair((size_t)0, count - 1));
+    while (!ranges.empty()) {
+        size_t first = ranges.back().first, last = ranges.back().second;
+        ranges.pop_back();
+        float farthest = tolerance;
+        size_t split = 0;
+        for (size_t i = first + 1; i < last; ++i) {
+            float d = distanceToSegment(points[i], points[first], points[last]);
+            if (d > farthest) {
+                farthest = d;
+                split = i;
+            }
+        }
+        if (split == 0)
+            continue;
+        keep[split] = 1;
+        if (split - first > 1)
+            ranges.push_back(make_pair(first, split));
+        if (last - split > 1)
+            ranges.push_back(make_pair(split, last));
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!keep[i])
+            continue;
+        points[kept] = points[i];
+        if (times && times->size() == count)
+            (*times)[kept] = (*times)[i];
+        ++kept;
+    }
+    points.resize(kept);
+    if (times && times->size() == count)
+        times->resize(kept);
+    return kept;
+}
+
+TrajectoryRecorder::TrajectoryRecorder(size_t ringCapacity)
+    : ring(ringCapacity)
+{
+}
+
+TrajectoryRecorder::~TrajectoryRecorder()
+{
+    stop();
+    join();
+}
+
+bool TrajectoryRecorder::start(const vector<string>& paths, double rate, SampleFunction position, float tolerance)
+{
+    if (paths.empty() || rate <= 0.0 || !position)
+        return false;
+    stop();
+    join(); // a escrita de uma gravação anterior termina antes
+
+    trackPaths = paths;
+    samplePosition = position;
+    simplifyTolerance = tolerance;
+    taken = 0;
+    dropped = 0;
+    samplerDone = false;
+    sampling = true;
+    writer = thread([this] { writerLoop(); });
+    sampler = thread([this, rate] { samplerLoop(rate); });
+    return true;
+}
+
+void TrajectoryRecorder::stop()
+{
+    sampling = false;
+    if (sampler.joinable())
+        sampler.join(); // no máximo um período: depois disso a função de amostragem não roda mais
+}
+
+void TrajectoryRecorder::join()
+{
+    if (writer.joinable())
+        writer.join();
+}
+
+bool TrajectoryRecorder::popResult(Result& result)
+{
+    lock_guard<mutex> lock(resultMutex);
+    if (results.empty())
+        return false;
+    result = results.front();
+    results.erase(results.begin());
+    return true;
+}
+
+void TrajectoryRecorder::samplerLoop(double rate)
+{
+    typedef chrono::steady_clock Clock;
+    const chrono::duration<double> period(1.0 / rate);
+    const Clock::time_point begin = Clock::now();
+    uint32_t tracks = (uint32_t)trackPaths.size();
+
+    // A amostra k é do instante k / rate (o relógio da gravação, não o do sono), então
+    // os tempos ficam regulares mesmo com a thread acordando atrasada
+    for (uint64_t k = 0; sampling; ++k) {
+        double time = (double)k / rate;
+        for (uint32_t track = 0; track < tracks; ++track) {
+            TrajectorySample sample = { track, (float)time, samplePosition(track, time) };
+            if (ring.push(sample))
+                ++taken;
+            else
+                ++dropped;
+        }
+
+        Clock::time_point next = begin + chrono::duration_cast<Clock::duration>(period * (double)(k + 1));
+        Clock::time_point now = Clock::now();
+        if (now > next + chrono::duration_cast<Clock::duration>(period * 8.0))
+            k = (uint64_t)(chrono::duration<double>(now - begin).count() * rate); // atraso grande: pula
+        else if (next > now)
+            this_thread::sleep_until(next);
+    }
+    samplerDone = true;
+}
+
+void TrajectoryRecorder::writerLoop()
+{
+    size_t tracks = trackPaths.size();
+    vector<TrajectoryWriter> files(tracks);
+    vector<vector<vec3>> points(tracks);
+    vector<vector<float>> times(tracks);
+    vector<uint64_t> written(tracks, 0);
+    vector<bool> ok(tracks);
+    for (size_t t = 0; t < tracks; ++t)
+        ok[t] = files[t].open(trackPaths[t], TRAJECTORY_TIMES);
+
+    auto flushTrack = [&](size_t t) {
+        if (points[t].empty())
+            return;
+        ok[t] = files[t].append(points[t].data(), points[t].size(), times[t].data()) && ok[t];
+        written[t] += points[t].size();
+        points[t].clear();
+        times[t].clear();
+    };
+
+    vector<TrajectorySample> batch(WRITER_BATCH);
+    while (true) {
+        bool finished = samplerDone.load(); // lido antes do pop: nada escapa no fim
+        size_t count = ring.pop(batch.data(), batch.size());
+        for (size_t i = 0; i < count; ++i) {
+            const TrajectorySample& sample = batch[i];
+            points[sample.track].push_back(sample.position);
+            times[sample.track].push_back(sample.time);
+            if (points[sample.track].size() >= WRITER_BATCH)
+                flushTrack(sample.track);
+        }
+        if (count == 0) {
+            if (finished)
+                break;
+            this_thread::sleep_for(chrono::milliseconds(2));
+        }
+    }
+
+    for (size_t t = 0; t < tracks; ++t) {
+        flushTrack(t);
+        ok[t] = files[t].close() && ok[t];
+
+        // Simplifica o arquivo inteiro de uma vez e o reescreve
+        size_t kept = (size_t)written[t];
+        if (ok[t] && simplifyTolerance > 0.0f) {
+            vector<vec3> path;
+            vector<float> pathTimes;
+            ok[t] = loadTrajectoryFile(trackPaths[t], path, &pathTimes);
+            if (ok[t]) {
+                kept = simplifyTrajectory(path, &pathTimes, simplifyTolerance);
+                ok[t] = saveTrajectoryFile(trackPaths[t], path, TRAJECTORY_TIMES, &pathTimes);
+            }
+        }
+
+        lock_guard<mutex> lock(resultMutex);
+        results.push_back(Result{ trackPaths[t], written[t], kept, (bool)ok[t] });
+    }
+}
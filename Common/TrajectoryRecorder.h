@@ -0,0 +1,92 @@
+/* Gravação de trajetórias em alta frequência
+ *
+ * TrajectoryRecorder amostra as posições de alguns objetos (trilhas) em uma thread
+ * própria, numa taxa fixa (até 1 kHz) que não depende da taxa de quadros. Cada amostra
+ * vai para um anel sem travas de um produtor e um consumidor (SpscRing); uma segunda
+ * thread esvazia o anel e grava cada trilha em um .trj (TrajectoryFile.h) com tempos.
+ * Se o anel encher, a amostra é descartada e contada, sem bloquear a amostragem.
+ *
+ * No fim, cada arquivo é simplificado por Douglas-Peucker: ficam só os pontos que se
+ * afastam mais que a tolerância da reta entre os vizinhos que ficaram.
+ *
+ * A função de amostragem roda na thread de amostragem: ela deve ler só estado que não
+ * muda durante a gravação (por exemplo, avaliar um caminho no tempo pedido).
+ */
+
+#ifndef TRAJECTORY_RECORDER_H
+#define TRAJECTORY_RECORDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "SpscRing.h"
+
+struct TrajectorySample {
+    uint32_t track;
+    float time; // segundos desde o início da gravação
+    glm::vec3 position;
+};
+
+// Douglas-Peucker sobre o caminho (e os tempos, se houver), no lugar. O primeiro e o
+// último ponto sempre ficam. Retorna quantos pontos ficaram
+size_t simplifyTrajectory(std::vector<glm::vec3>& points, std::vector<float>* times, float tolerance);
+
+class TrajectoryRecorder {
+public:
+    struct Result {
+        std::string path;
+        uint64_t samples; // amostras gravadas
+        size_t kept;      // pontos depois da simplificação
+        bool ok;
+    };
+
+    // position(track, time) dá a posição da trilha no instante time da gravação
+    typedef std::function<glm::vec3(uint32_t track, double time)> SampleFunction;
+
+    explicit TrajectoryRecorder(size_t ringCapacity = 1 << 16);
+    ~TrajectoryRecorder();
+
+    // Começa a gravar uma trilha por arquivo de paths, rate amostras por segundo.
+    // tolerance = 0 grava todas as amostras
+    bool start(const std::vector<std::string>& paths, double rate, SampleFunction position, float tolerance);
+
+    // Para a amostragem (espera só a thread de amostragem, no máximo um período). A
+    // escrita termina em segundo plano e os resultados aparecem em popResult()
+    void stop();
+
+    bool recording() const { return sampling.load(); }
+    uint64_t samplesTaken() const { return taken.load(); }
+    uint64_t samplesDropped() const { return dropped.load(); }
+
+    // Próximo arquivo terminado, para avisar na thread principal
+    bool popResult(Result& result);
+
+private:
+    void samplerLoop(double rate);
+    void writerLoop();
+    void join();
+
+    SpscRing<TrajectorySample> ring;
+    std::vector<std::string> trackPaths;
+    SampleFunction samplePosition;
+    float simplifyTolerance = 0.0f;
+
+    std::thread sampler;
+    std::thread writer;
+    std::atomic<bool> sampling{false};
+    std::atomic<bool> samplerDone{true};
+    std::atomic<uint64_t> taken{0};
+    std::atomic<uint64_t> dropped{0};
+
+    std::mutex resultMutex;
+    std::vector<Result> results;
+};
+
+#endif
@@ -0,0 +1,130 @@
+/* Benchmark - avaliação de trilhas de quadros-chave (AnimationSet)
+ *
+ * N entidades com trilhas de posição, rotação e escala, compartilhando 16 curvas de
+ * 8 chaves em fases diferentes. Mede por quadro:
+ *  - a busca da chave por pesquisa binária em cada amostra (referência);
+ *  - evaluateAnimations() com o cursor de cada trilha, em uma thread e com o JobSystem;
+ *  - updateTransforms() das entidades animadas.
+ *
+ * Uso: AnimationBench [quantidade de entidades] [quadros] [threads]
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "AnimationTracks.h"
+#include "BenchmarkReport.h"
+#include "EntityWorld.h"
+#include "JobSystem.h"
+#include "QuatMatrix.h"
+
+using namespace std;
+using namespace glm;
+
+// Referência: sem cursor, pesquisa binária da chave a cada amostra
+static void evaluateBinarySearch(EntityWorld& world, const AnimationSet& set, float time)
+{
+    for (int target = 0; target < 3; ++target) {
+        const AnimationSet::TrackList& list = set.tracks[target];
+        for (size_t i = 0; i < list.entities.size(); ++i) {
+            uint32_t curve = list.curves[i];
+            const float* times = set.keyTimes.data() + set.curveFirst[curve];
+            const vec4* values = set.keyValues.data() + set.curveFirst[curve];
+            uint32_t count = set.curveKeys[curve];
+            float length = times[count - 1] - times[0];
+            float t = times[0] + fmod(time * list.speeds[i] + list.offsets[i] - times[0], length);
+            size_t k = std::min<size_t>(upper_bound(times, times + count, t) - times, count - 1);
+            k = k > 0 ? k - 1 : 0;
+            float u = (t - times[k]) / (times[k + 1] - times[k]);
+            vec4 value = mix(values[k], values[k + 1], u);
+            Entity entity = list.entities[i];
+            if (target == TRACK_POSITION)
+                world.positions[entity] = vec3(value);
+            else if (target == TRACK_ROTATION)
+                world.rotations[entity] = normalize(quat(value.w, value.x, value.y, value.z));
+            else
+                world.scales[entity] = vec3(value);
+            world.markDirty(entity);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t entityCount = argc > 1 ? (size_t)atol(argv[1]) : 100000;
+    int frames = argc > 2 ? atoi(argv[2]) : 100;
+    unsigned threads = argc > 3 ? (unsigned)atoi(argv[3]) : 0;
+    const float deltaTime = 1.0f / 60.0f;
+
+    mt19937 rng(7);
+    uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    // 16 curvas de cada componente, 8 chaves a cada 0,5 s
+    AnimationSet set;
+    uint32_t curves[3][16];
+    for (int target = 0; target < 3; ++target)
+        for (int c = 0; c < 16; ++c) {
+            float times[8];
+            vec4 values[8];
+            for (int k = 0; k < 8; ++k) {
+                times[k] = 0.5f * k;
+                if (target == TRACK_ROTATION) {
+                    quat rotation = quatFromEulerDegrees(vec3(unit(rng), unit(rng), unit(rng)) * 60.0f);
+                    values[k] = vec4(rotation.x, rotation.y, rotation.z, rotation.w);
+                }
+                else if (target == TRACK_SCALE) {
+                    values[k] = vec4(vec3(1.0f + 0.3f * unit(rng)), 0.0f);
+                }
+                else {
+                    values[k] = vec4(unit(rng) * 20.0f, unit(rng) * 5.0f, unit(rng) * 20.0f, 0.0f);
+                }
+            }
+            curves[target][c] = set.addCurve(times, values, 8);
+        }
+
+    EntityWorld world;
+    world.reserve(entityCount);
+    for (size_t i = 0; i < entityCount; ++i) {
+        Entity entity = world.create("obj" + to_string(i));
+        for (int target = 0; target < 3; ++target)
+            set.addTrack(entity, (TrackTarget)target, curves[target][rng() % 16], 0.75f + 0.25f * unit(rng),
+                         2.0f * unit(rng));
+    }
+    updateTransforms(world);
+
+    double binaryTime = measureMilliseconds([&] {
+        for (int frame = 0; frame < frames; ++frame)
+            evaluateBinarySearch(world, set, frame * deltaTime);
+    });
+    double cursorTime = measureMilliseconds([&] {
+        for (int frame = 0; frame < frames; ++frame)
+            evaluateAnimations(world, set, frame * deltaTime);
+    });
+
+    JobSystem jobs(threads);
+    double jobsTime = measureMilliseconds([&] {
+        for (int frame = 0; frame < frames; ++frame)
+            evaluateAnimations(world, set, frame * deltaTime, INVALID_ENTITY, &jobs);
+    });
+    double transformTime = measureMilliseconds([&] {
+        for (int frame = 0; frame < frames; ++frame) {
+            evaluateAnimations(world, set, frame * deltaTime, INVALID_ENTITY, &jobs);
+            updateTransforms(world, &jobs);
+        }
+    });
+
+    cout << entityCount << " entidades, " << set.trackCount() << " trilhas, " << frames << " quadros" << endl;
+    cout << "  pesquisa binaria:          " << binaryTime / frames << " ms/quadro" << endl;
+    cout << "  cursor, 1 thread:          " << cursorTime / frames << " ms/quadro" << endl;
+    cout << "  cursor, " << jobs.threadCount() << " thread(s):        " << jobsTime / frames << " ms/quadro" << endl;
+    cout << "  trilhas + transformacoes:  " << transformTime / frames << " ms/quadro" << endl;
+    return 0;
+}
@@ -0,0 +1,216 @@
+/* Benchmark - gravação de comandos em paralelo x desenho imediato
+ *
+ * N objetos com 4 programas, 16 texturas e 8 VAOs (um triângulo cada, em um viewport
+ * de 1x1 pixel, para medir o custo de CPU do envio):
+ *  - imediato: como o drawObject() antigo, um objeto por vez na thread do OpenGL,
+ *    com glGetUniformLocation e trocas de estado por objeto;
+ *  - listas: gravação dos comandos com 1..T threads (JobSystem), junção/ordenação
+ *    e execução pela CommandExecutorGL.
+ *
+ * Uso: CommandListBench [quantidade de objetos] [threads máximas]
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "BenchmarkReport.h"
+#include "CommandExecutorGL.h"
+#include "CommandList.h"
+#include "JobSystem.h"
+
+using namespace std;
+using namespace glm;
+
+const char* vertexShaderSource = R"(
+#version 400 core
+layout (location = 0) in vec3 aPos;
+uniform mat4 model;
+uniform mat3 normalMatrix;
+out vec3 Normal;
+void main()
+{
+    gl_Position = model * vec4(aPos, 1.0);
+    Normal = normalMatrix * vec3(0.0, 0.0, 1.0);
+}
+)";
+
+const char* fragmentShaderSource = R"(
+#version 400 core
+in vec3 Normal;
+uniform vec3 Ka, Kd, Ks;
+uniform float shininess;
+uniform sampler2D tex;
+out vec4 FragColor;
+void main()
+{
+    FragColor = vec4(Ka + Kd * texture(tex, vec2(0.5)).rgb + Ks * pow(max(Normal.z, 0.0), shininess), 1.0);
+}
+)";
+
+struct BenchObject {
+    GLuint program, vertexArray, texture;
+    mat4 model;
+    mat3 normalMatrix;
+    vec3 ka, kd, ks;
+    float shininess;
+    float depth;
+};
+
+static GLuint buildProgram()
+{
+    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
+    glCompileShader(vertexShader);
+    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
+    glCompileShader(fragmentShader);
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    glLinkProgram(program);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+    return program;
+}
+
+// Caminho antigo: uma entidade por vez, consultando os uniforms a cada desenho
+static void drawImmediate(const vector<BenchObject>& objects)
+{
+    for (const BenchObject& object : objects) {
+        glUseProgram(object.program);
+        glBindTexture(GL_TEXTURE_2D, object.texture);
+        glUniformMatrix4fv(glGetUniformLocation(object.program, "model"), 1, GL_FALSE, value_ptr(object.model));
+        glUniformMatrix3fv(glGetUniformLocation(object.program, "normalMatrix"), 1, GL_FALSE, value_ptr(object.normalMatrix));
+        glUniform3fv(glGetUniformLocation(object.program, "Ka"), 1, value_ptr(object.ka));
+        glUniform3fv(glGetUniformLocation(object.program, "Kd"), 1, value_ptr(object.kd));
+        glUniform3fv(glGetUniformLocation(object.program, "Ks"), 1, value_ptr(object.ks));
+        glUniform1f(glGetUniformLocation(object.program, "shininess"), object.shininess);
+        glBindVertexArray(object.vertexArray);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glBindVertexArray(0);
+    }
+}
+
+static void record(JobSystem& jobs, CommandQueue& queue, const vector<BenchObject>& objects)
+{
+    queue.reset();
+    jobs.parallelFor(objects.size(), 1024, [&](size_t begin, size_t end) {
+        CommandList& list = queue.list(JobSystem::workerIndex());
+        for (size_t i = begin; i < end; ++i) {
+            const BenchObject& object = objects[i];
+            uint64_t key = drawSortKey(object.program, object.texture, object.vertexArray, object.depth);
+            DrawUniforms& uniforms = list.draw(key, (uint32_t)i, object.program, object.vertexArray, object.texture, 0, 3);
+            uniforms.model = object.model;
+            uniforms.normalMatrix = object.normalMatrix;
+            uniforms.ka = object.ka;
+            uniforms.kd = object.kd;
+            uniforms.ks = object.ks;
+            uniforms.shininess = object.shininess;
+        }
+    });
+}
+
+int main(int argc, char** argv)
+{
+    size_t objectCount = argc > 1 ? (size_t)atol(argv[1]) : 100000;
+    unsigned maxThreads = argc > 2 ? (unsigned)atoi(argv[2]) : std::max(1u, thread::hardware_concurrency());
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(64, 64, "CommandListBench", nullptr, nullptr);
+    if (!window) {
+        cout << "Falha ao criar o contexto OpenGL" << endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        cout << "Failed to initialize GLAD" << endl;
+        return -1;
+    }
+    glViewport(0, 0, 1, 1);
+
+    // Recursos compartilhados pelos objetos
+    GLuint programs[4], vertexArrays[8], textures[16];
+    for (GLuint& program : programs)
+        program = buildProgram();
+    float triangle[9] = { -0.5f, -0.5f, 0.0f, 0.5f, -0.5f, 0.0f, 0.0f, 0.5f, 0.0f };
+    for (GLuint& vertexArray : vertexArrays) {
+        GLuint buffer;
+        glGenVertexArrays(1, &vertexArray);
+        glGenBuffers(1, &buffer);
+        glBindVertexArray(vertexArray);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(triangle), triangle, GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (GLvoid*)0);
+        glEnableVertexAttribArray(0);
+    }
+    glBindVertexArray(0);
+    glGenTextures(16, textures);
+    for (GLuint texture : textures) {
+        unsigned char pixel[4] = { 200, 100, 50, 255 };
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    }
+
+    mt19937 rng(5);
+    uniform_real_distribution<float> unit(0.0f, 1.0f);
+    vector<BenchObject> objects(objectCount);
+    for (BenchObject& object : objects) {
+        object.program = programs[rng() % 4];
+        object.vertexArray = vertexArrays[rng() % 8];
+        object.texture = textures[rng() % 16];
+        object.model = translate(mat4(1.0f), vec3(unit(rng) - 0.5f, unit(rng) - 0.5f, 0.0f));
+        object.normalMatrix = mat3(1.0f);
+        object.ka = vec3(0.1f);
+        object.kd = vec3(unit(rng));
+        object.ks = vec3(0.5f);
+        object.shininess = 32.0f;
+        object.depth = unit(rng);
+    }
+
+    // Aquecimento do driver
+    drawImmediate(objects);
+    glFinish();
+
+    double immediate = measureMilliseconds([&] { drawImmediate(objects); glFinish(); });
+    cout << objectCount << " objetos (" << glGetString(GL_RENDERER) << ")" << endl;
+    cout << "  imediato (thread do OpenGL faz tudo): " << immediate << " ms" << endl;
+
+    CommandExecutorGL executor;
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        JobSystem jobs(threads);
+        CommandQueue queue(jobs.threadCount());
+        record(jobs, queue, objects);
+        queue.merge();
+        executor.execute(queue);
+        glFinish();
+
+        double recordTime = measureMilliseconds([&] { record(jobs, queue, objects); });
+        double mergeTime = measureMilliseconds([&] { queue.merge(); });
+        double executeTime = measureMilliseconds([&] { executor.execute(queue); glFinish(); });
+        cout << "  listas, " << threads << " thread(s): gravacao " << recordTime << " ms, ordenacao "
+             << mergeTime << " ms, execucao " << executeTime << " ms, " << executor.lastStateChanges()
+             << " trocas de estado (imediato: " << 3 * objectCount << ")" << endl;
+        if (threads * 2 > maxThreads && threads != maxThreads)
+            threads = maxThreads / 2;
+    }
+
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,149 @@
+/* Benchmark - atualização de entidades em SoA (EntityWorld) x objetos em AoS
+ *
+ * Cria N entidades filhas de alvos, orbitando em volta deles (como o flamingo filho de
+ * Marte), e mede o tempo por quadro dos sistemas updateOrbits() + updateTransforms()
+ * do EntityWorld. Também mede um quadro sem animação (nada marcado como alterado) e
+ * um quadro em que só um alvo se move, que recalcula apenas a sua subárvore.
+ *
+ * A referência é o formato anterior do TrabalhoGB: um objeto por struct, com o tipo
+ * de animação e o alvo da órbita como strings resolvidas em um map a cada quadro,
+ * e a matriz montada com glm::translate/rotate/scale e a inversa da normal no glm.
+ *
+ * Uso: EntityBench [quantidade de entidades] [quadros]
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "BenchmarkReport.h"
+#include "EntityWorld.h"
+
+using namespace std;
+using namespace glm;
+
+// Formato anterior: tudo do objeto junto, com strings
+struct LegacyObject {
+    string name;
+    vec3 position, rotation, scale;
+    string animation;
+    string orbitTarget;
+    float orbitRadius, orbitSpeed, orbitAngle;
+    Material material;
+    mat4 model;
+    mat3 normalMatrix;
+};
+
+int main(int argc, char** argv)
+{
+    size_t entityCount = argc > 1 ? (size_t)atol(argv[1]) : 1000000;
+    int frames = argc > 2 ? atoi(argv[2]) : 20;
+    const size_t targetCount = 64; // as primeiras entidades ficam paradas e servem de alvo
+    const float deltaTime = 1.0f / 60.0f;
+
+    mt19937 rng(1);
+    uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    EntityWorld world;
+    vector<LegacyObject> legacy(entityCount);
+    map<string, size_t> legacyByName;
+    world.reserve(entityCount);
+    for (size_t i = 0; i < entityCount; ++i) {
+        string name = "obj" + to_string(i);
+        vec3 position(unit(rng) * 50.0f, unit(rng) * 5.0f, unit(rng) * 50.0f);
+        vec3 scale(0.5f + 0.4f * unit(rng));
+        Entity entity = world.create(name);
+        world.positions[entity] = position;
+        world.scales[entity] = scale;
+
+        LegacyObject& object = legacy[i];
+        object.name = name;
+        object.position = position;
+        object.rotation = vec3(0.0f);
+        object.scale = scale;
+        object.animation = "none";
+        object.orbitAngle = 0.0f;
+        legacyByName[name] = i;
+
+        if (i >= targetCount) {
+            size_t target = (size_t)(unit(rng) * 0.5f * targetCount + 0.5f * targetCount) % targetCount;
+            float radius = 1.0f + 4.0f * (unit(rng) * 0.5f + 0.5f);
+            float speed = 0.2f + 0.5f * (unit(rng) * 0.5f + 0.5f);
+            world.animations[entity] = ANIMATION_ORBIT;
+            world.setParent(entity, (Entity)target);
+            world.positions[entity].y = position.y - legacy[target].position.y;
+            world.orbitRadii[entity] = radius;
+            world.orbitSpeeds[entity] = speed;
+            object.animation = "orbit";
+            object.orbitTarget = "obj" + to_string(target);
+            object.orbitRadius = radius;
+            object.orbitSpeed = speed;
+        }
+    }
+
+    // Monta a ordem da hierarquia fora da medição (só muda quando um pai muda)
+    double hierarchyTime = measureMilliseconds([&] { updateTransforms(world); });
+
+    double soaTime = 0.0, legacyTime = 0.0;
+    for (int frame = 0; frame < frames; ++frame) {
+        soaTime += measureMilliseconds([&] {
+            updateOrbits(world, deltaTime);
+            updateTransforms(world);
+        });
+        legacyTime += measureMilliseconds([&] {
+            for (LegacyObject& object : legacy) {
+                if (object.animation == "orbit") {
+                    object.orbitAngle += object.orbitSpeed * deltaTime;
+                    const vec3& center = legacy[legacyByName[object.orbitTarget]].position;
+                    object.position.x = center.x + object.orbitRadius * cos(object.orbitAngle);
+                    object.position.z = center.z + object.orbitRadius * sin(object.orbitAngle);
+                    object.rotation.y = degrees(object.orbitAngle) + 90.0f;
+                }
+                mat4 model = translate(mat4(1.0f), object.position);
+                model = rotate(model, radians(object.rotation.x), vec3(1.0f, 0.0f, 0.0f));
+                model = rotate(model, radians(object.rotation.y), vec3(0.0f, 1.0f, 0.0f));
+                model = rotate(model, radians(object.rotation.z), vec3(0.0f, 0.0f, 1.0f));
+                object.model = glm::scale(model, object.scale);
+                object.normalMatrix = mat3(transpose(inverse(object.model)));
+            }
+        });
+    }
+
+    // Quadro parado: nenhuma entidade alterada
+    size_t staticChanged = 0;
+    double staticTime = measureMilliseconds([&] { staticChanged = updateTransforms(world); });
+
+    // Só um alvo se move: recalcula ele e os seus filhos
+    size_t subtreeChanged = 0;
+    world.positions[0].x += 1.0f;
+    world.markDirty(0);
+    double subtreeTime = measureMilliseconds([&] { subtreeChanged = updateTransforms(world); });
+    world.positions[0].x -= 1.0f;
+    world.markDirty(0);
+    updateTransforms(world);
+
+    // Confere que os dois caminhos chegam ao mesmo resultado
+    float maxError = 0.0f;
+    for (size_t i = 0; i < entityCount; ++i)
+        for (int c = 0; c < 4; ++c)
+            for (int l = 0; l < 4; ++l)
+                maxError = std::max(maxError, std::abs(world.models[i][c][l] - legacy[i].model[c][l]));
+
+    cout << entityCount << " entidades, " << frames << " quadros" << endl;
+    cout << "  EntityWorld (SoA):  " << soaTime / frames << " ms/quadro" << endl;
+    cout << "  objetos AoS + map:  " << legacyTime / frames << " ms/quadro" << endl;
+    cout << "  ganho: " << legacyTime / soaTime << "x" << endl;
+    cout << "  montagem da hierarquia: " << hierarchyTime << " ms" << endl;
+    cout << "  quadro parado:      " << staticTime << " ms (" << staticChanged << " recalculadas)" << endl;
+    cout << "  um alvo movido:     " << subtreeTime << " ms (" << subtreeChanged << " recalculadas)" << endl;
+    cout << "  diferenca maxima nas matrizes: " << maxError << endl;
+    return 0;
+}
@@ -0,0 +1,186 @@
+/* Benchmark - arena por quadro e pools x heap, e verificação de alocações por quadro
+ *
+ *  1) Dados temporários de um quadro (lista de desenhos montada e ordenada a cada
+ *     quadro): std::vector no heap x ArenaVector na FrameAllocator;
+ *  2) Nós de std::map inseridos e removidos: alocador padrão x PoolAllocator;
+ *  3) Quadro da CPU do TrabalhoGB (órbitas, transformações, culling, gravação e
+ *     ordenação dos comandos) com o JobSystem: depois do aquecimento, conta as
+ *     alocações no heap com o AllocationCounter. Retorna 1 se algum quadro alocar.
+ *
+ * Uso: FrameAllocatorBench [quantidade de entidades] [quadros] [threads]
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "AllocationCounter.h"
+#include "BenchmarkReport.h"
+#include "CommandList.h"
+#include "EntityWorld.h"
+#include "FrameAllocator.h"
+#include "JobSystem.h"
+
+using namespace std;
+using namespace glm;
+
+struct DrawItem {
+    uint64_t key;
+    uint32_t entity;
+};
+
+// Monta e ordena a lista de desenhos do quadro em um vetor vazio
+template <typename Vector>
+static uint64_t buildDrawList(Vector& items, size_t count, uint32_t frame)
+{
+    for (uint32_t i = 0; i < count; ++i)
+        items.push_back({ (uint64_t)((i * 2654435761u) ^ frame), i });
+    sort(items.begin(), items.end(), [](const DrawItem& a, const DrawItem& b) { return a.key < b.key; });
+    return items.front().key;
+}
+
+int main(int argc, char** argv)
+{
+    size_t entityCount = argc > 1 ? (size_t)atol(argv[1]) : 100000;
+    int frames = argc > 2 ? atoi(argv[2]) : 100;
+    unsigned threads = argc > 3 ? (unsigned)atoi(argv[3]) : 0;
+    uint64_t checksum = 0;
+
+    // 1) Temporários por quadro
+    {
+        size_t before = allocationCount();
+        double heapTime = measureMilliseconds([&] {
+            for (int frame = 0; frame < frames; ++frame) {
+                vector<DrawItem> items;
+                checksum += buildDrawList(items, entityCount, frame);
+            }
+        });
+        double heapAllocations = (double)(allocationCount() - before) / frames;
+
+        FrameAllocator frameMemory(entityCount * sizeof(DrawItem) * 4);
+        before = allocationCount();
+        double arenaTime = measureMilliseconds([&] {
+            for (int frame = 0; frame < frames; ++frame) {
+                frameMemory.beginFrame();
+                ArenaVector<DrawItem> items{ ArenaAllocator<DrawItem>(frameMemory.current()) };
+                checksum += buildDrawList(items, entityCount, frame);
+            }
+        });
+        double arenaAllocations = (double)(allocationCount() - before) / frames;
+
+        cout << "Lista de desenhos temporaria (" << entityCount << " itens, " << frames << " quadros)" << endl;
+        cout << "  std::vector: " << heapTime / frames << " ms/quadro, " << heapAllocations << " alocacoes/quadro" << endl;
+        cout << "  FrameAllocator: " << arenaTime / frames << " ms/quadro, " << arenaAllocations << " alocacoes/quadro" << endl;
+    }
+
+    // 2) Nós de std::map
+    {
+        const int keys = 100000;
+        size_t before = allocationCount();
+        double heapTime = measureMilliseconds([&] {
+            map<int, float> nodes;
+            for (int round = 0; round < 10; ++round) {
+                for (int i = 0; i < keys; ++i)
+                    nodes[(i * 7919) % keys] = (float)i;
+                for (int i = 0; i < keys; i += 2)
+                    nodes.erase(i);
+            }
+            checksum += nodes.size();
+        });
+        size_t heapAllocations = allocationCount() - before;
+
+        PoolSet pools;
+        before = allocationCount();
+        double poolTime = measureMilliseconds([&] {
+            PoolMap<int, float> nodes{ PoolAllocator<pair<const int, float>>(pools) };
+            for (int round = 0; round < 10; ++round) {
+                for (int i = 0; i < keys; ++i)
+                    nodes[(i * 7919) % keys] = (float)i;
+                for (int i = 0; i < keys; i += 2)
+                    nodes.erase(i);
+            }
+            checksum += nodes.size();
+        });
+        size_t poolAllocations = allocationCount() - before;
+
+        cout << "std::map com " << keys << " chaves, 10 rodadas de insercao/remocao" << endl;
+        cout << "  alocador padrao: " << heapTime << " ms, " << heapAllocations << " alocacoes" << endl;
+        cout << "  PoolAllocator: " << poolTime << " ms, " << poolAllocations << " alocacoes" << endl;
+    }
+
+    // 3) Quadro da CPU em regime permanente
+    JobSystem jobs(threads);
+    mt19937 rng(3);
+    uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    EntityWorld world;
+    world.reserve(entityCount);
+    for (size_t i = 0; i < entityCount; ++i) {
+        Entity entity = world.create("obj" + to_string(i));
+        world.positions[entity] = vec3(unit(rng) * 50.0f, unit(rng) * 5.0f, unit(rng) * 50.0f);
+        world.vaos[entity] = 1 + (GLuint)(i % 8);
+        world.vertexCounts[entity] = 36;
+        world.textures[entity] = 1 + (GLuint)(i % 16);
+        world.boundingRadii[entity] = 1.0f;
+        if (i >= 64) {
+            world.setParent(entity, (Entity)(i % 64));
+            world.animations[entity] = ANIMATION_ORBIT;
+            world.orbitRadii[entity] = 2.0f + 3.0f * unit(rng);
+            world.orbitSpeeds[entity] = 30.0f * unit(rng);
+        }
+    }
+
+    mat4 projection = perspective(radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    mat4 view = lookAt(vec3(0.0f, 20.0f, 60.0f), vec3(0.0f), vec3(0.0f, 1.0f, 0.0f));
+    CommandQueue queue(jobs.threadCount());
+    auto frame = [&] {
+        jobs.parallelFor(world.size(), 4096, [&](size_t begin, size_t end) {
+            updateOrbits(world, 1.0f / 60.0f, INVALID_ENTITY, begin, end - begin);
+        });
+        updateTransforms(world, &jobs);
+        cullEntities(world, projection * view, &jobs);
+        queue.reset();
+        jobs.parallelFor(world.size(), 1024, [&](size_t begin, size_t end) {
+            CommandList& list = queue.list(JobSystem::workerIndex());
+            for (Entity entity = (Entity)begin; entity < end; ++entity) {
+                if (!world.visible[entity])
+                    continue;
+                float depth = -(view * world.models[entity][3]).z / 100.0f;
+                uint64_t key = drawSortKey(1, world.textures[entity], world.vaos[entity], depth);
+                DrawUniforms& uniforms = list.draw(key, entity, 1, world.vaos[entity], world.textures[entity],
+                                                   0, world.vertexCounts[entity]);
+                uniforms.model = world.models[entity];
+                uniforms.normalMatrix = world.normalMatrices[entity];
+            }
+        });
+        queue.merge();
+    };
+
+    // Aquecimento: os vetores reaproveitados crescem até o tamanho de regime
+    for (int i = 0; i < 10; ++i)
+        frame();
+
+    size_t before = allocationCount();
+    size_t maxFrameAllocations = 0;
+    double frameTime = measureMilliseconds([&] {
+        for (int i = 0; i < frames; ++i) {
+            size_t frameStart = allocationCount();
+            frame();
+            maxFrameAllocations = std::max(maxFrameAllocations, allocationCount() - frameStart);
+        }
+    });
+    size_t total = allocationCount() - before;
+
+    cout << "Quadro da CPU (" << entityCount << " entidades, " << jobs.threadCount() << " threads, "
+         << queue.sorted().size() << " desenhos): " << frameTime / frames << " ms/quadro" << endl;
+    cout << "  alocacoes no heap: " << total << " em " << frames << " quadros (maximo " << maxFrameAllocations
+         << " em um quadro) -> " << (total == 0 ? "OK" : "FALHOU") << endl;
+    cout << "(checksum " << checksum << ")" << endl;
+    return total == 0 ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+/* Benchmark - escalabilidade do sistema de jobs
+ *
+ * Mesma cena do EntityBench (N entidades filhas de 64 alvos, orbitando em volta deles).
+ * Cada quadro roda as órbitas, as transformações e o culling do EntityWorld, primeiro
+ * sem JobSystem (serial) e depois com 1, 2, 4, ... threads, até o número de núcleos
+ * (ou o máximo pedido). Também confere que as matrizes batem com as da versão serial.
+ *
+ * Uso: JobSystemBench [quantidade de entidades] [quadros] [threads máximas]
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "BenchmarkReport.h"
+#include "EntityWorld.h"
+#include "JobSystem.h"
+
+using namespace std;
+using namespace glm;
+
+static void buildWorld(EntityWorld& world, size_t entityCount)
+{
+    const size_t targetCount = 64;
+    mt19937 rng(1);
+    uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    world.clear();
+    world.reserve(entityCount);
+    for (size_t i = 0; i < entityCount; ++i) {
+        Entity entity = world.create("");
+        world.positions[entity] = vec3(unit(rng) * 50.0f, unit(rng) * 5.0f, unit(rng) * 50.0f);
+        world.scales[entity] = vec3(0.5f + 0.4f * unit(rng));
+        world.boundingRadii[entity] = 1.0f;
+        if (i >= targetCount) {
+            world.setParent(entity, (Entity)((i * 2654435761u) % targetCount));
+            world.positions[entity].x = world.positions[entity].z = 0.0f;
+            world.animations[entity] = ANIMATION_ORBIT;
+            world.orbitRadii[entity] = 1.0f + 2.0f * (unit(rng) + 1.0f);
+            world.orbitSpeeds[entity] = 0.2f + 0.25f * (unit(rng) + 1.0f);
+        }
+    }
+    updateTransforms(world);
+}
+
+// Um quadro: órbitas, transformações e culling
+static size_t simulateFrame(EntityWorld& world, JobSystem* jobs, const mat4& viewProjection)
+{
+    const float step = 1.0f / 60.0f;
+    if (jobs) {
+        jobs->parallelFor(world.size(), 4096, [&](size_t begin, size_t end) {
+            updateOrbits(world, step, INVALID_ENTITY, begin, end - begin);
+        });
+    } else {
+        updateOrbits(world, step);
+    }
+    updateTransforms(world, jobs);
+    return cullEntities(world, viewProjection, jobs);
+}
+
+int main(int argc, char** argv)
+{
+    size_t entityCount = argc > 1 ? (size_t)atol(argv[1]) : 1000000;
+    int frames = argc > 2 ? atoi(argv[2]) : 20;
+    unsigned maxThreads = argc > 3 ? (unsigned)atoi(argv[3]) : std::max(1u, thread::hardware_concurrency());
+
+    mat4 viewProjection = perspective(radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f) *
+                          lookAt(vec3(0.0f, 30.0f, 60.0f), vec3(0.0f), vec3(0.0f, 1.0f, 0.0f));
+
+    EntityWorld reference;
+    buildWorld(reference, entityCount);
+    size_t visibleCount = 0;
+    double serialTime = measureMilliseconds([&] {
+        for (int frame = 0; frame < frames; ++frame)
+            visibleCount = simulateFrame(reference, nullptr, viewProjection);
+    }) / frames;
+
+    cout << entityCount << " entidades, " << frames << " quadros, "
+         << thread::hardware_concurrency() << " nucleos" << endl;
+    cout << "  serial (sem JobSystem): " << serialTime << " ms/quadro, " << visibleCount << " visiveis" << endl;
+
+    EntityWorld world;
+    for (unsigned threads = 1; threads <= maxThreads; threads = threads < maxThreads && threads * 2 > maxThreads ? maxThreads : threads * 2) {
+        buildWorld(world, entityCount);
+        double time;
+        {
+            JobSystem jobs(threads);
+            time = measureMilliseconds([&] {
+                for (int frame = 0; frame < frames; ++frame)
+                    visibleCount = simulateFrame(world, &jobs, viewProjection);
+            }) / frames;
+        }
+
+        float maxError = 0.0f;
+        for (size_t i = 0; i < entityCount; ++i)
+            for (int c = 0; c < 4; ++c)
+                for (int l = 0; l < 4; ++l)
+                    maxError = std::max(maxError, std::abs(world.models[i][c][l] - reference.models[i][c][l]));
+
+        cout << "  " << threads << " thread(s): " << time << " ms/quadro, ganho " << serialTime / time
+             << "x, " << visibleCount << " visiveis, diferenca maxima " << maxError << endl;
+        if (threads == maxThreads)
+            break;
+    }
+    return 0;
+}
@@ -0,0 +1,252 @@
+/* Benchmark - matriz de normais por vértice x por objeto
+ *
+ * Parte 1 (CPU): tempo para calcular as matrizes de normais de muitos objetos com
+ * glm (transpose(inverse())), com a versão escalar de NormalMatrix.h e com a versão SSE.
+ *
+ * Parte 2 (GPU): desenho limitado pelos vértices (pontos em um viewport de 1x1 pixel),
+ * comparando o vertex shader antigo, que faz mat3(transpose(inverse(model))) para cada
+ * vértice, com o novo, que recebe uniform mat3 normalMatrix. O tempo de GPU é medido
+ * com consultas GL_TIME_ELAPSED.
+ *
+ * Uso: NormalMatrixBench [quantidade de vértices] [quantidade de objetos]
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "BenchmarkReport.h"
+#include "NormalMatrix.h"
+
+using namespace std;
+using namespace glm;
+
+const char* vertexShaderHeader = R"(
+#version 400 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+uniform mat4 projection;
+uniform mat4 view;
+uniform mat4 model;
+uniform mat3 normalMatrix;
+out vec3 Normal;
+void main()
+{
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+)";
+
+// Versão antiga: inversa 4x4 por vértice
+const char* perVertexInverseSource = R"(
+    Normal = mat3(transpose(inverse(model))) * aNormal;
+}
+)";
+
+// Versão nova: matriz de normais calculada na CPU
+const char* uniformNormalMatrixSource = R"(
+    Normal = normalMatrix * aNormal;
+}
+)";
+
+const char* fragmentShaderSource = R"(
+#version 400 core
+in vec3 Normal;
+out vec4 FragColor;
+void main()
+{
+    FragColor = vec4(normalize(Normal) * 0.5 + 0.5, 1.0);
+}
+)";
+
+static GLuint buildProgram(const char* vertexBody)
+{
+    const char* vertexSources[2] = { vertexShaderHeader, vertexBody };
+    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertexShader, 2, vertexSources, NULL);
+    glCompileShader(vertexShader);
+    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
+    glCompileShader(fragmentShader);
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    glLinkProgram(program);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        GLchar infoLog[512];
+        glGetProgramInfoLog(program, 512, NULL, infoLog);
+        cout << "Erro ao linkar o shader:\n" << infoLog << endl;
+        return 0;
+    }
+    return program;
+}
+
+static void cpuBenchmark(size_t objectCount)
+{
+    mt19937 rng(42);
+    uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    vector<mat4> models(objectCount);
+    for (mat4& model : models) {
+        model = translate(mat4(1.0f), vec3(unit(rng), unit(rng), unit(rng)) * 10.0f);
+        model = rotate(model, unit(rng) * 3.14159f, normalize(vec3(unit(rng), unit(rng), unit(rng)) + vec3(0.0f, 0.0f, 1.5f)));
+        model = glm::scale(model, vec3(1.5f) + vec3(unit(rng), unit(rng), unit(rng)));
+    }
+    vector<mat3> reference(objectCount), scalar(objectCount), simd(objectCount);
+
+    const int repeats = 5;
+    double glmTime = 1e30, scalarTime = 1e30, simdTime = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        glmTime = std::min(glmTime, measureMilliseconds([&] {
+            for (size_t i = 0; i < objectCount; ++i)
+                reference[i] = mat3(transpose(inverse(models[i])));
+        }));
+        scalarTime = std::min(scalarTime, measureMilliseconds([&] {
+            computeNormalMatricesScalar(models.data(), scalar.data(), objectCount);
+        }));
+        simdTime = std::min(simdTime, measureMilliseconds([&] {
+            computeNormalMatrices(models.data(), simd.data(), objectCount);
+        }));
+    }
+
+    // Erro relativo máximo em relação à inversa completa do glm
+    float maxError = 0.0f;
+    for (size_t i = 0; i < objectCount; ++i)
+        for (int c = 0; c < 3; ++c)
+            for (int l = 0; l < 3; ++l) {
+                float expected = reference[i][c][l];
+                maxError = std::max(maxError, std::abs(simd[i][c][l] - expected) / std::max(1.0f, std::abs(expected)));
+                maxError = std::max(maxError, std::abs(scalar[i][c][l] - expected) / std::max(1.0f, std::abs(expected)));
+            }
+
+    cout << "CPU: " << objectCount << " matrizes de normais" << endl;
+    cout << "  glm transpose(inverse(mat4)): " << glmTime << " ms" << endl;
+    cout << "  escalar (produtos vetoriais): " << scalarTime << " ms" << endl;
+    cout << "  SSE (4 matrizes por vez):     " << simdTime << " ms" << endl;
+    cout << "  erro relativo maximo: " << maxError << endl;
+}
+
+static double gpuTime(GLuint program, GLuint VAO, GLsizei vertexCount, const mat4& model, const mat3& normalMatrix)
+{
+    glUseProgram(program);
+    mat4 view = lookAt(vec3(0.0f, 0.0f, 3.0f), vec3(0.0f), vec3(0.0f, 1.0f, 0.0f));
+    mat4 projection = perspective(radians(45.0f), 1.0f, 0.1f, 100.0f);
+    glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, value_ptr(projection));
+    glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, value_ptr(view));
+    glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_FALSE, value_ptr(model));
+    glUniformMatrix3fv(glGetUniformLocation(program, "normalMatrix"), 1, GL_FALSE, value_ptr(normalMatrix));
+    glBindVertexArray(VAO);
+
+    // Aquecimento (compilação tardia do driver, caches)
+    glDrawArrays(GL_POINTS, 0, vertexCount);
+    glFinish();
+
+    const int repeats = 10;
+    GLuint query;
+    glGenQueries(1, &query);
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        glBeginQuery(GL_TIME_ELAPSED, query);
+        glDrawArrays(GL_POINTS, 0, vertexCount);
+        glEndQuery(GL_TIME_ELAPSED);
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+        best = std::min(best, nanoseconds / 1.0e6);
+    }
+    glDeleteQueries(1, &query);
+    glBindVertexArray(0);
+    return best;
+}
+
+static void gpuBenchmark(GLsizei vertexCount)
+{
+    // Pontos aleatórios com normais: posição (3) + normal (3)
+    mt19937 rng(7);
+    uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    vector<float> vertices(vertexCount * 6);
+    for (GLsizei i = 0; i < vertexCount; ++i) {
+        vec3 p(unit(rng), unit(rng), unit(rng));
+        vec3 n = normalize(p + vec3(0.0f, 0.0f, 0.001f));
+        float* v = &vertices[6 * i];
+        v[0] = p.x; v[1] = p.y; v[2] = p.z;
+        v[3] = n.x; v[4] = n.y; v[5] = n.z;
+    }
+    GLuint VAO, VBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (GLvoid*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (GLvoid*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+
+    GLuint perVertexProgram = buildProgram(perVertexInverseSource);
+    GLuint uniformProgram = buildProgram(uniformNormalMatrixSource);
+    if (perVertexProgram == 0 || uniformProgram == 0)
+        return;
+
+    // Viewport de 1 pixel: o custo fica quase todo no vertex shader
+    glViewport(0, 0, 1, 1);
+    glDisable(GL_DEPTH_TEST);
+
+    mat4 model = rotate(glm::scale(mat4(1.0f), vec3(1.0f, 2.0f, 0.5f)), 0.7f, vec3(0.3f, 1.0f, 0.2f));
+    mat3 normalMatrix;
+    computeNormalMatrices(&model, &normalMatrix, 1);
+
+    double perVertex = gpuTime(perVertexProgram, VAO, vertexCount, model, normalMatrix);
+    double uniform = gpuTime(uniformProgram, VAO, vertexCount, model, normalMatrix);
+    cout << "GPU: " << vertexCount << " vertices (" << glGetString(GL_RENDERER) << ")" << endl;
+    cout << "  inversa por vertice:   " << perVertex << " ms (" << vertexCount / perVertex / 1000.0 << " Mvertices/s)" << endl;
+    cout << "  normalMatrix uniforme: " << uniform << " ms (" << vertexCount / uniform / 1000.0 << " Mvertices/s)" << endl;
+    cout << "  ganho: " << perVertex / uniform << "x" << endl;
+
+    glDeleteProgram(perVertexProgram);
+    glDeleteProgram(uniformProgram);
+    glDeleteBuffers(1, &VBO);
+    glDeleteVertexArrays(1, &VAO);
+}
+
+int main(int argc, char** argv)
+{
+    GLsizei vertexCount = argc > 1 ? atoi(argv[1]) : 4000000;
+    size_t objectCount = argc > 2 ? (size_t)atol(argv[2]) : 1000000;
+
+    cpuBenchmark(objectCount);
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(64, 64, "NormalMatrixBench", nullptr, nullptr);
+    if (!window) {
+        cout << "Falha ao criar o contexto OpenGL" << endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        cout << "Failed to initialize GLAD" << endl;
+        return -1;
+    }
+
+    gpuBenchmark(vertexCount);
+
+    glfwTerminate();
+    return 0;
+}
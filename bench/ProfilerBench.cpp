@@ -0,0 +1,71 @@
+/* Benchmark - custo dos escopos do profiler (FrameProfiler)
+ *
+ * Mede o custo de um PROFILE_SCOPE vazio em relação a um laço sem instrumentação,
+ * na thread principal e em todas as threads do JobSystem ao mesmo tempo (cada uma
+ * grava no seu anel), com um endFrame() a cada quadro recolhendo os anéis. Sem
+ * contexto OpenGL, só a parte de CPU do profiler é usada.
+ *
+ * Uso: ProfilerBench [escopos por quadro] [quadros] [threads]
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+
+#include "BenchmarkReport.h"
+#include "FrameProfiler.h"
+#include "JobSystem.h"
+
+using namespace std;
+
+// Trabalho mínimo dentro de cada escopo, para o compilador não remover o laço
+static atomic<uint64_t> sink{0};
+
+static void work(size_t count, bool instrumented)
+{
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (instrumented) {
+            PROFILE_SCOPE("escopo");
+            sum += i;
+        }
+        else
+            sum += i;
+    }
+    sink += sum;
+}
+
+int main(int argc, char** argv)
+{
+    size_t scopes = argc > 1 ? (size_t)atol(argv[1]) : 10000;
+    int frames = argc > 2 ? atoi(argv[2]) : 200;
+    unsigned threads = argc > 3 ? (unsigned)atoi(argv[3]) : 0;
+    JobSystem jobs(threads);
+
+    auto run = [&](bool instrumented, bool parallel) {
+        return measureMilliseconds([&] {
+            for (int frame = 0; frame < frames; ++frame) {
+                FrameProfiler::beginFrame();
+                if (parallel)
+                    jobs.parallelFor(scopes * jobs.threadCount(), scopes / 4 + 1,
+                                     [&](size_t begin, size_t end) { work(end - begin, instrumented); });
+                else
+                    work(scopes, instrumented);
+                FrameProfiler::endFrame();
+            }
+        });
+    };
+
+    double plain = run(false, false);
+    double profiled = run(true, false);
+    double parallelPlain = run(false, true);
+    double parallelProfiled = run(true, true);
+    double total = (double)scopes * frames;
+
+    cout << scopes << " escopos por quadro, " << frames << " quadros" << endl;
+    cout << "  1 thread:            " << (profiled - plain) * 1e6 / total << " ns por escopo" << endl;
+    cout << "  " << jobs.threadCount() << " thread(s) juntas:    "
+         << (parallelProfiled - parallelPlain) * 1e6 / (total * jobs.threadCount()) << " ns por escopo" << endl;
+    cout << "  escopos descartados: " << FrameProfiler::droppedScopes() << endl;
+    return 0;
+}
@@ -0,0 +1,306 @@
+/* Benchmark - carregamento e sistemas da cena, com resultados em JSON
+ *
+ * Microbenchmarks com entradas fixas (mesmas sementes e tamanhos em toda execução):
+ *  - obj/...: loadOBJ() das malhas dos exercícios (lua, Marte, Suzanne) e de uma esfera
+ *    gerada com o número de triângulos pedido (gravada em um arquivo temporário);
+ *  - textura/...: decodificação com o stb_image (PNG e JPG);
+ *  - cena/...: loadSceneConfig() do src/scene_init.txt e de uma cena gerada com N objetos,
+ *    (.../binaria) CompiledScene::open() da mesma cena compilada e (.../diff) diffScenes()
+ *    contra a mesma cena com um objeto movido, como na recarga de uma linha editada;
+ *  - transformacoes/...: updateTransforms() com todas as entidades alteradas, em uma
+ *    thread e com o JobSystem;
+ *  - trajetoria/...: advancePathAgents() (agentes em caminhos por splines);
+ *  - culling/...: cullEntities() contra o frustum de uma câmera fixa.
+ * --cena acrescenta outros arquivos (ex.: gerados pelo SceneGenerator; um .cena só tem
+ * o caso binário) e --filtro executa só os casos com os prefixos dados.
+ * Com --json, os resultados vão para o arquivo (ver BenchmarkReport.h e
+ * bench/compare_benchmarks.py). Executar da pasta de build, como os exercícios
+ * (os caminhos padrão são ../assets e ../src).
+ *
+ * Uso: SceneBench [--json arquivo] [--repeticoes N] [--objetos N] [--triangulos N]
+ *                 [--threads N] [--assets pasta] [--src pasta] [--cena arquivo]
+ *                 [--filtro prefixo,prefixo]
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "BenchmarkReport.h"
+#include "CompiledScene.h"
+#include "EntityWorld.h"
+#include "FrameAllocator.h"
+#include "JobSystem.h"
+#include "ObjLoader.h"
+#include "QuatMatrix.h"
+#include "SceneConfig.h"
+#include "SceneDiff.h"
+#include "SceneGenerator.h"
+#include "SplinePath.h"
+
+using namespace std;
+using namespace glm;
+
+// Verdadeiro se name começa com algum dos prefixos (ou se não há prefixos)
+static bool selected(const vector<string>& filters, const string& name)
+{
+    for (const string& prefix : filters)
+        if (name.compare(0, prefix.size(), prefix) == 0)
+            return true;
+    return filters.empty();
+}
+
+// Sistemas do mundo com objectCount entidades (um em cada oito filho do anterior) e
+// objectCount agentes em 64 caminhos fechados
+static void benchWorldSystems(BenchmarkReport& report, const vector<string>& filters, size_t objectCount,
+                              int repetitions, JobSystem& jobs)
+{
+    string count = to_string(objectCount);
+    if (!selected(filters, "transformacoes/" + count) && !selected(filters, "culling/" + count) &&
+        !selected(filters, "trajetoria/" + count))
+        return;
+    mt19937 rng(5);
+    uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    EntityWorld world;
+    world.reserve(objectCount);
+    for (size_t i = 0; i < objectCount; ++i) {
+        Entity entity = world.create("e" + to_string(i));
+        world.positions[entity] = vec3(unit(rng), unit(rng) * 0.2f, unit(rng)) * 100.0f;
+        world.rotations[entity] = quatFromEulerDegrees(vec3(unit(rng), unit(rng), unit(rng)) * 180.0f);
+        world.scales[entity] = vec3(0.5f);
+        world.boundingRadii[entity] = 1.0f;
+        if (i % 8 == 7)
+            world.setParent(entity, entity - 1);
+    }
+    auto markAll = [&] {
+        for (Entity entity = 0; entity < world.size(); ++entity)
+            world.markDirty(entity);
+    };
+    updateTransforms(world);
+    if (selected(filters, "transformacoes/" + count))
+        report.add("transformacoes/" + count, "ms", sampleMilliseconds(repetitions, 1, [&] {
+            markAll();
+            updateTransforms(world);
+        }));
+    if (selected(filters, "transformacoes/" + count + "_jobs"))
+        report.add("transformacoes/" + count + "_jobs", "ms", sampleMilliseconds(repetitions, 1, [&] {
+            markAll();
+            updateTransforms(world, &jobs);
+        }));
+
+    mat4 viewProjection = perspective(radians(45.0f), 1.5f, 0.1f, 300.0f) *
+                          lookAt(vec3(0.0f, 20.0f, 120.0f), vec3(0.0f), vec3(0.0f, 1.0f, 0.0f));
+    if (selected(filters, "culling/" + count))
+        report.add("culling/" + count, "ms", sampleMilliseconds(repetitions, 1, [&] {
+            cullEntities(world, viewProjection);
+        }));
+    if (selected(filters, "culling/" + count + "_jobs"))
+        report.add("culling/" + count + "_jobs", "ms", sampleMilliseconds(repetitions, 1, [&] {
+            cullEntities(world, viewProjection, &jobs);
+        }));
+
+    // Trajetórias
+    vector<SplinePath> paths(64);
+    for (SplinePath& path : paths) {
+        vector<vec3> points;
+        for (int k = 0; k < 8; ++k)
+            points.push_back(vec3(unit(rng) * 20.0f, unit(rng) * 5.0f, unit(rng) * 20.0f));
+        path.build(points, SPLINE_CATMULL_ROM, true);
+    }
+    PathAgents agents;
+    for (size_t i = 0; i < objectCount; ++i) {
+        uint32_t path = rng() % (uint32_t)paths.size();
+        agents.add(path, 1.5f + unit(rng), (0.5f + 0.5f * unit(rng)) * paths[path].length());
+    }
+    advancePathAgents(paths, agents, 0.0f);
+    if (selected(filters, "trajetoria/" + count))
+        report.add("trajetoria/" + count, "ms", sampleMilliseconds(repetitions, 1, [&] {
+            advancePathAgents(paths, agents, 1.0f / 60.0f);
+        }));
+    if (selected(filters, "trajetoria/" + count + "_jobs"))
+        report.add("trajetoria/" + count + "_jobs", "ms", sampleMilliseconds(repetitions, 1, [&] {
+            advancePathAgents(paths, agents, 1.0f / 60.0f, &jobs);
+        }));
+}
+
+int main(int argc, char** argv)
+{
+    string jsonPath, assets = "../assets", sources = "../src";
+    int repetitions = 10;
+    size_t objectCount = 100000, triangleCount = 200000;
+    unsigned threads = 0;
+    vector<string> scenes, filters;
+    for (int i = 1; i < argc; ++i) {
+        string option = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (option == "--json" && hasValue)
+            jsonPath = argv[++i];
+        else if (option == "--repeticoes" && hasValue)
+            repetitions = std::max(1, atoi(argv[++i]));
+        else if (option == "--objetos" && hasValue)
+            objectCount = std::max(1L, atol(argv[++i]));
+        else if (option == "--triangulos" && hasValue)
+            triangleCount = std::max(2L, atol(argv[++i]));
+        else if (option == "--threads" && hasValue)
+            threads = (unsigned)atoi(argv[++i]);
+        else if (option == "--assets" && hasValue)
+            assets = argv[++i];
+        else if (option == "--src" && hasValue)
+            sources = argv[++i];
+        else if (option == "--cena" && hasValue)
+            scenes.push_back(argv[++i]);
+        else if (option == "--filtro" && hasValue) {
+            istringstream list(argv[++i]);
+            string prefix;
+            while (getline(list, prefix, ','))
+                filters.push_back(prefix);
+        }
+        else {
+            cout << "Uso: SceneBench [--json arquivo] [--repeticoes N] [--objetos N] [--triangulos N]\n"
+                 << "                  [--threads N] [--assets pasta] [--src pasta] [--cena arquivo]\n"
+                 << "                  [--filtro prefixo,prefixo]" << endl;
+            return -1;
+        }
+    }
+
+    BenchmarkReport report("SceneBench");
+    JobSystem jobs(threads);
+    cout << "SceneBench: " << repetitions << " repeticoes, " << objectCount << " objetos, "
+         << triangleCount << " triangulos, " << jobs.threadCount() << " thread(s)" << endl;
+
+    // --- Malhas ---
+    LinearArena scratch(4 << 20);
+    auto benchOBJ = [&](const string& name, const string& obj, const string& mtl, int count) {
+        if (!selected(filters, name))
+            return;
+        vector<vec3> positions, normals;
+        vector<vec2> texCoords;
+        string texture;
+        Material material;
+        bool ok = true;
+        vector<double> samples = sampleMilliseconds(count, 1, [&] {
+            positions.clear();
+            texCoords.clear();
+            ok = ok && loadOBJ(obj, mtl, texture, positions, texCoords, normals, material, scratch);
+            scratch.reset();
+        });
+        if (ok)
+            report.add(name, "ms", samples);
+        else
+            cout << "  " << name << ": nao foi possivel carregar " << obj << endl;
+    };
+    benchOBJ("obj/moon", assets + "/Modelos3D/moon.obj", assets + "/Modelos3D/moon.mtl", repetitions);
+    benchOBJ("obj/mars", assets + "/Modelos3D/mars.obj", assets + "/Modelos3D/mars.mtl", repetitions);
+    benchOBJ("obj/suzanne", assets + "/Modelos3D/Suzanne.obj", assets + "/Modelos3D/Suzanne.mtl", repetitions);
+    const string sphere = "SceneBench_esfera.obj";
+    string sphereName = "obj/esfera_" + to_string(triangleCount);
+    if (selected(filters, sphereName) && writeSphereOBJ(sphere, triangleCount)) {
+        benchOBJ(sphereName, sphere, assets + "/Modelos3D/moon.mtl", std::max(1, repetitions / 4));
+        remove(sphere.c_str());
+    }
+
+    // --- Texturas ---
+    auto benchTexture = [&](const string& name, const string& file) {
+        if (!selected(filters, name))
+            return;
+        bool ok = true;
+        vector<double> samples = sampleMilliseconds(repetitions, 1, [&] {
+            int width, height, channels;
+            unsigned char* data = stbi_load(file.c_str(), &width, &height, &channels, 4);
+            ok = ok && data;
+            stbi_image_free(data);
+        });
+        if (ok)
+            report.add(name, "ms", samples);
+        else
+            cout << "  " << name << ": nao foi possivel decodificar " << file << endl;
+    };
+    benchTexture("textura/moon_diffuse_png", assets + "/tex/moon_diffuse.png");
+    benchTexture("textura/mars_diffuse_png", assets + "/tex/mars_diffuse.png");
+    benchTexture("textura/fundo_estrelas_jpg", assets + "/tex/fundo-estrelas.jpg");
+
+    // --- Arquivos de cena ---
+    // O texto com loadSceneConfig; depois a mesma cena compilada, aberta com um mmap
+    auto benchCompiled = [&](const string& name, const string& file, int count) {
+        bool ok = true;
+        CompiledScene compiled;
+        vector<double> samples = sampleMilliseconds(count, 1, [&] { ok = ok && compiled.open(file); });
+        if (ok)
+            report.add(name + "/binaria", "ms", samples);
+    };
+    auto benchDiff = [&](const string& name, SceneConfig& config, int count) {
+        if (config.objects.empty())
+            return;
+        vector<uint8_t> blob, editedBlob;
+        compileScene(config, blob);
+        config.objects[config.objects.size() / 2].position.y += 1.0f;
+        compileScene(config, editedBlob);
+        CompiledScene before, after;
+        bool ok = before.openMemory(std::move(blob)) && after.openMemory(std::move(editedBlob));
+        SceneDiff diff;
+        vector<double> samples = sampleMilliseconds(count, 1, [&] { ok = ok && diffScenes(before, after, diff); });
+        if (ok && diff.ops.size() == 1)
+            report.add(name + "/diff", "ms", samples);
+    };
+    auto benchScene = [&](const string& name, const string& file, int count) {
+        if (!selected(filters, name))
+            return;
+        bool ok = true;
+        SceneConfig config;
+        vector<double> samples = sampleMilliseconds(count, 1, [&] {
+            SceneConfig scene;
+            ok = ok && loadSceneConfig(file, scene);
+            config = std::move(scene);
+        });
+        if (!ok)
+            return;
+        report.add(name, "ms", samples);
+        if (saveCompiledScene(config, "SceneBench_cena.cena")) {
+            benchCompiled(name, "SceneBench_cena.cena", count);
+            remove("SceneBench_cena.cena");
+        }
+        benchDiff(name, config, count);
+    };
+    benchScene("cena/scene_init", sources + "/scene_init.txt", repetitions);
+    // Cena gerada em grade (SceneGenerator.h), com um objeto em cada oito em órbita
+    SceneGeneratorOptions gridOptions;
+    gridOptions.objectCount = std::min(objectCount, (size_t)10000);
+    gridOptions.meshes = { "moon", "mars" };
+    gridOptions.orbitFraction = 0.125f;
+    gridOptions.assets = assets;
+    string gridName = "cena/grade_" + to_string(gridOptions.objectCount);
+    GeneratedScene grid;
+    if (selected(filters, gridName) && generateScene("SceneBench_cena", "grade", gridOptions, &grid)) {
+        benchScene(gridName, grid.scenePath, std::max(1, repetitions / 2));
+        filesystem::remove_all("SceneBench_cena");
+    }
+    // Cenas pedidas com --cena, com o nome do arquivo
+    for (const string& file : scenes) {
+        string stem = filesystem::path(file).stem().string();
+        if (filesystem::path(file).extension() == ".cena") {
+            if (selected(filters, "cena/" + stem))
+                benchCompiled("cena/" + stem, file, std::max(1, repetitions / 2));
+        }
+        else {
+            benchScene("cena/" + stem, file, std::max(1, repetitions / 2));
+        }
+    }
+
+    benchWorldSystems(report, filters, objectCount, repetitions, jobs);
+
+    if (!jsonPath.empty() && !report.write(jsonPath))
+        return -1;
+    return 0;
+}
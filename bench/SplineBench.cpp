@@ -0,0 +1,110 @@
+/* Benchmark - agentes andando em caminhos por splines (SplinePath / PathAgents)
+ *
+ * N agentes em 64 caminhos fechados de Catmull-Rom com 8 pontos cada. Mede por tick:
+ *  - o andador em linha reta da Trajetoria antiga (vai ao próximo ponto, troca a menos
+ *    de 0,05), como referência de custo;
+ *  - a amostragem do caminho sem cursor (busca na tabela desde o início a cada amostra);
+ *  - advancePathAgents() com o cursor de cada agente, em uma thread e com o JobSystem.
+ *
+ * Uso: SplineBench [quantidade de agentes] [ticks] [threads]
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "BenchmarkReport.h"
+#include "JobSystem.h"
+#include "SplinePath.h"
+
+using namespace std;
+using namespace glm;
+
+// Referência: o andador em linha reta, com o índice do ponto alvo de cada agente
+struct Walkers {
+    vector<uint32_t> paths;
+    vector<uint32_t> targets;
+    vector<vec3> positions;
+};
+
+static void advanceWalkers(const vector<vector<vec3>>& points, Walkers& walkers, const vector<float>& speeds, float step)
+{
+    for (size_t i = 0; i < walkers.paths.size(); ++i) {
+        const vector<vec3>& path = points[walkers.paths[i]];
+        vec3 target = path[walkers.targets[i]];
+        vec3 offset = target - walkers.positions[i];
+        if (glm::length(offset) < 0.05f)
+            walkers.targets[i] = (walkers.targets[i] + 1) % (uint32_t)path.size();
+        else
+            walkers.positions[i] += normalize(offset) * speeds[i] * step;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t agentCount = argc > 1 ? (size_t)atol(argv[1]) : 1000000;
+    int ticks = argc > 2 ? atoi(argv[2]) : 60;
+    unsigned threads = argc > 3 ? (unsigned)atoi(argv[3]) : 0;
+    const float step = 1.0f / 60.0f;
+
+    mt19937 rng(11);
+    uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    vector<vector<vec3>> points(64);
+    vector<SplinePath> paths(points.size());
+    for (size_t p = 0; p < points.size(); ++p) {
+        for (int k = 0; k < 8; ++k)
+            points[p].push_back(vec3(unit(rng) * 20.0f, unit(rng) * 5.0f, unit(rng) * 20.0f));
+        paths[p].build(points[p], SPLINE_CATMULL_ROM, true);
+    }
+
+    PathAgents agents;
+    Walkers walkers;
+    vector<float> speeds;
+    for (size_t i = 0; i < agentCount; ++i) {
+        uint32_t path = rng() % (uint32_t)paths.size();
+        float speed = 1.5f + unit(rng);
+        agents.add(path, speed, (0.5f + 0.5f * unit(rng)) * paths[path].length());
+        walkers.paths.push_back(path);
+        walkers.targets.push_back(1);
+        walkers.positions.push_back(points[path][0]);
+        speeds.push_back(speed);
+    }
+    advancePathAgents(paths, agents, 0.0f);
+
+    double walkerTime = measureMilliseconds([&] {
+        for (int tick = 0; tick < ticks; ++tick)
+            advanceWalkers(points, walkers, speeds, step);
+    });
+
+    PathAgents restart = agents;
+    double scanTime = measureMilliseconds([&] {
+        for (int tick = 0; tick < ticks; ++tick) {
+            for (uint32_t& cursor : restart.cursors)
+                cursor = 0;
+            advancePathAgents(paths, restart, step);
+        }
+    });
+
+    double cursorTime = measureMilliseconds([&] {
+        for (int tick = 0; tick < ticks; ++tick)
+            advancePathAgents(paths, agents, step);
+    });
+
+    JobSystem jobs(threads);
+    double jobsTime = measureMilliseconds([&] {
+        for (int tick = 0; tick < ticks; ++tick)
+            advancePathAgents(paths, agents, step, &jobs);
+    });
+
+    cout << agentCount << " agentes, " << paths.size() << " caminhos (" << paths[0].segmentCount()
+         << " segmentos), " << ticks << " ticks" << endl;
+    cout << "  linha reta (antigo):     " << walkerTime / ticks << " ms/tick" << endl;
+    cout << "  spline sem cursor:       " << scanTime / ticks << " ms/tick" << endl;
+    cout << "  spline, 1 thread:        " << cursorTime / ticks << " ms/tick" << endl;
+    cout << "  spline, " << jobs.threadCount() << " thread(s):      " << jobsTime / ticks << " ms/tick" << endl;
+    return 0;
+}
@@ -0,0 +1,115 @@
+/* Benchmark - arquivos de trajetória em texto e no formato binário (.trj)
+ *
+ * Grava e lê N pontos (com tempos) em:
+ *  - texto, um ponto por linha com ofstream << / ifstream >> (o formato antigo);
+ *  - .trj com floats e .trj quantizado, lido inteiro pelo mapeamento e em blocos
+ *    com stream().
+ * Mede também quanto AsyncTrajectoryWriter::save() segura quem chama.
+ *
+ * Uso: TrajectoryFileBench [pontos] [pasta para os arquivos]
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "BenchmarkReport.h"
+#include "TrajectoryFile.h"
+
+using namespace std;
+using namespace glm;
+
+static long fileSize(const string& path)
+{
+    ifstream file(path, ios::binary | ios::ate);
+    return file ? (long)file.tellg() : -1;
+}
+
+int main(int argc, char** argv)
+{
+    size_t count = argc > 1 ? (size_t)atol(argv[1]) : 2000000;
+    string folder = argc > 2 ? argv[2] : ".";
+    string textPath = folder + "/bench_trajectory.txt";
+    string floatPath = folder + "/bench_trajectory.trj";
+    string quantizedPath = folder + "/bench_trajectory_q.trj";
+
+    // Uma espiral gravada a 120 Hz
+    vector<vec3> points(count);
+    vector<float> times(count);
+    for (size_t i = 0; i < count; ++i) {
+        float t = (float)i / 120.0f;
+        points[i] = vec3(6.0f * cos(t), 0.01f * fmod(t, 500.0f), -5.0f + 4.0f * sin(t));
+        times[i] = t;
+    }
+
+    double textWrite = measureMilliseconds([&] {
+        ofstream out(textPath);
+        for (size_t i = 0; i < count; ++i)
+            out << points[i].x << " " << points[i].y << " " << points[i].z << " " << times[i] << "\n";
+    });
+    vector<vec3> loaded;
+    vector<float> loadedTimes;
+    double textRead = measureMilliseconds([&] {
+        ifstream in(textPath);
+        vec3 p;
+        float t;
+        while (in >> p.x >> p.y >> p.z >> t) {
+            loaded.push_back(p);
+            loadedTimes.push_back(t);
+        }
+    });
+
+    double floatWrite = measureMilliseconds([&] { saveTrajectoryFile(floatPath, points, TRAJECTORY_TIMES, &times); });
+    double quantizedWrite = measureMilliseconds([&] {
+        saveTrajectoryFile(quantizedPath, points, TRAJECTORY_TIMES | TRAJECTORY_QUANTIZED, &times);
+    });
+    double floatRead = measureMilliseconds([&] { loadTrajectoryFile(floatPath, loaded, &loadedTimes); });
+
+    float maxError = 0.0f;
+    double quantizedRead = measureMilliseconds([&] { loadTrajectoryFile(quantizedPath, loaded, &loadedTimes); });
+    for (size_t i = 0; i < count; ++i) {
+        vec3 error = abs(loaded[i] - points[i]);
+        maxError = std::max(maxError, std::max(error.x, std::max(error.y, error.z)));
+    }
+
+    // Em blocos de 64k pontos: a memória usada não cresce com o arquivo
+    double checksum = 0.0;
+    double streamRead = measureMilliseconds([&] {
+        TrajectoryReader reader;
+        reader.open(floatPath);
+        reader.stream(64 * 1024, [&](const vec3* chunk, const float*, size_t n) {
+            for (size_t i = 0; i < n; ++i)
+                checksum += chunk[i].y;
+        });
+    });
+
+    double asyncCall, asyncTotal;
+    {
+        AsyncTrajectoryWriter writer;
+        vector<vec3> copy = points;
+        vector<float> copyTimes = times;
+        asyncTotal = measureMilliseconds([&] {
+            asyncCall = measureMilliseconds([&] { writer.save(floatPath, std::move(copy), TRAJECTORY_TIMES, std::move(copyTimes)); });
+            writer.flush();
+        });
+    }
+
+    cout << count << " pontos com tempos" << endl;
+    cout << "  texto:          grava " << textWrite << " ms, le " << textRead << " ms, " << fileSize(textPath) << " bytes" << endl;
+    cout << "  .trj float:     grava " << floatWrite << " ms, le " << floatRead << " ms, " << fileSize(floatPath) << " bytes" << endl;
+    cout << "  .trj quantizado: grava " << quantizedWrite << " ms, le " << quantizedRead << " ms, "
+         << fileSize(quantizedPath) << " bytes, erro maximo " << maxError << endl;
+    cout << "  stream() em blocos: " << streamRead << " ms (soma " << checksum << ")" << endl;
+    cout << "  gravacao em segundo plano: save() " << asyncCall << " ms, total " << asyncTotal << " ms" << endl;
+
+    remove(textPath.c_str());
+    remove(floatPath.c_str());
+    remove(quantizedPath.c_str());
+    return 0;
+}
@@ -0,0 +1,101 @@
+/* Benchmark - gravação de trajetórias (TrajectoryRecorder / SpscRing / Douglas-Peucker)
+ *
+ *  - vazão do SpscRing entre duas threads;
+ *  - gravação de 8 trilhas a 1 kHz por alguns segundos: amostras, descartes e pontos
+ *    que sobram depois da simplificação;
+ *  - simplifyTrajectory() em um caminho de 1 milhão de pontos.
+ *
+ * Uso: TrajectoryRecorderBench [segundos de gravação] [pasta para os arquivos]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "BenchmarkReport.h"
+#include "TrajectoryRecorder.h"
+
+using namespace std;
+using namespace glm;
+
+// Caminho da trilha: voltas em torno de um círculo com um pouco de ondulação
+static vec3 trackPosition(uint32_t track, double time)
+{
+    float t = (float)time * (0.5f + 0.1f * track);
+    return vec3(4.0f * cos(t), 0.5f * sin(3.0f * t), -5.0f + 4.0f * sin(t));
+}
+
+int main(int argc, char** argv)
+{
+    double seconds = argc > 1 ? atof(argv[1]) : 3.0;
+    string folder = argc > 2 ? argv[2] : ".";
+
+    // Anel: um produtor e um consumidor trocando 10 milhões de amostras
+    const size_t ringItems = 10000000;
+    SpscRing<TrajectorySample> ring(1 << 16);
+    double ringTime = measureMilliseconds([&] {
+        thread producer([&] {
+            for (size_t i = 0; i < ringItems;) {
+                TrajectorySample sample = { 0, (float)i, vec3((float)i) };
+                if (ring.push(sample))
+                    ++i;
+                else
+                    this_thread::yield();
+            }
+        });
+        vector<TrajectorySample> batch(4096);
+        for (size_t received = 0; received < ringItems;) {
+            size_t count = ring.pop(batch.data(), batch.size());
+            received += count;
+            if (count == 0)
+                this_thread::yield();
+        }
+        producer.join();
+    });
+
+    // Gravação de 8 trilhas a 1 kHz
+    vector<string> paths;
+    for (int t = 0; t < 8; ++t)
+        paths.push_back(folder + "/bench_recording" + to_string(t) + ".trj");
+    TrajectoryRecorder recorder;
+    recorder.start(paths, 1000.0, trackPosition, 0.01f);
+    this_thread::sleep_for(chrono::duration<double>(seconds));
+    recorder.stop();
+    uint64_t taken = recorder.samplesTaken(), dropped = recorder.samplesDropped();
+    vector<TrajectoryRecorder::Result> results;
+    while (results.size() < paths.size()) {
+        TrajectoryRecorder::Result result;
+        if (recorder.popResult(result))
+            results.push_back(result);
+        else
+            this_thread::sleep_for(chrono::milliseconds(5));
+    }
+
+    // Douglas-Peucker em 1 milhão de pontos
+    vector<vec3> path(1000000);
+    vector<float> times(path.size());
+    for (size_t i = 0; i < path.size(); ++i) {
+        times[i] = (float)i / 1000.0f;
+        path[i] = trackPosition(3, times[i]);
+    }
+    size_t kept = 0;
+    double simplifyTime = measureMilliseconds([&] { kept = simplifyTrajectory(path, &times, 0.01f); });
+
+    cout << "SpscRing: " << ringItems / (ringTime / 1000.0) / 1e6 << " milhoes de amostras/s entre duas threads" << endl;
+    cout << "Gravacao de " << paths.size() << " trilhas a 1 kHz por " << seconds << " s: " << taken << " amostras ("
+         << taken / seconds / paths.size() << " Hz por trilha), " << dropped << " descartadas" << endl;
+    for (const TrajectoryRecorder::Result& result : results) {
+        cout << "  " << result.path << ": " << result.samples << " -> " << result.kept << " pontos"
+             << (result.ok ? "" : " (erro)") << endl;
+        remove(result.path.c_str());
+    }
+    cout << "Douglas-Peucker: 1000000 -> " << kept << " pontos em " << simplifyTime << " ms" << endl;
+    return 0;
+}
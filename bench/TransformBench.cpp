@@ -0,0 +1,104 @@
+/* Benchmark - matrizes de transformação a partir de Euler x quatérnios
+ *
+ * Mede o tempo para montar a matriz T * R de N objetos:
+ *  - Euler em graus com três glm::rotate (formato anterior dos exercícios);
+ *  - quatérnio com glm::mat4_cast;
+ *  - quatérnio com a versão escalar de QuatMatrix.h;
+ *  - quatérnio com a versão SSE (4 por vez).
+ * Por fim mede o updateTransforms() do EntityWorld com todos os objetos alterados.
+ *
+ * Uso: TransformBench [quantidade de objetos]
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "BenchmarkReport.h"
+#include "EntityWorld.h"
+#include "QuatMatrix.h"
+
+using namespace std;
+using namespace glm;
+
+static float maxDifference(const vector<mat4>& a, const vector<mat4>& b)
+{
+    float maxError = 0.0f;
+    for (size_t i = 0; i < a.size(); ++i)
+        for (int c = 0; c < 4; ++c)
+            for (int l = 0; l < 4; ++l)
+                maxError = std::max(maxError, std::abs(a[i][c][l] - b[i][c][l]));
+    return maxError;
+}
+
+int main(int argc, char** argv)
+{
+    size_t objectCount = argc > 1 ? (size_t)atol(argv[1]) : 1000000;
+
+    mt19937 rng(3);
+    uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    vector<vec3> positions(objectCount), eulers(objectCount);
+    vector<quat> rotations(objectCount);
+    for (size_t i = 0; i < objectCount; ++i) {
+        positions[i] = vec3(unit(rng), unit(rng), unit(rng)) * 50.0f;
+        eulers[i] = vec3(unit(rng), unit(rng), unit(rng)) * 180.0f;
+        rotations[i] = quatFromEulerDegrees(eulers[i]);
+    }
+    vector<mat4> euler(objectCount), glmQuat(objectCount), scalar(objectCount), simd(objectCount);
+
+    const int repeats = 5;
+    double eulerTime = 1e30, glmTime = 1e30, scalarTime = 1e30, simdTime = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        eulerTime = std::min(eulerTime, measureMilliseconds([&] {
+            for (size_t i = 0; i < objectCount; ++i) {
+                mat4 model = translate(mat4(1.0f), positions[i]);
+                model = rotate(model, radians(eulers[i].x), vec3(1.0f, 0.0f, 0.0f));
+                model = rotate(model, radians(eulers[i].y), vec3(0.0f, 1.0f, 0.0f));
+                euler[i] = rotate(model, radians(eulers[i].z), vec3(0.0f, 0.0f, 1.0f));
+            }
+        }));
+        glmTime = std::min(glmTime, measureMilliseconds([&] {
+            for (size_t i = 0; i < objectCount; ++i)
+                glmQuat[i] = translate(mat4(1.0f), positions[i]) * mat4_cast(rotations[i]);
+        }));
+        scalarTime = std::min(scalarTime, measureMilliseconds([&] {
+            composeRigidMatricesScalar(rotations.data(), positions.data(), scalar.data(), objectCount);
+        }));
+        simdTime = std::min(simdTime, measureMilliseconds([&] {
+            composeRigidMatrices(rotations.data(), positions.data(), simd.data(), objectCount);
+        }));
+    }
+
+    // Sistema completo: matrizes locais, de mundo e de normais de todas as entidades
+    EntityWorld world;
+    world.reserve(objectCount);
+    for (size_t i = 0; i < objectCount; ++i) {
+        Entity entity = world.create("");
+        world.positions[entity] = positions[i];
+        world.rotations[entity] = rotations[i];
+    }
+    updateTransforms(world);
+    double worldTime = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        for (size_t i = 0; i < objectCount; ++i)
+            world.markDirty((Entity)i);
+        worldTime = std::min(worldTime, measureMilliseconds([&] { updateTransforms(world); }));
+    }
+
+    cout << objectCount << " objetos" << endl;
+    cout << "  Euler (3x glm::rotate):     " << eulerTime << " ms" << endl;
+    cout << "  glm::mat4_cast:             " << glmTime << " ms" << endl;
+    cout << "  quaternio escalar:          " << scalarTime << " ms" << endl;
+    cout << "  quaternio SSE (4 por vez):  " << simdTime << " ms" << endl;
+    cout << "  EntityWorld updateTransforms (tudo alterado): " << worldTime << " ms" << endl;
+    cout << "  diferenca maxima para Euler: " << maxDifference(euler, simd) << endl;
+    cout << "  diferenca maxima SSE x escalar: " << maxDifference(scalar, simd) << endl;
+    return 0;
+}
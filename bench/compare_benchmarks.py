@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""Compara dois arquivos de resultados de benchmark e falha se alguma métrica piorou.
+
+Os arquivos são os do BenchmarkReport (SceneBench, TrabalhoGB --bench) ou os juntados
+por run_benchmarks.py. Menor é sempre melhor. Uma métrica regrediu quando
+
+    atual > base * (1 + percent / 100)   e   atual - base > min_delta
+
+com percent, min_delta e a estatística comparada (median, p90, p99, ...) vindos da
+primeira regra de thresholds.json cujo padrão (fnmatch) casa com o nome; sem regra,
+valem os valores de "default". Uma regra com "ignore": true tira a métrica da
+comparação. Sai com código 1 se houve regressão, 0 caso contrário.
+
+    python3 compare_benchmarks.py base.json atual.json [--thresholds thresholds.json]
+"""
+
+import argparse
+import fnmatch
+import json
+import os
+import sys
+
+DEFAULT_THRESHOLDS = os.path.join(os.path.dirname(os.path.abspath(__file__)), "thresholds.json")
+
+
+def load_results(path):
+    with open(path) as file:
+        return {result["name"]: result for result in json.load(file)["results"]}
+
+
+def rule_for(name, thresholds):
+    rule = dict(thresholds.get("default", {}))
+    for candidate in thresholds.get("rules", []):
+        if fnmatch.fnmatchcase(name, candidate["pattern"]):
+            rule.update(candidate)
+            break
+    rule.setdefault("metric", "median")
+    rule.setdefault("percent", 10.0)
+    rule.setdefault("min_delta", 0.0)
+    return rule
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("base")
+    parser.add_argument("current")
+    parser.add_argument("--thresholds", default=DEFAULT_THRESHOLDS, help="regras de limite (JSON)")
+    parser.add_argument("--strict", action="store_true", help="métricas da base ausentes também falham")
+    args = parser.parse_args()
+
+    base = load_results(args.base)
+    current = load_results(args.current)
+    thresholds = {}
+    if os.path.exists(args.thresholds):
+        with open(args.thresholds) as file:
+            thresholds = json.load(file)
+
+    regressions = []
+    missing = []
+    print("{:<48} {:>7} {:>12} {:>12} {:>9}  {}".format("metrica", "estat.", "base", "atual", "delta", ""))
+    for name in sorted(base):
+        rule = rule_for(name, thresholds)
+        if rule.get("ignore"):
+            continue
+        if name not in current:
+            missing.append(name)
+            continue
+        metric = rule["metric"]
+        before = base[name][metric]
+        after = current[name][metric]
+        change = (after - before) / before * 100.0 if before > 0 else 0.0
+        regressed = after > before * (1.0 + rule["percent"] / 100.0) and after - before > rule["min_delta"]
+        improved = after < before * (1.0 - rule["percent"] / 100.0) and before - after > rule["min_delta"]
+        status = "REGRESSAO (limite {:g}%)".format(rule["percent"]) if regressed else ("melhora" if improved else "")
+        print("{:<48} {:>7} {:>12.4f} {:>12.4f} {:>+8.1f}%  {}".format(name, metric, before, after, change, status))
+        if regressed:
+            regressions.append(name)
+
+    for name in sorted(set(current) - set(base)):
+        print("{:<48} (nova, sem base)".format(name))
+    for name in missing:
+        print("{:<48} (ausente no resultado atual)".format(name))
+
+    failed = regressions or (args.strict and missing)
+    if regressions:
+        print("\n{} metrica(s) regrediram: {}".format(len(regressions), ", ".join(regressions)))
+    if failed:
+        return 1
+    print("\nSem regressoes")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""Executa os benchmarks com resultados em JSON e junta tudo em um arquivo só.
+
+ - SceneBench: microbenchmarks (malhas, texturas, arquivo de cena, transformações,
+   trajetórias, culling);
+ - TrabalhoGB --headless --format none --bench: quadros desenhados sem janela em cada
+   caminho fixo da câmera, com os percentis do tempo de quadro.
+ - --scaling 10,1000,100000: para cada tamanho, uma galáxia gerada pelo SceneGenerator
+   com o carregamento da cena (texto e compilada), transformações, culling, trajetórias
+   e os quadros do TrabalhoGB (lendo a cena compilada) com essa quantidade de objetos.
+   Os resultados do SceneBench da escala levam o prefixo "escala/" (transformacoes/100000
+   também é um nome dos microbenchmarks).
+
+Executar da pasta de build (os executáveis procuram ../assets e ../src). O arquivo de
+saída é comparado com outro por compare_benchmarks.py:
+
+    python3 ../bench/run_benchmarks.py --out atual.json
+    python3 ../bench/compare_benchmarks.py base.json atual.json
+"""
+
+import argparse
+import json
+import os
+import platform
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+CAMERA_PATHS = ["fixa", "orbita", "aproximacao"]
+
+
+def executable(build, name):
+    path = os.path.join(build, name + (".exe" if os.name == "nt" else ""))
+    return path if os.path.exists(path) else None
+
+
+def run(command, cwd, json_path, prefix=""):
+    """Executa o benchmark e devolve os resultados do JSON (vazio se falhou), com prefix
+    antes de cada nome."""
+    print("$ " + " ".join(command), flush=True)
+    if subprocess.call(command, cwd=cwd) != 0 or not os.path.exists(json_path):
+        print("  falhou: resultados ignorados", file=sys.stderr)
+        return []
+    with open(json_path) as file:
+        results = json.load(file)["results"]
+    os.remove(json_path)
+    for result in results:
+        result["name"] = prefix + result["name"]
+    return results
+
+
+def git_commit(source):
+    try:
+        return subprocess.check_output(["git", "rev-parse", "--short", "HEAD"], cwd=source,
+                                       stderr=subprocess.DEVNULL).decode().strip()
+    except (OSError, subprocess.CalledProcessError):
+        return ""
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--build", default=".", help="pasta com os executáveis (padrão: a atual)")
+    parser.add_argument("--out", default="benchmarks.json", help="arquivo de saída")
+    parser.add_argument("--frames", type=int, default=300, help="quadros por caminho de câmera")
+    parser.add_argument("--scene", action="append", help="arquivo de cena do TrabalhoGB (pode repetir)")
+    parser.add_argument("--repetitions", type=int, default=10, help="repetições dos microbenchmarks")
+    parser.add_argument("--objects", type=int, default=100000, help="entidades dos microbenchmarks")
+    parser.add_argument("--triangles", type=int, default=200000, help="triângulos da malha gerada")
+    parser.add_argument("--skip-micro", action="store_true", help="não executa o SceneBench")
+    parser.add_argument("--skip-frames", action="store_true", help="não desenha os quadros do TrabalhoGB")
+    parser.add_argument("--scaling", default="", help="quantidades de objetos das cenas geradas (ex.: 10,1000,100000)")
+    parser.add_argument("--scaling-frames", type=int, default=60, help="quadros por cena gerada")
+    parser.add_argument("--assets", default="../assets", help="pasta de assets (para as cenas geradas)")
+    args = parser.parse_args()
+
+    build = os.path.abspath(args.build)
+    scenes = args.scene or ["../src/scene_init.txt"]
+    temporary = tempfile.mkdtemp(prefix="bench_")
+    results = []
+
+    scene_bench = executable(build, "SceneBench")
+    if not args.skip_micro:
+        if scene_bench:
+            path = os.path.join(temporary, "micro.json")
+            results += run([scene_bench, "--json", path, "--repeticoes", str(args.repetitions),
+                            "--objetos", str(args.objects), "--triangulos", str(args.triangles)], build, path)
+        else:
+            print("SceneBench não encontrado em " + build, file=sys.stderr)
+
+    trabalho = executable(build, "TrabalhoGB")
+    if not args.skip_frames:
+        if trabalho:
+            for scene in scenes:
+                for camera_path in CAMERA_PATHS:
+                    path = os.path.join(temporary, "quadros.json")
+                    results += run([trabalho, "--headless", "--format", "none", "--scene", scene,
+                                    "--frames", str(args.frames), "--camera-path", camera_path, "--bench", path],
+                                   build, path)
+        else:
+            print("TrabalhoGB não encontrado em " + build, file=sys.stderr)
+
+    # Escala: a mesma galáxia (mesma semente) com cada quantidade de objetos
+    generator = executable(build, "SceneGenerator")
+    counts = [int(count) for count in args.scaling.split(",") if count.strip()]
+    if counts and not generator:
+        print("SceneGenerator não encontrado em " + build, file=sys.stderr)
+        counts = []
+    for count in counts:
+        name = "escala_{}".format(count)
+        directory = os.path.join(temporary, name)
+        if subprocess.call([generator, "--objetos", str(count), "--layout", "galaxia", "--saida", directory,
+                            "--nome", name, "--assets", os.path.abspath(os.path.join(build, args.assets)), "--compilar"],
+                           cwd=build) != 0:
+            print("  falhou: cena de {} objetos não gerada".format(count), file=sys.stderr)
+            continue
+        scene = os.path.join(directory, name + ".txt")
+        compiled = os.path.join(directory, name + ".cena")
+        path = os.path.join(temporary, "escala.json")
+        if scene_bench:
+            filters = ",".join(["cena/" + name, "transformacoes/{}".format(count), "culling/{}".format(count),
+                                "trajetoria/{}".format(count)])
+            results += run([scene_bench, "--json", path, "--repeticoes", str(args.repetitions), "--objetos",
+                            str(count), "--cena", scene, "--filtro", filters], build, path, "escala/")
+        if trabalho:
+            results += run([trabalho, "--headless", "--format", "none", "--scene", compiled, "--frames",
+                            str(args.scaling_frames), "--camera-path", "fixa", "--bench", path], build, path)
+        shutil.rmtree(directory)
+    shutil.rmtree(temporary)
+
+    # Um nome por métrica: a comparação com outra execução é feita pelo nome
+    names = [result["name"] for result in results]
+    repeated = sorted(set(name for name in names if names.count(name) > 1))
+    if repeated:
+        print("Resultados com o mesmo nome: " + ", ".join(repeated), file=sys.stderr)
+        return 1
+
+    if not results:
+        print("Nenhum resultado", file=sys.stderr)
+        return 1
+    report = {
+        "suite": "CGCCBenchmarks",
+        "meta": {
+            "commit": git_commit(os.path.dirname(os.path.abspath(__file__))),
+            "date": time.strftime("%Y-%m-%dT%H:%M:%S"),
+            "machine": platform.node(),
+            "processor": platform.processor() or platform.machine(),
+            "cpus": os.cpu_count(),
+        },
+        "results": results,
+    }
+    with open(args.out, "w") as file:
+        json.dump(report, file, indent=2)
+    print("{} resultados gravados em {}".format(len(results), args.out))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -25,29 +25,60 @@ using namespace std;
 //GLM
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "ClusteredLights.h"
+#include "NormalMatrix.h"
+#include "ShaderVariants.h"
+
 
 // Protótipo da função de callback do teclado
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
 
 // Protótipos de funções
-int setupShader();
 int setupGeometry();
+GLuint setupLightVolume(int &nVertices);
+
+// Estrutura do G-buffer usado no modo deferred
+struct GBuffer {
+    GLuint FBO = 0;
+    GLuint albedoTex = 0;   // cor base (RGB)
+    GLuint normalTex = 0;   // normal em espaço de mundo
+    GLuint materialTex = 0; // ka, kd, ks, q
+    GLuint depthTex = 0;    // profundidade (reconstrução da posição)
+};
+bool setupGBuffer(GBuffer &gBuffer, int width, int height);
 
 // Dimensões da janela (podem ser alteradas em tempo de execução)
 const GLuint WIDTH = 800, HEIGHT = 800;
 
-// Variáveis globais para controle de luzes
-bool lightEnabled[3] = { true, true, true };
+// Tabela de luzes: entradas 0 a 2 são as luzes principais, as demais são luzes pontuais
+LightTable lightTable;
+ClusteredLights clusteredLights;
+
+// Luzes pontuais extras (usadas para comparar forward+ x deferred; o forward ignora)
+const int MAX_POINT_LIGHTS = 256;
+int numPointLights = 64;
+
+// Modo de renderização (tecla M): forward (Phong original, só as luzes principais),
+// forward+ (luzes classificadas em clusters) ou deferred
+enum RenderMode { RENDER_FORWARD, RENDER_FORWARD_PLUS, RENDER_DEFERRED };
+const char* renderModeNames[3] = { "forward", "forward+", "deferred" };
+RenderMode renderMode = RENDER_FORWARD;
+
+// Os códigos abaixo não têm #version: ShaderVariants insere a versão e os #defines
+// de cada variante (ex.: NUM_LIGHTS) antes do código
+const char* shaderVersion = "#version 450";
 
 // Código-fonte do Vertex Shader
-const GLchar* vertexShaderSource = "#version 450\n"
+const GLchar* vertexShaderSource =
 "layout (location = 0) in vec3 position;\n"
 "layout (location = 1) in vec3 color;\n"
 "layout (location = 2) in vec3 normal;\n"
 "uniform mat4 model;\n"
+"uniform mat3 normalMatrix;\n" // inversa transposta de mat3(model), calculada na CPU
 "uniform mat4 view;\n"
 "uniform mat4 projection;\n"
 "out vec3 scaledNormal;\n"
@@ -58,12 +89,12 @@ const GLchar* vertexShaderSource = "#version 450\n"
 "    vec4 worldPos = model * vec4(position, 1.0);\n"
 "    gl_Position = projection * view * worldPos;\n"
 "    fragPos = vec3(worldPos);\n"
-"    scaledNormal = mat3(transpose(inverse(model))) * normal;\n"
+"    scaledNormal = normalMatrix * normal;\n"
 "    finalColor = color;\n"
 "}\0";
 
-// Código fonte Fragment Shader
-const GLchar* fragmentShaderSource = "#version 450\n"
+// Código fonte Fragment Shader (forward: as três luzes principais em todo fragmento)
+const GLchar* fragmentShaderSource =
 "struct Light {\n"
 "    vec3 position;\n"
 "    vec3 color;\n"
@@ -103,16 +134,175 @@ const GLchar* fragmentShaderSource = "#version 450\n"
 "    color = vec4(result,1.0);\n"
 "}\0";
 
+// Código fonte Fragment Shader (forward+: só as luzes do cluster do fragmento são avaliadas)
+const GLchar* clusteredFragmentShaderSource =
+"uniform vec3 camPos;\n"
+"uniform float ka;\n"
+"uniform float kd;\n"
+"uniform float ks;\n"
+"uniform float q;\n"
+"void clusteredLighting(vec3 P, vec3 N, vec3 V, float shininess, out vec3 ambient, out vec3 diffuse, out vec3 specular);\n"
+"in vec3 scaledNormal;\n"
+"in vec3 fragPos;\n"
+"in vec3 finalColor;\n"
+"out vec4 color;\n"
+"void main()\n"
+"{\n"
+"    vec3 N = normalize(scaledNormal);\n"
+"    vec3 V = normalize(camPos - fragPos);\n"
+"    // Luzes principais (sem atenuação) e luzes pontuais vêm da mesma tabela\n"
+"    vec3 ambient, diffuse, specular;\n"
+"    clusteredLighting(fragPos, N, V, q, ambient, diffuse, specular);\n"
+"    vec3 result = (ka * ambient + kd * diffuse) * finalColor + ks * specular;\n"
+"    color = vec4(result,1.0);\n"
+"}\0";
+
+// Bloco de luzes pontuais (UBO) e função de iluminação usada pelo passe de volumes de luz do deferred
+const GLchar* pointLightSource =
+"layout (std140) uniform PointLights {\n"
+"    vec4 plPosRadius[256];\n"
+"    vec4 plColorIntensity[256];\n"
+"};\n"
+"vec3 pointLightsContribution(vec3 P, vec3 N, vec3 V, vec3 albedo, float kd, float ks, float q, int first, int count)\n"
+"{\n"
+"    vec3 result = vec3(0.0);\n"
+"    for (int i = first; i < first + count; ++i) {\n"
+"        vec3 toLight = plPosRadius[i].xyz - P;\n"
+"        float dist = length(toLight);\n"
+"        float atten = clamp(1.0 - dist / plPosRadius[i].w, 0.0, 1.0);\n"
+"        atten *= atten;\n"
+"        if (atten <= 0.0) continue;\n"
+"        vec3 L = toLight / dist;\n"
+"        vec3 lightColor = plColorIntensity[i].rgb * plColorIntensity[i].a * atten;\n"
+"        float diff = max(dot(N, L), 0.0);\n"
+"        vec3 R = reflect(-L, N);\n"
+"        float spec = pow(max(dot(R, V), 0.0), q);\n"
+"        result += kd * diff * lightColor * albedo + ks * spec * lightColor;\n"
+"    }\n"
+"    return result;\n"
+"}\n\0";
+
+// Deferred - passe de geometria: escreve os atributos no G-buffer
+const GLchar* gBufferFragmentShaderSource =
+"uniform float ka;\n"
+"uniform float kd;\n"
+"uniform float ks;\n"
+"uniform float q;\n"
+"in vec3 scaledNormal;\n"
+"in vec3 fragPos;\n"
+"in vec3 finalColor;\n"
+"layout (location = 0) out vec4 gAlbedo;\n"
+"layout (location = 1) out vec4 gNormal;\n"
+"layout (location = 2) out vec4 gMaterial;\n"
+"void main()\n"
+"{\n"
+"    gAlbedo = vec4(finalColor, 1.0);\n"
+"    gNormal = vec4(normalize(scaledNormal), 0.0);\n"
+"    gMaterial = vec4(ka, kd, ks, q);\n"
+"}\0";
+
+// Deferred - vértices do triângulo que cobre a tela inteira (sem VBO)
+const GLchar* fullscreenVertexShaderSource =
+"void main()\n"
+"{\n"
+"    vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);\n"
+"    gl_Position = vec4(pos * 2.0 - 1.0, 0.0, 1.0);\n"
+"}\0";
+
+// Deferred - leitura do G-buffer (comum aos dois passes de iluminação)
+const GLchar* gBufferReadSource =
+"uniform sampler2D gAlbedo;\n"
+"uniform sampler2D gNormal;\n"
+"uniform sampler2D gMaterial;\n"
+"uniform sampler2D gDepth;\n"
+"uniform mat4 invViewProjection;\n"
+"uniform vec2 screenSize;\n"
+"uniform vec3 camPos;\n"
+"out vec4 color;\n"
+"bool readGBuffer(out vec3 P, out vec3 N, out vec3 albedo, out vec4 material)\n"
+"{\n"
+"    ivec2 texel = ivec2(gl_FragCoord.xy);\n"
+"    float depth = texelFetch(gDepth, texel, 0).r;\n"
+"    if (depth >= 1.0) return false;\n"
+"    vec4 ndc = vec4(vec3(gl_FragCoord.xy / screenSize, depth) * 2.0 - 1.0, 1.0);\n"
+"    vec4 world = invViewProjection * ndc;\n"
+"    P = world.xyz / world.w;\n"
+"    N = texelFetch(gNormal, texel, 0).xyz;\n"
+"    albedo = texelFetch(gAlbedo, texel, 0).rgb;\n"
+"    material = texelFetch(gMaterial, texel, 0);\n"
+"    return true;\n"
+"}\n\0";
+
+// Deferred - passe das luzes principais (mesmo modelo do forward)
+// Uma variante por quantidade de luzes habilitadas (NUM_LIGHTS); só as habilitadas são enviadas
+const GLchar* keyLightsFragmentShaderSource =
+"struct Light {\n"
+"    vec3 position;\n"
+"    vec3 color;\n"
+"    float intensity;\n"
+"};\n"
+"#if NUM_LIGHTS > 0\n"
+"uniform Light lights[NUM_LIGHTS];\n"
+"#endif\n"
+"void main()\n"
+"{\n"
+"    vec3 P, N, albedo; vec4 m;\n"
+"    if (!readGBuffer(P, N, albedo, m)) discard;\n"
+"    vec3 V = normalize(camPos - P);\n"
+"    vec3 result = vec3(0.0);\n"
+"#if NUM_LIGHTS > 0\n"
+"    for (int i = 0; i < NUM_LIGHTS; ++i) {\n"
+"        vec3 L = normalize(lights[i].position - P);\n"
+"        vec3 lightColor = lights[i].color * lights[i].intensity;\n"
+"        vec3 ambient = m.x * lightColor;\n"
+"        vec3 diffuse = m.y * max(dot(N, L), 0.0) * lightColor;\n"
+"        vec3 R = reflect(-L, N);\n"
+"        vec3 specular = m.z * pow(max(dot(R, V), 0.0), m.w) * lightColor;\n"
+"        result += (ambient + diffuse) * albedo + specular;\n"
+"    }\n"
+"#endif\n"
+"    color = vec4(result, 1.0);\n"
+"}\0";
+
+// Deferred - volume de luz: uma esfera instanciada por luz pontual,
+// só os pixels cobertos pelo volume pagam o custo daquela luz
+const GLchar* lightVolumeVertexShaderSource =
+"layout (location = 0) in vec3 position;\n"
+"layout (std140) uniform PointLights {\n"
+"    vec4 plPosRadius[256];\n"
+"    vec4 plColorIntensity[256];\n"
+"};\n"
+"uniform mat4 view;\n"
+"uniform mat4 projection;\n"
+"flat out int lightIndex;\n"
+"void main()\n"
+"{\n"
+"    vec4 posRadius = plPosRadius[gl_InstanceID];\n"
+"    gl_Position = projection * view * vec4(posRadius.xyz + position * posRadius.w, 1.0);\n"
+"    lightIndex = gl_InstanceID;\n"
+"}\0";
+
+const GLchar* lightVolumeFragmentShaderSource =
+"vec3 pointLightsContribution(vec3 P, vec3 N, vec3 V, vec3 albedo, float kd, float ks, float q, int first, int count);\n"
+"flat in int lightIndex;\n"
+"void main()\n"
+"{\n"
+"    vec3 P, N, albedo; vec4 m;\n"
+"    if (!readGBuffer(P, N, albedo, m)) discard;\n"
+"    vec3 V = normalize(camPos - P);\n"
+"    color = vec4(pointLightsContribution(P, N, V, albedo, m.y, m.z, m.w, lightIndex, 1), 1.0);\n"
+"}\0";
+
 // Estrutura para armazenar dados do modelo OBJ e transformações
 struct OBJModel {
     GLuint VAO;
     int numVertices;
     glm::vec3 position;
-    glm::vec3 rotation; 
+    glm::quat rotation; // sem trigonometria por quadro; as teclas X/Y/Z multiplicam o quatérnio
     glm::vec3 scale;
     std::vector<glm::vec3> vertices;
 
-    OBJModel(GLuint vao, int vertices) : VAO(vao), numVertices(vertices), position(0.0f), rotation(0.0f), scale(1.0f) {}
+    OBJModel(GLuint vao, int vertices) : VAO(vao), numVertices(vertices), position(0.0f), rotation(1.0f, 0.0f, 0.0f, 0.0f), scale(1.0f) {}
 };
 
 // Função para carregar um arquivo OBJ
@@ -277,8 +467,34 @@ int main()
     glViewport(0, 0, width, height);
 
 
-    // Compilação e construção do shader
-    GLuint shaderID = setupShader();
+    // Compilação e construção dos shaders (com cache dos programas linkados em disco)
+    ShaderVariants::enableBinaryCache((GLADloadproc)glfwGetProcAddress, "shader_cache");
+    ShaderVariants forwardShaders("AV2_forward", shaderVersion, { vertexShaderSource }, { fragmentShaderSource });
+    ShaderVariants clusteredShaders("AV2_clustered", shaderVersion,
+                                    { vertexShaderSource }, { clusteredFragmentShaderSource, ClusteredLights::glslSource() });
+    GLuint shaderID = forwardShaders.get(0);
+    GLuint clusteredShaderID = clusteredShaders.get(0);
+
+    // Programas do modo deferred. O passe das luzes principais é gerado sob demanda,
+    // conforme a quantidade de luzes habilitadas
+    ShaderVariants gBufferShaders("AV2_gbuffer", shaderVersion, { vertexShaderSource }, { gBufferFragmentShaderSource });
+    ShaderVariants keyLightsShaders("AV2_keylights", shaderVersion,
+                                    { fullscreenVertexShaderSource }, { gBufferReadSource, keyLightsFragmentShaderSource });
+    ShaderVariants lightVolumeShaders("AV2_lightvolume", shaderVersion,
+                                      { lightVolumeVertexShaderSource }, { gBufferReadSource, lightVolumeFragmentShaderSource, pointLightSource });
+    GLuint gBufferShaderID = gBufferShaders.get(0);
+    GLuint lightVolumeShaderID = lightVolumeShaders.get(0);
+    cout << "Shaders: " << ShaderVariants::cacheHits() << " lidos do cache, "
+         << ShaderVariants::compilations() << " compilados" << endl;
+
+    GBuffer gBuffer;
+    if (!setupGBuffer(gBuffer, width, height)) {
+        std::cout << "G-buffer incompleto, modo deferred desabilitado" << std::endl;
+    }
+    int nVerticesLightVolume;
+    GLuint lightVolumeVAO = setupLightVolume(nVerticesLightVolume);
+    GLuint fullscreenVAO; // VAO vazio: o triângulo de tela é gerado pelo gl_VertexID
+    glGenVertexArrays(1, &fullscreenVAO);
 
     // Carregando OBJ
     int numVerticesSuzanne;
@@ -289,29 +505,28 @@ int main()
         models.back().vertices = verticesSuzanne;
     }
 
-    glUseProgram(shaderID);
-    
-    // Configuração do VAO para o modelo Suzanne
-    GLint modelLoc = glGetUniformLocation(shaderID, "model");
-    GLint viewLoc = glGetUniformLocation(shaderID, "view");
-    GLint projLoc = glGetUniformLocation(shaderID, "projection");
-
-    GLint camPosLoc = glGetUniformLocation(shaderID, "camPos");
-    GLint kaLoc = glGetUniformLocation(shaderID, "ka");
-    GLint kdLoc = glGetUniformLocation(shaderID, "kd");
-    GLint ksLoc = glGetUniformLocation(shaderID, "ks");
-    GLint qLoc = glGetUniformLocation(shaderID, "q");
-
-    // Estrutura das luzes - uniforms
-    GLint lightPosLoc[3], lightColorLoc[3], lightIntensityLoc[3];
     char nameBuf[64];
-    for (int i = 0; i < 3; ++i) {
-        sprintf(nameBuf, "lights[%d].position", i);
-        lightPosLoc[i] = glGetUniformLocation(shaderID, nameBuf);
-        sprintf(nameBuf, "lights[%d].color", i);
-        lightColorLoc[i] = glGetUniformLocation(shaderID, nameBuf);
-        sprintf(nameBuf, "lights[%d].intensity", i);
-        lightIntensityLoc[i] = glGetUniformLocation(shaderID, nameBuf);
+
+    // UBO com as luzes pontuais (binding 0), usado pelos volumes de luz do deferred
+    GLuint pointLightsUBO;
+    glGenBuffers(1, &pointLightsUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, pointLightsUBO);
+    glBufferData(GL_UNIFORM_BUFFER, 2 * MAX_POINT_LIGHTS * sizeof(glm::vec4), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, 0, pointLightsUBO);
+    glUniformBlockBinding(lightVolumeShaderID, glGetUniformBlockIndex(lightVolumeShaderID, "PointLights"), 0);
+
+    // Parâmetros fixos das luzes pontuais: órbitas aleatórias em torno do modelo
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<glm::vec4> pointLightOrbit(MAX_POINT_LIGHTS); // raio da órbita, altura, fase, velocidade
+    std::vector<glm::vec4> pointLightPosRadius(MAX_POINT_LIGHTS);
+    std::vector<glm::vec4> pointLightColorIntensity(MAX_POINT_LIGHTS);
+    for (int i = 0; i < MAX_POINT_LIGHTS; ++i) {
+        pointLightOrbit[i] = glm::vec4(1.2f + 1.8f * unit(rng), -1.5f + 3.0f * unit(rng),
+                                       6.2831853f * unit(rng), 0.2f + 0.8f * unit(rng));
+        pointLightPosRadius[i].w = 1.0f + unit(rng);
+        pointLightColorIntensity[i] = glm::vec4(unit(rng), unit(rng), unit(rng), 0.6f);
     }
 
     glEnable(GL_DEPTH_TEST);
@@ -327,6 +542,31 @@ int main()
     // Intensidades das luzes
     float lightIntensities[3] = { 1.0f, 0.5f, 0.3f };
 
+    // Preenche a tabela de luzes: principais sem atenuação e com componente ambiente
+    for (int i = 0; i < 3; ++i) {
+        PointLight keyLight;
+        keyLight.color = lightColors[i];
+        keyLight.intensity = lightIntensities[i];
+        keyLight.radius = 0.0f;
+        keyLight.ambient = 1.0f;
+        lightTable.add(keyLight);
+    }
+    for (int i = 0; i < MAX_POINT_LIGHTS; ++i) {
+        PointLight pointLight;
+        pointLight.radius = pointLightPosRadius[i].w;
+        pointLight.color = glm::vec3(pointLightColorIntensity[i]);
+        pointLight.intensity = pointLightColorIntensity[i].a;
+        lightTable.add(pointLight);
+    }
+    if (!clusteredLights.init((GLADloadproc)glfwGetProcAddress)) {
+        std::cout << "Erro ao criar os buffers de luzes" << std::endl;
+    }
+
+    // Tempo médio de quadro, exibido uma vez por segundo para comparar os modos
+    int framesCounted = 0;
+    float frameTimeAccum = 0.0f;
+    std::vector<glm::mat4> modelMatrices;
+    std::vector<glm::mat3> normalMatrices;
 
     while (!glfwWindowShouldClose(window))
     {
@@ -334,45 +574,20 @@ int main()
         float deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
-        glfwPollEvents();
-
-        // Atualiza a matriz de visualização e projeção
-        glm::vec3 cameraPos = glm::vec3(0.0f, 0.0f, 5.0f);
-        viewMatrix = glm::lookAt(cameraPos, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-        projectionMatrix = glm::perspective(glm::radians(45.0f), (GLfloat)WIDTH / (GLfloat)HEIGHT, 0.1f, 100.0f);
-        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(viewMatrix));
-        glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projectionMatrix));
-        glUniform3fv(camPosLoc, 1, glm::value_ptr(cameraPos));
-        glUniform1f(kaLoc, ka);
-        glUniform1f(kdLoc, kd);
-        glUniform1f(ksLoc, ks);
-        glUniform1f(qLoc, q);
-
-        glm::vec3 objPos = models[selectedModelIndex].position;
-        float objScale = models[selectedModelIndex].scale.x;
-        glm::vec3 lightPositions[3] = {
-            objPos + glm::vec3(2.0f * objScale, 2.0f * objScale, 2.0f * objScale),
-            objPos + glm::vec3(-2.0f * objScale, 1.0f * objScale, 2.0f * objScale),
-            objPos + glm::vec3(0.0f, 3.0f * objScale, -2.0f * objScale)
-        };
-        for (int i = 0; i < 3; ++i) {
-            glUniform3fv(lightPosLoc[i], 1, glm::value_ptr(lightPositions[i]));
-            glUniform3fv(lightColorLoc[i], 1, glm::value_ptr(lightColors[i]));
-            glUniform1f(lightIntensityLoc[i], lightIntensities[i]);
+        framesCounted++;
+        frameTimeAccum += deltaTime;
+        if (frameTimeAccum >= 1.0f) {
+            cout << renderModeNames[renderMode] << " | " << numPointLights << " luzes pontuais | "
+                 << 1000.0f * frameTimeAccum / framesCounted << " ms/quadro" << endl;
+            framesCounted = 0;
+            frameTimeAccum = 0.0f;
         }
 
-        // Habilita/desabilita luzes
-        GLint lightEnabledInt[3] = { lightEnabled[0] ? 1 : 0, lightEnabled[1] ? 1 : 0, lightEnabled[2] ? 1 : 0 };
-        glUniform1iv(glGetUniformLocation(shaderID, "lightEnabled"), 3, lightEnabledInt);
-
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glLineWidth(2);
-        glPointSize(5);
+        glfwPollEvents();
 
-        // Desenha o modelo
+        // Atualiza os modelos
+        modelMatrices.resize(models.size());
         for (size_t i = 0; i < models.size(); i++) {
-            glm::mat4 model = glm::mat4(1);
             if (i == selectedModelIndex) {
                 if (isMovingForward) models[i].position.z -= translationSpeed * deltaTime;
                 if (isMovingBackward) models[i].position.z += translationSpeed * deltaTime;
@@ -383,31 +598,200 @@ int main()
                 if (isScalingUp) models[i].scale *= (1.0f + (scalingSpeed - 1.0f) * deltaTime);
                 if (isScalingDown) models[i].scale *= (1.0f - (scalingSpeed - 1.0f) * deltaTime);
                 if (rotateX || rotateY || rotateZ) {
-                    if (rotateX)
-                        models[i].rotation.x += rotationSpeed * deltaTime;
-                    else if (rotateY)
-                        models[i].rotation.y += rotationSpeed * deltaTime;
-                    else if (rotateZ)
-                        models[i].rotation.z += rotationSpeed * deltaTime;
+                    glm::vec3 axis = rotateX ? glm::vec3(1.0f, 0.0f, 0.0f) : rotateY ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(0.0f, 0.0f, 1.0f);
+                    glm::quat step = glm::angleAxis(glm::radians(rotationSpeed * deltaTime), axis);
+                    models[i].rotation = glm::normalize(step * models[i].rotation);
                 }
             }
 
-            // Aplica as transformações
+            // Aplica as transformações (usadas pelos dois modos)
+            glm::mat4 model = glm::mat4(1);
             model = glm::translate(model, models[i].position);
-            model = glm::rotate(model, glm::radians(models[i].rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-            model = glm::rotate(model, glm::radians(models[i].rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-            model = glm::rotate(model, glm::radians(models[i].rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+            model = model * glm::mat4_cast(models[i].rotation);
             model = glm::scale(model, glm::vec3(models[i].scale));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glBindVertexArray(models[i].VAO);
-            glDrawArrays(GL_TRIANGLES, 0, models[i].numVertices);
+            modelMatrices[i] = model;
+        }
+        // Matrizes de normais de todos os modelos em lote (em vez de uma inversa por vértice)
+        normalMatrices.resize(models.size());
+        computeNormalMatrices(modelMatrices.data(), normalMatrices.data(), models.size());
+
+        // Atualiza a matriz de visualização e projeção
+        glm::vec3 cameraPos = glm::vec3(0.0f, 0.0f, 5.0f);
+        viewMatrix = glm::lookAt(cameraPos, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        projectionMatrix = glm::perspective(glm::radians(45.0f), (GLfloat)WIDTH / (GLfloat)HEIGHT, 0.1f, 100.0f);
+
+        glm::vec3 objPos = models[selectedModelIndex].position;
+        float objScale = models[selectedModelIndex].scale.x;
+        glm::vec3 lightPositions[3] = {
+            objPos + glm::vec3(2.0f * objScale, 2.0f * objScale, 2.0f * objScale),
+            objPos + glm::vec3(-2.0f * objScale, 1.0f * objScale, 2.0f * objScale),
+            objPos + glm::vec3(0.0f, 3.0f * objScale, -2.0f * objScale)
+        };
+        for (int i = 0; i < 3; ++i)
+            lightTable[i].position = lightPositions[i];
+
+        // Anima as luzes pontuais e envia para o UBO
+        for (int i = 0; i < MAX_POINT_LIGHTS; ++i) {
+            PointLight& pointLight = lightTable[3 + i];
+            pointLight.enabled = i < numPointLights;
+            if (!pointLight.enabled) continue;
+            float angle = pointLightOrbit[i].z + currentFrame * pointLightOrbit[i].w;
+            glm::vec3 p = objPos + objScale * glm::vec3(pointLightOrbit[i].x * cos(angle), pointLightOrbit[i].y, pointLightOrbit[i].x * sin(angle));
+            pointLightPosRadius[i] = glm::vec4(p, pointLightPosRadius[i].w);
+            pointLight.position = p;
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, pointLightsUBO);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, numPointLights * sizeof(glm::vec4), pointLightPosRadius.data());
+        glBufferSubData(GL_UNIFORM_BUFFER, MAX_POINT_LIGHTS * sizeof(glm::vec4), numPointLights * sizeof(glm::vec4), pointLightColorIntensity.data());
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+        if (renderMode == RENDER_DEFERRED && gBuffer.FBO != 0) {
+            // 1) Passe de geometria: preenche o G-buffer
+            glBindFramebuffer(GL_FRAMEBUFFER, gBuffer.FBO);
+            glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            glEnable(GL_DEPTH_TEST);
+            glUseProgram(gBufferShaderID);
+            glUniformMatrix4fv(glGetUniformLocation(gBufferShaderID, "view"), 1, GL_FALSE, glm::value_ptr(viewMatrix));
+            glUniformMatrix4fv(glGetUniformLocation(gBufferShaderID, "projection"), 1, GL_FALSE, glm::value_ptr(projectionMatrix));
+            glUniform1f(glGetUniformLocation(gBufferShaderID, "ka"), ka);
+            glUniform1f(glGetUniformLocation(gBufferShaderID, "kd"), kd);
+            glUniform1f(glGetUniformLocation(gBufferShaderID, "ks"), ks);
+            glUniform1f(glGetUniformLocation(gBufferShaderID, "q"), q);
+            for (size_t i = 0; i < models.size(); i++) {
+                glUniformMatrix4fv(glGetUniformLocation(gBufferShaderID, "model"), 1, GL_FALSE, glm::value_ptr(modelMatrices[i]));
+                glUniformMatrix3fv(glGetUniformLocation(gBufferShaderID, "normalMatrix"), 1, GL_FALSE, glm::value_ptr(normalMatrices[i]));
+                glBindVertexArray(models[i].VAO);
+                glDrawArrays(GL_TRIANGLES, 0, models[i].numVertices);
+            }
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+            // 2) Passes de iluminação: leem o G-buffer e acumulam na tela
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            glDisable(GL_DEPTH_TEST);
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, gBuffer.albedoTex);
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, gBuffer.normalTex);
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_2D, gBuffer.materialTex);
+            glActiveTexture(GL_TEXTURE3);
+            glBindTexture(GL_TEXTURE_2D, gBuffer.depthTex);
+            glm::mat4 invViewProjection = glm::inverse(projectionMatrix * viewMatrix);
+            int enabledKeyLights = 0;
+            for (int i = 0; i < 3; ++i)
+                if (lightTable[i].enabled) enabledKeyLights++;
+            GLuint keyLightsShaderID = keyLightsShaders.get(0, enabledKeyLights);
+            GLuint lightingPrograms[2] = { keyLightsShaderID, lightVolumeShaderID };
+            for (GLuint program : lightingPrograms) {
+                glUseProgram(program);
+                glUniform1i(glGetUniformLocation(program, "gAlbedo"), 0);
+                glUniform1i(glGetUniformLocation(program, "gNormal"), 1);
+                glUniform1i(glGetUniformLocation(program, "gMaterial"), 2);
+                glUniform1i(glGetUniformLocation(program, "gDepth"), 3);
+                glUniformMatrix4fv(glGetUniformLocation(program, "invViewProjection"), 1, GL_FALSE, glm::value_ptr(invViewProjection));
+                glUniform2f(glGetUniformLocation(program, "screenSize"), (GLfloat)width, (GLfloat)height);
+                glUniform3fv(glGetUniformLocation(program, "camPos"), 1, glm::value_ptr(cameraPos));
+            }
+
+            // Luzes principais: um triângulo de tela cheia
+            glUseProgram(keyLightsShaderID);
+            for (int i = 0, slot = 0; i < 3; ++i) {
+                if (!lightTable[i].enabled) continue;
+                sprintf(nameBuf, "lights[%d].position", slot);
+                glUniform3fv(glGetUniformLocation(keyLightsShaderID, nameBuf), 1, glm::value_ptr(lightPositions[i]));
+                sprintf(nameBuf, "lights[%d].color", slot);
+                glUniform3fv(glGetUniformLocation(keyLightsShaderID, nameBuf), 1, glm::value_ptr(lightColors[i]));
+                sprintf(nameBuf, "lights[%d].intensity", slot);
+                glUniform1f(glGetUniformLocation(keyLightsShaderID, nameBuf), lightIntensities[i]);
+                slot++;
+            }
+            glBindVertexArray(fullscreenVAO);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+
+            // Luzes pontuais: volumes esféricos instanciados com blending aditivo.
+            // Faces da frente são descartadas para que o volume funcione com a câmera dentro dele
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_ONE, GL_ONE);
+            glEnable(GL_CULL_FACE);
+            glCullFace(GL_FRONT);
+            glUseProgram(lightVolumeShaderID);
+            glUniformMatrix4fv(glGetUniformLocation(lightVolumeShaderID, "view"), 1, GL_FALSE, glm::value_ptr(viewMatrix));
+            glUniformMatrix4fv(glGetUniformLocation(lightVolumeShaderID, "projection"), 1, GL_FALSE, glm::value_ptr(projectionMatrix));
+            glBindVertexArray(lightVolumeVAO);
+            glDrawArraysInstanced(GL_TRIANGLES, 0, nVerticesLightVolume, numPointLights);
             glBindVertexArray(0);
+            glCullFace(GL_BACK);
+            glDisable(GL_CULL_FACE);
+            glDisable(GL_BLEND);
+            glEnable(GL_DEPTH_TEST);
+            glActiveTexture(GL_TEXTURE0);
+        }
+        else {
+            // Forward+: classifica as luzes nos clusters da visão atual (antes de ativar o
+            // programa: a classificação na GPU usa o seu próprio)
+            if (renderMode == RENDER_FORWARD_PLUS)
+                clusteredLights.update(lightTable, viewMatrix, projectionMatrix, 0.1f, 100.0f);
+
+            GLuint program = (renderMode == RENDER_FORWARD) ? shaderID : clusteredShaderID;
+            glUseProgram(program);
+            if (renderMode == RENDER_FORWARD) {
+                // Forward: as luzes principais vão direto para os uniforms
+                GLint lightEnabledInt[3];
+                for (int i = 0; i < 3; ++i) {
+                    sprintf(nameBuf, "lights[%d].position", i);
+                    glUniform3fv(glGetUniformLocation(program, nameBuf), 1, glm::value_ptr(lightPositions[i]));
+                    sprintf(nameBuf, "lights[%d].color", i);
+                    glUniform3fv(glGetUniformLocation(program, nameBuf), 1, glm::value_ptr(lightColors[i]));
+                    sprintf(nameBuf, "lights[%d].intensity", i);
+                    glUniform1f(glGetUniformLocation(program, nameBuf), lightIntensities[i]);
+                    lightEnabledInt[i] = lightTable[i].enabled ? 1 : 0;
+                }
+                glUniform1iv(glGetUniformLocation(program, "lightEnabled"), 3, lightEnabledInt);
+            }
+            else
+                clusteredLights.bind(program, 0, width, height);
+            glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(viewMatrix));
+            glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(projectionMatrix));
+            glUniform3fv(glGetUniformLocation(program, "camPos"), 1, glm::value_ptr(cameraPos));
+            glUniform1f(glGetUniformLocation(program, "ka"), ka);
+            glUniform1f(glGetUniformLocation(program, "kd"), kd);
+            glUniform1f(glGetUniformLocation(program, "ks"), ks);
+            glUniform1f(glGetUniformLocation(program, "q"), q);
+            GLint modelLoc = glGetUniformLocation(program, "model");
+            GLint normalMatrixLoc = glGetUniformLocation(program, "normalMatrix");
+
+            glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            glLineWidth(2);
+            glPointSize(5);
+
+            // Desenha o modelo
+            for (size_t i = 0; i < models.size(); i++) {
+                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(modelMatrices[i]));
+                glUniformMatrix3fv(normalMatrixLoc, 1, GL_FALSE, glm::value_ptr(normalMatrices[i]));
+                glBindVertexArray(models[i].VAO);
+                glDrawArrays(GL_TRIANGLES, 0, models[i].numVertices);
+                glBindVertexArray(0);
+            }
         }
         glfwSwapBuffers(window);
     }
     for (const auto& model : models) {
         glDeleteVertexArrays(1, &model.VAO);
     }
+    glDeleteVertexArrays(1, &lightVolumeVAO);
+    glDeleteVertexArrays(1, &fullscreenVAO);
+    glDeleteBuffers(1, &pointLightsUBO);
+    GLuint gBufferTextures[4] = { gBuffer.albedoTex, gBuffer.normalTex, gBuffer.materialTex, gBuffer.depthTex };
+    glDeleteTextures(4, gBufferTextures);
+    glDeleteFramebuffers(1, &gBuffer.FBO);
+    forwardShaders.release();
+    clusteredShaders.release();
+    gBufferShaders.release();
+    keyLightsShaders.release();
+    lightVolumeShaders.release();
+    clusteredLights.release();
     glfwTerminate();
     return 0;
 }
@@ -444,55 +828,22 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     if (key == GLFW_KEY_RIGHT_BRACKET) isScalingUp = (action != GLFW_RELEASE);
     
     // Habilita/desabilita luzes (1, 2, 3)
-    if (key == GLFW_KEY_1 && action == GLFW_PRESS) lightEnabled[0] = !lightEnabled[0];
-    if (key == GLFW_KEY_2 && action == GLFW_PRESS) lightEnabled[1] = !lightEnabled[1];
-    if (key == GLFW_KEY_3 && action == GLFW_PRESS) lightEnabled[2] = !lightEnabled[2];
-
-}
-
-// Esta função é bastante hardcoded - o objetivo é compilar e construir um programa de shader simples e único neste exemplo de código
-// O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e fragmentShaderSource no início deste arquivo
-// A função retorna o identificador do programa de shader
-int setupShader()
-{
-    // Vertex shader
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-    // Verifica erros de compilação (exibe via log no terminal)
-    GLint success;
-    GLchar infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+    if (key == GLFW_KEY_1 && action == GLFW_PRESS) lightTable.toggle(0);
+    if (key == GLFW_KEY_2 && action == GLFW_PRESS) lightTable.toggle(1);
+    if (key == GLFW_KEY_3 && action == GLFW_PRESS) lightTable.toggle(2);
+
+    // Alterna entre forward, forward+ e deferred (M)
+    if (key == GLFW_KEY_M && action == GLFW_PRESS) {
+        renderMode = (RenderMode)((renderMode + 1) % 3);
+        cout << "Modo de renderizacao: " << renderModeNames[renderMode] << endl;
     }
-    // Fragment shader
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-    // Verifica erros de compilação (exibe via log no terminal)
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)	{
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+    // Dobra a quantidade de luzes pontuais, voltando a zero após o máximo (N)
+    if (key == GLFW_KEY_N && action == GLFW_PRESS) {
+        numPointLights = (numPointLights == 0) ? 1 : numPointLights * 2;
+        if (numPointLights > MAX_POINT_LIGHTS) numPointLights = 0;
+        cout << "Luzes pontuais: " << numPointLights << endl;
     }
-    // Vincula os shaders e cria o identificador do programa de shader
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    // Verifica erros de link
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
 
-    return shaderProgram;
 }
 
 // Esta função é bastante hardcoded - o objetivo é criar os buffers que armazenam a
@@ -558,4 +909,83 @@ int setupGeometry()
     glBindVertexArray(0);
 
     return VAO;
-}
\ No newline at end of file
+}
+
+// Cria o G-buffer: três alvos de cor (albedo, normal, material) e uma textura de profundidade
+// A função retorna false se o framebuffer não estiver completo
+bool setupGBuffer(GBuffer &gBuffer, int width, int height)
+{
+    glGenFramebuffers(1, &gBuffer.FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, gBuffer.FBO);
+
+    struct Target { GLuint* tex; GLint internalFormat; GLenum format; GLenum type; GLenum attachment; };
+    Target targets[4] = {
+        { &gBuffer.albedoTex,   GL_RGBA8,              GL_RGBA,            GL_UNSIGNED_BYTE, GL_COLOR_ATTACHMENT0 },
+        { &gBuffer.normalTex,   GL_RGBA16F,            GL_RGBA,            GL_FLOAT,         GL_COLOR_ATTACHMENT1 },
+        { &gBuffer.materialTex, GL_RGBA16F,            GL_RGBA,            GL_FLOAT,         GL_COLOR_ATTACHMENT2 },
+        { &gBuffer.depthTex,    GL_DEPTH_COMPONENT24,  GL_DEPTH_COMPONENT, GL_FLOAT,         GL_DEPTH_ATTACHMENT }
+    };
+    for (const Target& t : targets) {
+        glGenTextures(1, t.tex);
+        glBindTexture(GL_TEXTURE_2D, *t.tex);
+        glTexImage2D(GL_TEXTURE_2D, 0, t.internalFormat, width, height, 0, t.format, t.type, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, t.attachment, GL_TEXTURE_2D, *t.tex, 0);
+    }
+    GLenum drawBuffers[3] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2 };
+    glDrawBuffers(3, drawBuffers);
+
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete) {
+        glDeleteFramebuffers(1, &gBuffer.FBO);
+        gBuffer.FBO = 0;
+    }
+    return complete;
+}
+
+// Geometria do volume de luz: esfera UV de baixa resolução com raio 1
+// Os vértices são afastados do centro para que a malha envolva a esfera ideal: o fator
+// cobre o afastamento entre os meridianos e entre os paralelos (com 8 paralelos ele é
+// maior que o dos 12 meridianos)
+// A função retorna o identificador do VAO
+GLuint setupLightVolume(int &nVertices)
+{
+    const int slices = 12, stacks = 8;
+    const float pi = 3.14159265f;
+    const float circumscribe = 1.0f / (cos(pi / slices) * cos(pi / stacks));
+    std::vector<GLfloat> vBuffer;
+    for (int i = 0; i < stacks; ++i) {
+        float t0 = pi * i / stacks, t1 = pi * (i + 1) / stacks;
+        for (int j = 0; j < slices; ++j) {
+            float p0 = 2.0f * pi * j / slices, p1 = 2.0f * pi * (j + 1) / slices;
+            glm::vec3 v00(sin(t0) * cos(p0), cos(t0), sin(t0) * sin(p0));
+            glm::vec3 v01(sin(t0) * cos(p1), cos(t0), sin(t0) * sin(p1));
+            glm::vec3 v10(sin(t1) * cos(p0), cos(t1), sin(t1) * sin(p0));
+            glm::vec3 v11(sin(t1) * cos(p1), cos(t1), sin(t1) * sin(p1));
+            // Triângulos com orientação anti-horária vista de fora
+            glm::vec3 tri[6] = { v00, v01, v11, v00, v11, v10 };
+            for (const glm::vec3& v : tri) {
+                vBuffer.push_back(v.x * circumscribe);
+                vBuffer.push_back(v.y * circumscribe);
+                vBuffer.push_back(v.z * circumscribe);
+            }
+        }
+    }
+
+    GLuint VBO, VAO;
+    glGenBuffers(1, &VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vBuffer.size() * sizeof(GLfloat), vBuffer.data(), GL_STATIC_DRAW);
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    nVertices = vBuffer.size() / 3;
+    return VAO;
+}
@@ -17,12 +17,15 @@
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 // Definições de constantes
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#include "NormalMatrix.h"
+
 using namespace std;
 
 // Protótipos
@@ -35,6 +38,7 @@ const GLchar* vertexShaderSource = "#version 450\n"
 "layout (location = 2) in vec3 normal;\n"
 "layout (location = 3) in vec2 texcoord;\n"
 "uniform mat4 model;\n"
+"uniform mat3 normalMatrix;\n" // inversa transposta de mat3(model), calculada na CPU
 "uniform mat4 view;\n"
 "uniform mat4 projection;\n"
 "out vec3 scaledNormal;\n"
@@ -46,7 +50,7 @@ const GLchar* vertexShaderSource = "#version 450\n"
 "    vec4 worldPos = model * vec4(position, 1.0);\n"
 "    gl_Position = projection * view * worldPos;\n"
 "    fragPos = vec3(worldPos);\n"
-"    scaledNormal = mat3(transpose(inverse(model))) * normal;\n"
+"    scaledNormal = normalMatrix * normal;\n"
 "    finalColor = color;\n"
 "    TexCoord = texcoord;\n"
 "}\0";
@@ -92,11 +96,11 @@ struct OBJModel {
     GLuint VAO;
     int numVertices;
     glm::vec3 position;
-    glm::vec3 rotation;
+    glm::quat rotation; // sem trigonometria por quadro; as teclas X/Y/Z multiplicam o quatérnio
     glm::vec3 scale;
     std::vector<glm::vec3> vertices;
 
-    OBJModel(GLuint vao, int vertices) : VAO(vao), numVertices(vertices), position(0.0f), rotation(0.0f), scale(1.0f) {}
+    OBJModel(GLuint vao, int vertices) : VAO(vao), numVertices(vertices), position(0.0f), rotation(1.0f, 0.0f, 0.0f, 0.0f), scale(1.0f) {}
 };
 
 // Função para carregar textura
@@ -325,6 +329,7 @@ int main()
 
 	// Configurações de uniformes
     GLint modelLoc = glGetUniformLocation(shaderID, "model");
+    GLint normalMatrixLoc = glGetUniformLocation(shaderID, "normalMatrix");
     GLint viewLoc = glGetUniformLocation(shaderID, "view");
     GLint projLoc = glGetUniformLocation(shaderID, "projection");
     GLint camPosLoc = glGetUniformLocation(shaderID, "camPos");
@@ -337,6 +342,8 @@ int main()
     float lastFrame = 0.0f;
 
     float ka = 0.1f, kd = 0.7f, ks = 0.5f, q = 32.0f;
+    std::vector<glm::mat4> modelMatrices;
+    std::vector<glm::mat3> normalMatrices;
     glm::vec3 lightColor = glm::vec3(1.0f, 0.95f, 0.8f);
     float lightIntensity = 1.0f;
 
@@ -383,6 +390,8 @@ int main()
         glBindTexture(GL_TEXTURE_2D, texID);
         glUniform1i(glGetUniformLocation(shaderID, "tex"), 0);
 
+        // Atualiza os modelos e monta as matrizes de modelo
+        modelMatrices.resize(models.size());
         for (size_t i = 0; i < models.size(); i++) {
             glm::mat4 model = glm::mat4(1);
             if (i == selectedModelIndex) {
@@ -395,21 +404,25 @@ int main()
                 if (isScalingUp) models[i].scale *= (1.0f + (scalingSpeed - 1.0f) * deltaTime);
                 if (isScalingDown) models[i].scale *= (1.0f - (scalingSpeed - 1.0f) * deltaTime);
                 if (rotateX || rotateY || rotateZ) {
-                    if (rotateX)
-                        models[i].rotation.x += rotationSpeed * deltaTime;
-                    else if (rotateY)
-                        models[i].rotation.y += rotationSpeed * deltaTime;
-                    else if (rotateZ)
-                        models[i].rotation.z += rotationSpeed * deltaTime;
+                    glm::vec3 axis = rotateX ? glm::vec3(1.0f, 0.0f, 0.0f) : rotateY ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(0.0f, 0.0f, 1.0f);
+                    glm::quat step = glm::angleAxis(glm::radians(rotationSpeed * deltaTime), axis);
+                    models[i].rotation = glm::normalize(step * models[i].rotation);
                 }
             }
 
             model = glm::translate(model, models[i].position);
-            model = glm::rotate(model, glm::radians(models[i].rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-            model = glm::rotate(model, glm::radians(models[i].rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-            model = glm::rotate(model, glm::radians(models[i].rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+            model = model * glm::mat4_cast(models[i].rotation);
             model = glm::scale(model, glm::vec3(models[i].scale));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+            modelMatrices[i] = model;
+        }
+
+        // Matrizes de normais de todos os modelos em lote (em vez de uma inversa por vértice)
+        normalMatrices.resize(models.size());
+        computeNormalMatrices(modelMatrices.data(), normalMatrices.data(), models.size());
+
+        for (size_t i = 0; i < models.size(); i++) {
+            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(modelMatrices[i]));
+            glUniformMatrix3fv(normalMatrixLoc, 1, GL_FALSE, glm::value_ptr(normalMatrices[i]));
             glBindVertexArray(models[i].VAO);
             glDrawArrays(GL_TRIANGLES, 0, models[i].numVertices);
             glBindVertexArray(0);
@@ -17,6 +17,10 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <memory>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -28,6 +32,26 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "AllocationCounter.h"
+#include "AnimationTracks.h"
+#include "BenchmarkReport.h"
+#include "ClusteredLights.h"
+#include "CommandExecutorGL.h"
+#include "CommandList.h"
+#include "CompiledScene.h"
+#include "EntityWorld.h"
+#include "FileWatcher.h"
+#include "FrameAllocator.h"
+#include "FrameProfiler.h"
+#include "FrameScheduler.h"
+#include "HeadlessContext.h"
+#include "JobSystem.h"
+#include "ObjLoader.h"
+#include "ProfilerOverlay.h"
+#include "QuatMatrix.h"
+#include "SceneDiff.h"
+#include "ShaderVariants.h"
+
 using namespace std;
 using namespace glm;
 
@@ -35,55 +59,56 @@ using namespace glm;
 const GLuint WIDTH = 1200, HEIGHT = 800;
 GLFWwindow *window;
 
-// Variáveis de shader
-vector<vec3> positions;
-vector<vec2> texCoords;
-
-// --- Moon ---
-GLuint moonVAO;
-GLuint moonTextureID;
-size_t moonVertexCount = 0;
-
-// --- Mars ---
-GLuint marsVAO;
-GLuint marsTextureID;
-size_t marsVertexCount = 0;
-
-// --- Flamingo ---
-GLuint flamingoVAO;
-GLuint flamingoBodyTextureID;
-GLuint flamingoEyeTextureID;
-size_t flamingoVertexCount = 0;
-vec3 flamingoPosition = vec3(0.0f, 0.0f, -5.0f);
-vec3 flamingoScale = vec3(0.2f, 0.2f, 0.2f);
-float flamingoRotationX = 0.0f;
-float flamingoRotationY = 0.0f;
-float flamingoRotationZ = 0.0f;
-float flamingoOrbitRadius = 4.0f;
-float flamingoOrbitSpeed = 0.3f;
-float flamingoOrbitAngle = 0.0f;
-
-GLuint textureID;
-
-// --- Moon ---
-vec3 moonPosition = vec3(0.0f, 0.0f, -5.0f);
-vec3 moonScale = vec3(0.5f, 0.5f, 0.5f);
-float moonRotationX = 0.0f;
-float moonRotationY = 0.0f;
-float moonRotationZ = 0.0f;
-
-// --- Mars ---
-vec3 marsPosition = vec3(0.0f, 0.0f, -5.0f);
-vec3 marsScale = vec3(0.5f, 0.5f, 0.5f);
-float marsRotationX = 0.0f;
-float marsRotationY = 0.0f;
-float marsRotationZ = 0.0f;
+// Opções da linha de comando. Com --headless não há janela: o programa desenha
+// frameCount quadros em um contexto EGL sem display e grava cada um em
+// <outputPrefix>0000.<format>, <outputPrefix>0001.<format>, ... (CI, regressão de imagem)
+struct RunOptions {
+    bool headless = false;
+    string scenePath = "../src/scene_init.txt";
+    string shaderDirectory = "../src/shaders"; // TrabalhoGB_phong.vert, ...
+    int watchFiles = -1;         // --watch / --no-watch: recarga a quente; padrão: só com janela
+    int frameCount = 60;
+    string outputPrefix = "quadro";
+    string format = "png";
+    string tracePath;            // --trace: perfil do início em JSON do Chrome trace
+    string benchPath;            // --bench: tempos dos quadros (percentis) em JSON, ver BenchmarkReport.h
+    string cameraPath = "fixa";  // --camera-path: caminho fixo da câmera durante os quadros sem janela
+    bool showProfiler = false;   // --profiler: sobreposição do profiler (também nos quadros gravados)
+    bool overrideCamera = false; // --camera substitui a câmera do arquivo de configuração
+    vec3 cameraPosition = vec3(0.0f);
+    float cameraYaw = 0.0f;
+    float cameraPitch = 0.0f;
+};
+
+// Sem janela, o relógio avança um quadro de 1/60 s por quadro desenhado: as imagens
+// não dependem da velocidade da máquina
+const float HEADLESS_FRAME_TIME = 1.0f / 60.0f;
+
+// Benchmark sem janela (--bench): os primeiros quadros (compilação de shaders, primeiros
+// envios à GPU) ficam fora dos percentis. Com --format none nada é gravado e cada quadro
+// termina com glFinish, para o tempo do quadro incluir a GPU
+const int BENCH_WARMUP_FRAMES = 10;
+
+// Profiler (FrameProfiler.h): sobreposição na tela (tecla O) e captura de um trace
+// com os próximos TRACE_FRAMES quadros (tecla T)
+const int TRACE_FRAMES = 120;
+bool showProfiler = false;
+bool printProfilerLegend = false;
+
+// Objetos da cena: entidades criadas a partir do arquivo de configuração
+EntityWorld world;
+
+// Trilhas de quadros-chave das entidades (object.X.track.*)
+AnimationSet animationTracks;
+
+// Rascunho do carregamento das malhas (vértices temporários), esvaziado a cada malha
+LinearArena loadScratch(4 << 20);
 
 // Velocidade global
 float moveSpeed = 1.5f;
 
 // Variáveis para controle de seleção e transformação
-int selectedObject = 0; // 0 = Moon, 1 = Mars, 2 = Flamingo
+Entity selectedObject = 0; // índice da entidade (ordem do arquivo de configuração)
 bool rotateX = false, rotateY = false, rotateZ = false;
 bool isMovingForward = false, isMovingBackward = false;
 bool isMovingLeft = false, isMovingRight = false;
@@ -93,60 +118,50 @@ const float translationSpeed = 1.5f;
 const float rotationSpeed = 25.0f;
 const float scalingSpeed = 1.0f;
 
-// Estrutura para material
-struct Material {
-    vec3 ka; // Coeficiente ambiente
-    vec3 kd; // Coeficiente difuso
-    vec3 ks; // Coeficiente especular
-    float shininess; // Brilho da especular
-};
-
-// Estrutura para configuração de objetos
-struct ObjectConfig {
-    string objFile;
-    string mtlFile;
-    string textureFile;      // Para objetos com uma textura
-    string textureBodyFile;  // Para o flamingo - corpo
-    string textureEyeFile;   // Para o flamingo - olhos
-    vec3 position;
-    vec3 rotation;
-    vec3 scale;
-    string animation;
+// Cena (texto compilado em memória ou .cena mapeado, CompiledScene.h): câmera, luz e
+// objetos. Na montagem, o índice de cada objeto é também o id da entidade criada (e a
+// tecla de seleção); depois de uma recarga, ver sceneEntities
+CompiledScene scene;
+
+// Malhas e texturas já carregadas, pelo arquivo: reaproveitadas entre objetos e entre
+// recargas da cena (só o arquivo alterado é lido de novo)
+struct MeshAsset {
+    GLuint VAO;
+    GLsizei vertexCount;
+    float radius; // esfera envolvente, para o culling
     Material material;
-    
-    // Parâmetros de órbita (se animation == "orbit")
-    string orbitTarget;
-    float orbitRadius;
-    float orbitSpeed;
-
-
 };
+PoolSet assetPools;
+PoolMap<string, MeshAsset> meshAssets{ PoolAllocator<pair<const string, MeshAsset>>(assetPools) }; // "obj|mtl"
+PoolMap<string, GLuint> textureAssets{ PoolAllocator<pair<const string, GLuint>>(assetPools) };
 
-// Mapa de configurações de objetos
-map<string, ObjectConfig> objectConfigs;
+// Entidade de cada objeto de scene (o índice do objeto muda entre recargas da cena, a
+// entidade não) e quantas entidades foram removidas por recargas desde a última montagem
+vector<Entity> sceneEntities;
+size_t removedEntities = 0;
 
-// Estrutura para configuração da câmera
-struct CameraConfig {
-    vec3 position;
-    float yaw;
-    float pitch;
-    float fov;
-    float nearPlane;
-    float farPlane;
-};
-
-// Estrutura para configuração da luz
-struct LightConfig {
-    vec3 position;
-    vec3 color;
-};
+// Recarga a quente da cena, dos shaders, das malhas e das texturas (FileWatcher.h)
+FileWatcher fileWatcher;
 
 // Variável de cor do objeto
 vec3 objectColor = vec3(1.0f, 1.0f, 1.0f); // Cor branca padrão
 
-// Variáveis de configuração
-CameraConfig cameraConfig;
-LightConfig lightConfig;
+// Tabela de luzes da cena (a luz do arquivo de configuração é a entrada 0)
+LightTable lightTable;
+ClusteredLights clusteredLights;
+
+// Cena de benchmark com milhares de luzes pontuais em movimento (tecla B)
+const int BENCHMARK_LIGHT_COUNT = 4096;
+bool lightBenchmark = false;
+
+// Pré-passo de profundidade (tecla P): os objetos opacos escrevem só a profundidade
+// e o passo de iluminação usa GL_EQUAL, sombreando cada pixel visível uma única vez
+bool useDepthPrePass = true;
+
+// Pipeline statistics query (GL_ARB_pipeline_statistics_query), ausente na GLAD 4.0
+#ifndef GL_FRAGMENT_SHADER_INVOCATIONS_ARB
+#define GL_FRAGMENT_SHADER_INVOCATIONS_ARB 0x82F4
+#endif
 
 // Classe Camera
 class Camera
@@ -223,83 +238,18 @@ private:
 //  Variáveis da câmera
 Camera camera;
 
-// Vertex Shader
-const char *vertexShaderSource = R"(
-#version 400 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec2 aTexCoord;
-layout (location = 2) in vec3 aNormal;
-
-out vec2 TexCoord;
-out vec3 FragPos;
-out vec3 Normal;
-
-uniform mat4 projection;
-uniform mat4 view;
-uniform mat4 model;
-
-void main()
-{
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
-    TexCoord = aTexCoord;
-}
-)";
-
-// Fragment Shader
-const char *fragmentShaderSource = R"(
-#version 400 core
-in vec2 TexCoord;
-in vec3 FragPos;
-in vec3 Normal;
-
-out vec4 FragColor;
-
-uniform sampler2D texture1;
-uniform vec3 lightPos;
-uniform vec3 viewPos;
-uniform vec3 lightColor;
-uniform vec3 objectColor;
-uniform int useEyeTexture; // Novo parâmetro para distinguir texturas
-
-// Coeficientes de material
-uniform vec3 Ka; // Coeficiente ambiente
-uniform vec3 Kd; // Coeficiente difuso
-uniform vec3 Ks; // Coeficiente especular
-uniform float shininess; // Brilho da especular
-
-void main()
-{
-    // Componente ambiente
-    vec3 ambient = Ka * lightColor;
-
-    // Componente difusa
-    vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
-    float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = Kd * diff * lightColor;
-
-    // Componente especular
-    vec3 viewDir = normalize(viewPos - FragPos);
-    vec3 reflectDir = reflect(-lightDir, norm);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
-    vec3 specular = Ks * spec * lightColor;
-
-    // Iluminação final de Phong
-    vec3 phong = ambient + diffuse + specular;
-
-    // Combinar com a textura
-    vec4 texColor = texture(texture1, TexCoord);
-    
-    // Se for a textura do olho e o pixel for transparente, descartá-lo
-    if (useEyeTexture == 1 && texColor.a < 0.1) {
-        discard;
-    }
-    
-    FragColor = vec4(phong, 1.0) * texColor;
-}
-)";
+// Os shaders de Phong e do pré-passo de profundidade ficam em src/shaders, sem #version:
+// ShaderVariants insere a versão e os #defines de cada variante (TEXTURED, ALPHA_TEST, ...)
+// antes do código. Eles são recarregados quando os arquivos mudam
+const char *shaderVersion = "#version 400 core";
+
+// Código de um par de shaders (<nome>.vert e <nome>.frag) e as suas variantes. O código
+// vive junto com as variantes: ShaderVariants guarda só os ponteiros
+struct ShaderFiles {
+    string vertexSource;
+    string fragmentSource;
+    unique_ptr<ShaderVariants> variants;
+};
 
 const char* bgVertexShaderSource = R"(
 #version 400 core
@@ -323,161 +273,213 @@ void main() {
 )";
 
 // Funções auxiliares - protótipos
+bool parseOptions(int argc, char** argv, RunOptions& options);
+string frameFileName(const RunOptions& options, int frame);
+void cameraPathPose(const string& path, float t, const CameraConfig& start, Camera& out);
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
-GLuint setupShader();
 GLuint setupGeometry();
 GLuint setupGeometry(const vector<vec3>& positions, const vector<vec2>& texCoords);
 GLuint setupGeometry(const vector<vec3>& positions, const vector<vec2>& texCoords, const vector<vec3>& normals);
 GLuint loadTexture(const string &filePath);
-bool loadOBJ(const string &objPath, const string &mtlPath, string &textureFileOut,
-             vector<vec3>& outPositions, vector<vec2>& outTexCoords);
-bool loadOBJ(const string &objPath, const string &mtlPath, string &textureFileOut,
-             vector<vec3>& outPositions, vector<vec2>& outTexCoords, vector<vec3>& outNormals,
-             Material& outMaterial);
-void drawObject(GLuint shaderProgram, GLuint VAO, size_t vertexCount, vec3 position, vec3 scaleVec, vec3 rotation, Material material);
-bool loadSceneConfig(const string &configFile);
+bool readShaderFiles(const string& directory, const string& name, ShaderFiles& files);
+void createShaderVariants(const string& name, ShaderFiles& files, const char* fragmentAppendix);
+const MeshAsset* meshFor(const string& objFile, const string& mtlFile);
+GLuint textureFor(const string& file);
+void watchScene(const string& path, const vector<string>& files);
+bool createSceneEntities();
+bool applySceneDiff(const CompiledScene& after, const SceneDiff& diff);
+void recordObject(CommandList& list, GLuint shaderProgram, GLuint texture, Entity entity, float depth);
 vec3 keepInBounds(const vec3& position);
 void loadTrajectoryPoints(vector<vec3> &points, const string &filename);
 void saveTrajectoryPoints(const vector<vec3> &points, const string &filename);
 
 // Função MAIN
-int main()
+int main(int argc, char** argv)
 {
-    // Inicialização do GLFW, janela, etc.
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    window = glfwCreateWindow(WIDTH, HEIGHT, "GB", nullptr, nullptr);
-    glfwMakeContextCurrent(window);
-    glfwSetKeyCallback(window, key_callback);
-
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        cout << "Failed to initialize GLAD" << endl;
+    RunOptions options;
+    if (!parseOptions(argc, argv, options))
         return -1;
+
+    // Com --trace, o perfil inclui o carregamento (gravado junto com o primeiro quadro)
+    if (!options.tracePath.empty())
+        FrameProfiler::capture(options.headless ? options.frameCount : TRACE_FRAMES, options.tracePath);
+    showProfiler = options.showProfiler;
+
+    // Sem janela: contexto EGL e framebuffer próprio, ligado no lugar do da janela
+    HeadlessContext headless;
+    GLADloadproc glLoader = (GLADloadproc)glfwGetProcAddress;
+    if (options.headless) {
+        if (!headless.create(WIDTH, HEIGHT))
+            return -1;
+        glLoader = HeadlessContext::procAddress();
     }
+    else {
+        // Inicialização do GLFW, janela, etc.
+        glfwInit();
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+        window = glfwCreateWindow(WIDTH, HEIGHT, "GB", nullptr, nullptr);
+        glfwMakeContextCurrent(window);
+        glfwSetKeyCallback(window, key_callback);
+
+        if (!gladLoadGLLoader(glLoader))
+        {
+            cout << "Failed to initialize GLAD" << endl;
+            return -1;
+        }
 
-    glViewport(0, 0, WIDTH, HEIGHT);
+        glViewport(0, 0, WIDTH, HEIGHT);
+    }
     glEnable(GL_DEPTH_TEST);
 
-    // Carregar configuração da cena
-    if (!loadSceneConfig("../src/scene_init.txt")) {
-        cout << "ERRO CRÍTICO: Arquivo de configuração scene_init.txt não encontrado." << endl;
+    // Carregar configuração da cena (o tempo de carga entra no benchmark)
+    chrono::steady_clock::time_point loadStart = chrono::steady_clock::now();
+    vector<string> sceneFiles;
+    if (!loadScene(options.scenePath, scene, &sceneFiles)) {
+        cout << "ERRO CRÍTICO: Arquivo de configuração " << options.scenePath << " não encontrado ou inválido." << endl;
         cout << "O programa não pode continuar sem o arquivo de configuração." << endl;
         glfwTerminate();
         return -1;
     }
+    double loadMilliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - loadStart).count();
+    watchScene(options.scenePath, sceneFiles);
+    if (options.overrideCamera) {
+        scene.camera.position = options.cameraPosition;
+        scene.camera.yaw = options.cameraYaw;
+        scene.camera.pitch = options.cameraPitch;
+    }
     
     // Configuração da câmera
-    camera = Camera(cameraConfig.position, cameraConfig.yaw, cameraConfig.pitch);
+    camera = Camera(scene.camera.position, scene.camera.yaw, scene.camera.pitch);
     
     // Configuração da projeção
-    mat4 projection = perspective(radians(cameraConfig.fov), 
+    mat4 projection = perspective(radians(scene.camera.fov), 
                                  (float)WIDTH / (float)HEIGHT, 
-                                 cameraConfig.nearPlane, 
-                                 cameraConfig.farPlane);
+                                 scene.camera.nearPlane, 
+                                 scene.camera.farPlane);
     
-    // Configuração da luz
-    vec3 lightPos = lightConfig.position;
-    vec3 lightColor = lightConfig.color;
-    
-    // Configuração do shader
-    GLuint shaderProgram = setupShader();
-    
-    // --- MOON ---
-    auto& moonCfg = objectConfigs["moon"];
-    vector<vec3> moonPositions;
-    vector<vec2> moonTexCoords;
-    positions.clear();
-    texCoords.clear();
-    string moonTextureFile;
-    vector<vec3> moonNormals;
-    Material moonMaterial;
-    if (!loadOBJ(moonCfg.objFile, moonCfg.mtlFile, moonTextureFile, moonPositions, moonTexCoords, moonNormals, moonMaterial)) {
-        cout << "Erro ao carregar " << moonCfg.objFile << endl;
+    // Configuração da luz: entrada 0 da tabela, sem atenuação e com componente ambiente
+    PointLight sceneLight;
+    sceneLight.position = scene.light.position;
+    sceneLight.color = scene.light.color;
+    sceneLight.radius = 0.0f;
+    sceneLight.ambient = 1.0f;
+    lightTable.add(sceneLight);
+    if (!clusteredLights.init(glLoader)) {
+        cout << "Erro ao criar os buffers de luzes" << endl;
         return -1;
     }
-    moonTextureID = loadTexture(moonCfg.textureFile);
-    if (moonTextureID == 0) {
-        cout << "Erro ao carregar textura: " << moonCfg.textureFile << endl;
-        return -1;
+
+    // Órbitas das luzes do benchmark: raio, altura, fase e velocidade angular
+    vector<vec4> benchmarkOrbits(BENCHMARK_LIGHT_COUNT);
+    {
+        mt19937 rng(1234);
+        uniform_real_distribution<float> unit(0.0f, 1.0f);
+        for (int i = 0; i < BENCHMARK_LIGHT_COUNT; ++i) {
+            benchmarkOrbits[i] = vec4(1.0f + 11.0f * unit(rng), -3.0f + 6.0f * unit(rng),
+                                      6.2831853f * unit(rng), (unit(rng) - 0.5f) * 1.5f);
+            PointLight light;
+            light.radius = 1.0f + 1.5f * unit(rng);
+            light.color = vec3(unit(rng), unit(rng), unit(rng));
+            light.intensity = 0.8f;
+            light.enabled = false;
+            lightTable.add(light);
+        }
     }
-    moonVAO = setupGeometry(moonPositions, moonTexCoords, moonNormals);
-    moonVertexCount = moonPositions.size();
+    int benchmarkFrames = 0;
+    float benchmarkTime = 0.0f;
     
-    // Configuração da lua
-    moonPosition = moonCfg.position;
-    moonScale = moonCfg.scale;
-    moonRotationX = moonCfg.rotation.x;
-    moonRotationY = moonCfg.rotation.y;
-    moonRotationZ = moonCfg.rotation.z;
-    objectConfigs["moon"].material = moonMaterial;
-    
-    // --- MARS ---
-    auto& marsCfg = objectConfigs["mars"];
-    vector<vec3> marsPositions;
-    vector<vec2> marsTexCoords;
-    positions.clear();
-    texCoords.clear();
-    string marsTextureFile;
-    vector<vec3> marsNormals;
-    Material marsMaterial;
-    if (!loadOBJ(marsCfg.objFile, marsCfg.mtlFile, marsTextureFile, marsPositions, marsTexCoords, marsNormals, marsMaterial)) {
-        cout << "Erro ao carregar " << marsCfg.objFile << endl;
-        return -1;
-    }
-    marsTextureID = loadTexture(marsCfg.textureFile);
-    if (marsTextureID == 0) {
-        cout << "Erro ao carregar textura: " << marsCfg.textureFile << endl;
+    // Configuração dos shaders: variante opaca, variante com teste alfa e pré-passo de profundidade.
+    // Os programas linkados ficam em cache no disco e não são recompilados nas próximas execuções
+    ShaderVariants::enableBinaryCache(glLoader, "shader_cache");
+    shared_ptr<ShaderFiles> phongShaders = make_shared<ShaderFiles>(), depthShaders = make_shared<ShaderFiles>();
+    if (!readShaderFiles(options.shaderDirectory, "TrabalhoGB_phong", *phongShaders) ||
+        !readShaderFiles(options.shaderDirectory, "TrabalhoGB_depth", *depthShaders))
         return -1;
-    }
-    marsVAO = setupGeometry(marsPositions, marsTexCoords, marsNormals);
-    marsVertexCount = marsPositions.size();
-    
-    // Configuração de Marte
-    marsPosition = marsCfg.position;
-    marsScale = marsCfg.scale;
-    marsRotationX = marsCfg.rotation.x;
-    marsRotationY = marsCfg.rotation.y;
-    marsRotationZ = marsCfg.rotation.z;
-    objectConfigs["mars"].material = marsMaterial;
-    
-    // --- FLAMINGO ---
-    auto& flamingoCfg = objectConfigs["flamingo"];
-    vector<vec3> flamingoPositions;
-    vector<vec2> flamingoTexCoords;
-    positions.clear();
-    texCoords.clear();
-    string flamingoTextureFile;
-    vector<vec3> flamingoNormals;
-    Material flamingoMaterial;
-    if (!loadOBJ(flamingoCfg.objFile, flamingoCfg.mtlFile, flamingoTextureFile, flamingoPositions, flamingoTexCoords, flamingoNormals, flamingoMaterial)) {
-        cout << "Erro ao carregar " << flamingoCfg.objFile << endl;
+    // O código das luzes em clusters é anexado ao fragment shader
+    createShaderVariants("TrabalhoGB_phong", *phongShaders, ClusteredLights::glslSource());
+    createShaderVariants("TrabalhoGB_depth", *depthShaders, nullptr);
+    GLuint shaderProgram = 0, alphaTestShaderProgram = 0, depthShaderProgram = 0;
+    auto selectPrograms = [&]() {
+        shaderProgram = phongShaders->variants->get(SHADER_TEXTURED);
+        alphaTestShaderProgram = phongShaders->variants->get(SHADER_TEXTURED | SHADER_ALPHA_TEST);
+        depthShaderProgram = depthShaders->variants->get(0);
+        return shaderProgram != 0 && alphaTestShaderProgram != 0 && depthShaderProgram != 0;
+    };
+    if (!selectPrograms()) {
+        cout << "Erro ao compilar os shaders" << endl;
         return -1;
     }
 
-    // Carregar texturas do flamingo
-    flamingoBodyTextureID = loadTexture(flamingoCfg.textureBodyFile);
-    flamingoEyeTextureID = loadTexture(flamingoCfg.textureEyeFile);
-    if (flamingoBodyTextureID == 0 || flamingoEyeTextureID == 0) {
-        cout << "Erro ao carregar texturas do flamingo." << endl;
+    // Executa as filas de comandos; guarda as posições dos uniforms de cada programa
+    CommandExecutorGL executor;
+
+    // Recarga dos shaders: o par de arquivos é lido na thread do FileWatcher e, entre dois
+    // quadros, as variantes novas são compiladas. Os programas só são trocados se todas
+    // compilam; com erro, os anteriores continuam em uso. Os programas apagados tiram as
+    // posições guardadas do executor (o identificador pode voltar em um programa novo)
+    auto watchShaders = [&](const string& name, shared_ptr<ShaderFiles>& live, const char* fragmentAppendix) {
+        FileWatcher::Importer importer = [&, name, fragmentAppendix]() -> FileWatcher::Apply {
+            shared_ptr<ShaderFiles> loaded = make_shared<ShaderFiles>();
+            if (!readShaderFiles(options.shaderDirectory, name, *loaded))
+                return nullptr;
+            return [&, name, fragmentAppendix, loaded]() {
+                shared_ptr<ShaderFiles> previous = live;
+                createShaderVariants(name, *loaded, fragmentAppendix);
+                live = loaded;
+                if (selectPrograms()) {
+                    previous->variants->release();
+                    executor.clear();
+                    cout << "Shaders recarregados: " << name << endl;
+                }
+                else {
+                    live = previous;
+                    selectPrograms();
+                    loaded->variants->release();
+                    executor.clear();
+                    cout << "Erro ao compilar " << name << ": mantidos os shaders anteriores" << endl;
+                }
+            };
+        };
+        fileWatcher.watch(options.shaderDirectory + "/" + name + ".vert", importer);
+        fileWatcher.watch(options.shaderDirectory + "/" + name + ".frag", importer);
+    };
+    watchShaders("TrabalhoGB_phong", phongShaders, ClusteredLights::glslSource());
+    watchShaders("TrabalhoGB_depth", depthShaders, nullptr);
+    cout << "Shaders: " << ShaderVariants::cacheHits() << " lidos do cache, "
+         << ShaderVariants::compilations() << " compilados" << endl;
+
+    // Contagem de invocações do fragment shader no passo de iluminação. Sem a extensão,
+    // GL_SAMPLES_PASSED (amostras que passam no teste de profundidade) é a aproximação
+    const char* pipelineStatistics = "GL_ARB_pipeline_statistics_query";
+    bool hasPipelineStatistics = options.headless ? headless.extensionSupported(pipelineStatistics)
+                                                  : glfwExtensionSupported(pipelineStatistics);
+    GLenum fragmentQueryTarget = hasPipelineStatistics ? GL_FRAGMENT_SHADER_INVOCATIONS_ARB : GL_SAMPLES_PASSED;
+    GLuint fragmentQueries[2];
+    glGenQueries(2, fragmentQueries);
+    int queryFrame = 0;
+    int queryModes[2] = { 0, 0 }; // modo (sem / com pré-passo) de cada consulta em andamento
+    GLuint64 fragmentCountSum[2] = { 0, 0 }; // acumulado no último segundo, por modo (sem / com pré-passo)
+    int fragmentCountFrames[2] = { 0, 0 };
+    double fragmentCountAverage[2] = { -1.0, -1.0 };
+    float statsTime = 0.0f;
+
+    // Alocações no heap da parte de CPU do quadro (órbitas, transformações, culling e
+    // gravação dos comandos): deve ser zero depois dos primeiros quadros
+    size_t cpuAllocationSum = 0;
+    int cpuAllocationFrames = 0;
+    
+    // Cria uma entidade para cada objeto do arquivo de configuração
+    loadStart = chrono::steady_clock::now();
+    if (!createSceneEntities()) {
+        glfwTerminate();
         return -1;
     }
+    loadMilliseconds += chrono::duration<double, milli>(chrono::steady_clock::now() - loadStart).count();
 
-    flamingoVAO = setupGeometry(flamingoPositions, flamingoTexCoords, flamingoNormals);
-    flamingoVertexCount = flamingoPositions.size();
-    
-    // Configuração do flamingo
-    flamingoPosition = flamingoCfg.position;
-    flamingoScale = flamingoCfg.scale;
-    flamingoRotationX = flamingoCfg.rotation.x;
-    flamingoRotationY = flamingoCfg.rotation.y;
-    flamingoRotationZ = flamingoCfg.rotation.z;
-    objectConfigs["flamingo"].material = flamingoMaterial;
-
-    float lastFrameTime = glfwGetTime();
+    float lastFrameTime = options.headless ? 0.0f : glfwGetTime();
 
     GLuint bgShaderProgram;
     {
@@ -499,7 +501,7 @@ int main()
     }
 
     // Carregar textura de fundo
-    GLuint backgroundTexID = loadTexture("../assets/tex/fundo-estrelas.jpg");
+    GLuint backgroundTexID = textureFor("../assets/tex/fundo-estrelas.jpg");
     if (backgroundTexID == 0) {
         cout << "Erro ao carregar textura de fundo." << endl;
         return -1;
@@ -529,7 +531,8 @@ int main()
 
     // Instruções de uso
     cout << "\n=== CONTROLES DE SELECAO E TRANSFORMACAO ===" << endl;
-    cout << "1, 2, 3: Selecionar Lua, Marte ou Flamingo" << endl;
+    for (Entity entity = 0; entity < world.size() && entity < 9; ++entity)
+        cout << entity + 1 << ": Selecionar " << world.names[entity] << endl;
     cout << "X, Y, Z: Ativar rotacao no eixo correspondente" << endl;
     cout << "R: Desativar rotacao" << endl;
     cout << "WASD: Mover objeto no plano XZ" << endl;
@@ -538,197 +541,391 @@ int main()
     cout << "Setas: Mover camera pela cena" << endl;
     cout << "J/L: Rotacionar camera horizontalmente" << endl;
     cout << "Q/E: Rotacionar camera verticalmente" << endl;
+    cout << "B: Cena de benchmark com " << BENCHMARK_LIGHT_COUNT << " luzes pontuais" << endl;
+    cout << "P: Liga/desliga o pre-passo de profundidade" << endl;
+    cout << "O: Liga/desliga a sobreposicao do profiler" << endl;
+    cout << "T: Grava um trace dos proximos " << TRACE_FRAMES << " quadros (perfil_TrabalhoGB.json)" << endl;
     cout << "================================================\n" << endl;
 
-    while (!glfwWindowShouldClose(window))
+    // Recarga a quente: a cena, os shaders, as malhas e as texturas já carregados são
+    // observados; o que mudar em disco entra no início do próximo quadro
+    if (options.watchFiles && fileWatcher.start())
+        cout << "Recarga a quente ativa (" << (fileWatcher.usingInotify() ? "inotify" : "datas dos arquivos")
+             << "): cena, shaders em " << options.shaderDirectory << ", malhas e texturas" << endl;
+
+    // As órbitas avançam em passos fixos de 1/60 s, independente da taxa de quadros
+    FixedTimestep timestep(1.0 / 60.0);
+
+    // Atualização, transformações e culling das entidades divididos entre os núcleos
+    JobSystem jobs;
+
+    // Comandos de desenho de cada passo, gravados pelas threads e executados nesta
+    CommandQueue depthQueue(jobs.threadCount()), opaqueQueue(jobs.threadCount()), alphaQueue(jobs.threadCount());
+
+    // Contadores do profiler para a última fila executada
+    auto countExecution = [&executor]() {
+        FrameProfiler::count(PROFILE_DRAW_CALLS, executor.lastDrawCalls());
+        FrameProfiler::count(PROFILE_STATE_CHANGES, executor.lastStateChanges());
+        FrameProfiler::count(PROFILE_TRIANGLES, executor.lastTriangles());
+    };
+    ProfilerOverlay profilerOverlay;
+    if (!profilerOverlay.init())
+        cout << "Erro ao criar a sobreposicao do profiler" << endl;
+
+    int frame = 0;
+    vector<uint8_t> frameImage; // quadro lido do framebuffer, sem janela
+    chrono::steady_clock::time_point renderStart = chrono::steady_clock::now();
+
+    // Amostras do benchmark (--bench), um valor por quadro depois do aquecimento
+    vector<double> benchFrameTimes, benchCpuTimes, benchGpuTimes, benchDrawCalls;
+    if (!options.benchPath.empty()) {
+        benchFrameTimes.reserve(options.frameCount);
+        benchCpuTimes.reserve(options.frameCount);
+        benchGpuTimes.reserve(options.frameCount);
+        benchDrawCalls.reserve(options.frameCount);
+    }
+
+    while (options.headless ? frame < options.frameCount : !glfwWindowShouldClose(window))
     {
-        float currentFrameTime = glfwGetTime();
+        float currentFrameTime = options.headless ? (frame + 1) * HEADLESS_FRAME_TIME : (float)glfwGetTime();
         float deltaTime = currentFrameTime - lastFrameTime;
         lastFrameTime = currentFrameTime;
+        chrono::steady_clock::time_point frameStart = chrono::steady_clock::now();
+        FrameProfiler::beginFrame();
 
-        glfwPollEvents();
-
-        // Processamento de entrada
-        if (selectedObject == 0) {  // Moon
-            // Translação
-            if (isMovingForward) moonPosition.z -= translationSpeed * deltaTime;
-            if (isMovingBackward) moonPosition.z += translationSpeed * deltaTime;
-            if (isMovingLeft) moonPosition.x -= translationSpeed * deltaTime;
-            if (isMovingRight) moonPosition.x += translationSpeed * deltaTime;
-            if (isMovingUp) moonPosition.y += translationSpeed * deltaTime;
-            if (isMovingDown) moonPosition.y -= translationSpeed * deltaTime;
-            
-            // Escala
-            if (isScalingUp) moonScale *= (1.0f + scalingSpeed * deltaTime);
-            if (isScalingDown) moonScale *= (1.0f - scalingSpeed * deltaTime);
-            
-            // Rotação
-            if (rotateX) moonRotationX += rotationSpeed * deltaTime;
-            if (rotateY) moonRotationY += rotationSpeed * deltaTime;
-            if (rotateZ) moonRotationZ += rotationSpeed * deltaTime;
+        // Arquivos alterados, já importados pela thread do FileWatcher, entram entre dois quadros
+        if (fileWatcher.running()) {
+            PROFILE_SCOPE("recarga");
+            fileWatcher.applyReloads();
         }
-        else if (selectedObject == 1) {  // Mars
-            // Translação
-            if (isMovingForward) marsPosition.z -= translationSpeed * deltaTime;
-            if (isMovingBackward) marsPosition.z += translationSpeed * deltaTime;
-            if (isMovingLeft) marsPosition.x -= translationSpeed * deltaTime;
-            if (isMovingRight) marsPosition.x += translationSpeed * deltaTime;
-            if (isMovingUp) marsPosition.y += translationSpeed * deltaTime;
-            if (isMovingDown) marsPosition.y -= translationSpeed * deltaTime;
+
+        // Sem janela, a câmera segue o caminho fixo pedido (uma volta no total de quadros)
+        if (options.headless)
+            cameraPathPose(options.cameraPath, (float)frame / options.frameCount, scene.camera, camera);
+
+        {
+            PROFILE_SCOPE("entrada");
+            if (!options.headless)
+                glfwPollEvents();
+
+            // Processamento de entrada: transforma a entidade selecionada
+            if (selectedObject < world.size()) {
+                vec3& position = world.positions[selectedObject];
+                vec3& scale = world.scales[selectedObject];
+                quat& rotation = world.rotations[selectedObject];
+
+                // Translação
+                if (isMovingForward) position.z -= translationSpeed * deltaTime;
+                if (isMovingBackward) position.z += translationSpeed * deltaTime;
+                if (isMovingLeft) position.x -= translationSpeed * deltaTime;
+                if (isMovingRight) position.x += translationSpeed * deltaTime;
+                if (isMovingUp) position.y += translationSpeed * deltaTime;
+                if (isMovingDown) position.y -= translationSpeed * deltaTime;
             
-            // Escala
-            if (isScalingUp) marsScale *= (1.0f + scalingSpeed * deltaTime);
-            if (isScalingDown) marsScale *= (1.0f - scalingSpeed * deltaTime);
+                // Escala
+                if (isScalingUp) scale *= (1.0f + scalingSpeed * deltaTime);
+                if (isScalingDown) scale *= (1.0f - scalingSpeed * deltaTime);
             
-            // Rotação
-            if (rotateX) marsRotationX += rotationSpeed * deltaTime;
-            if (rotateY) marsRotationY += rotationSpeed * deltaTime;
-            if (rotateZ) marsRotationZ += rotationSpeed * deltaTime;
+                // Rotação incremental em torno dos eixos do mundo (renormalizada para não acumular erro)
+                float step = radians(rotationSpeed * deltaTime);
+                if (rotateX) rotation = normalize(angleAxis(step, vec3(1.0f, 0.0f, 0.0f)) * rotation);
+                if (rotateY) rotation = normalize(angleAxis(step, vec3(0.0f, 1.0f, 0.0f)) * rotation);
+                if (rotateZ) rotation = normalize(angleAxis(step, vec3(0.0f, 0.0f, 1.0f)) * rotation);
+
+                if (isMovingForward || isMovingBackward || isMovingLeft || isMovingRight || isMovingUp ||
+                    isMovingDown || isScalingUp || isScalingDown || rotateX || rotateY || rotateZ)
+                    world.markDirty(selectedObject);
+            }
         }
-        else if (selectedObject == 2) {  // Flamingo
-            // Translação
-            if (isMovingForward) flamingoPosition.z -= translationSpeed * deltaTime;
-            if (isMovingBackward) flamingoPosition.z += translationSpeed * deltaTime;
-            if (isMovingLeft) flamingoPosition.x -= translationSpeed * deltaTime;
-            if (isMovingRight) flamingoPosition.x += translationSpeed * deltaTime;
-            if (isMovingUp) flamingoPosition.y += translationSpeed * deltaTime;
-            if (isMovingDown) flamingoPosition.y -= translationSpeed * deltaTime;
-            
-            // Escala
-            if (isScalingUp) flamingoScale *= (1.0f + scalingSpeed * deltaTime);
-            if (isScalingDown) flamingoScale *= (1.0f - scalingSpeed * deltaTime);
-            
-            // Rotação
-            if (rotateX) flamingoRotationX += rotationSpeed * deltaTime;
-            if (rotateY) flamingoRotationY += rotationSpeed * deltaTime;
-            if (rotateZ) flamingoRotationZ += rotationSpeed * deltaTime;
+
+        // Atualiza as órbitas (exceto a do objeto selecionado) em ticks fixos e desenha
+        // com o ângulo interpolado entre os dois últimos ticks
+        size_t allocationsBefore = allocationCount();
+        {
+            PROFILE_SCOPE("simulacao");
+            int ticks = timestep.advance(deltaTime);
+            float step = (float)timestep.step(), alpha = timestep.alpha();
+            jobs.parallelFor(world.size(), 4096, [&](size_t begin, size_t end) {
+                PROFILE_SCOPE("orbitas (bloco)");
+                for (int tick = 0; tick < ticks; ++tick)
+                    stepOrbits(world, step, selectedObject, begin, end - begin);
+                applyOrbits(world, alpha, selectedObject, begin, end - begin);
+            });
+
+            // Trilhas de quadros-chave, amostradas no tempo da simulação (interpolado como as órbitas)
+            evaluateAnimations(world, animationTracks, (float)((timestep.ticks() + alpha) * step), selectedObject, &jobs);
         }
+        cpuAllocationSum += allocationCount() - allocationsBefore;
 
-        // Atualiza a órbita do flamingo apenas se não estiver selecionado
-        if (selectedObject != 2 && objectConfigs["flamingo"].animation == "orbit") {
-            flamingoOrbitAngle += flamingoOrbitSpeed * deltaTime;
-            
-            // Determina o alvo da órbita
-            vec3 targetPosition;
-            if (objectConfigs["flamingo"].orbitTarget == "mars") {
-                targetPosition = marsPosition;
-            } else if (objectConfigs["flamingo"].orbitTarget == "moon") {
-                targetPosition = moonPosition;
-            } else {
-                targetPosition = vec3(0.0f, 0.0f, -5.0f);
+        mat4 view = camera.getViewMatrix();
+        {
+            PROFILE_SCOPE("luzes");
+            // Luzes do benchmark: habilitadas pela tecla B, giram em torno da cena
+            for (int i = 0; i < BENCHMARK_LIGHT_COUNT; ++i) {
+                PointLight& light = lightTable[1 + i];
+                light.enabled = lightBenchmark;
+                if (!lightBenchmark) continue;
+                float angle = benchmarkOrbits[i].z + currentFrameTime * benchmarkOrbits[i].w;
+                light.position = vec3(benchmarkOrbits[i].x * cos(angle), benchmarkOrbits[i].y,
+                                      -2.0f + benchmarkOrbits[i].x * sin(angle));
             }
-            
-            flamingoPosition.x = targetPosition.x + flamingoOrbitRadius * cos(flamingoOrbitAngle);
-            flamingoPosition.z = targetPosition.z + flamingoOrbitRadius * sin(flamingoOrbitAngle);
-            
-            // Ajusta a rotação para o flamingo apontar para a direção do movimento
-            flamingoRotationY = glm::degrees(flamingoOrbitAngle) + 90.0f;
+            if (lightBenchmark) {
+                benchmarkFrames++;
+                benchmarkTime += deltaTime;
+                if (benchmarkTime >= 1.0f) {
+                    cout << "Benchmark: " << clusteredLights.lastLightCount() << " luzes visiveis, ";
+                    if (clusteredLights.gpuBinning())
+                        cout << "classificacao na GPU, ";
+                    else
+                        cout << clusteredLights.lastIndexCount() << " indices, ";
+                    cout << 1000.0f * benchmarkTime / benchmarkFrames << " ms/quadro" << endl;
+                    benchmarkFrames = 0;
+                    benchmarkTime = 0.0f;
+                }
+            }
+
+            clusteredLights.update(lightTable, view, projection, scene.camera.nearPlane, scene.camera.farPlane);
+            FrameProfiler::count(PROFILE_UPLOAD_BYTES, clusteredLights.lastUploadedBytes());
+        }
+
+        {
+            PROFILE_SCOPE("fundo");
+            PROFILE_GPU_SCOPE("fundo");
+            glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            // Desenha o fundo
+            glDepthMask(GL_FALSE);
+            glUseProgram(bgShaderProgram);
+            glBindVertexArray(bgVAO);
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, backgroundTexID);
+            glUniform1i(glGetUniformLocation(bgShaderProgram, "background"), 0);
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+            glBindVertexArray(0);
+            glDepthMask(GL_TRUE);
+            FrameProfiler::count(PROFILE_DRAW_CALLS, 1);
+            FrameProfiler::count(PROFILE_TRIANGLES, 2);
+        }
+
+        // Matrizes de modelo e de normais, recalculadas só para as entidades alteradas
+        // (e os seus filhos: mover Marte leva o flamingo junto)
+        allocationsBefore = allocationCount();
+        {
+            PROFILE_SCOPE("transformacoes");
+            updateTransforms(world, &jobs);
+        }
+
+        // Entidades fora do campo de visão não são desenhadas
+        {
+            PROFILE_SCOPE("culling");
+            cullEntities(world, projection * view, &jobs);
+        }
+
+        // Gravação dos desenhos das entidades visíveis, em paralelo (sem chamadas OpenGL)
+        {
+            PROFILE_SCOPE("gravacao dos comandos");
+            depthQueue.reset();
+            opaqueQueue.reset();
+            alphaQueue.reset();
+            jobs.parallelFor(world.size(), 1024, [&](size_t begin, size_t end) {
+                PROFILE_SCOPE("gravacao (bloco)");
+                unsigned worker = JobSystem::workerIndex();
+                for (Entity entity = (Entity)begin; entity < end; ++entity) {
+                    if (world.vaos[entity] == 0 || !world.visible[entity])
+                        continue;
+                    float depth = -(view * world.models[entity][3]).z / scene.camera.farPlane;
+                    if (useDepthPrePass)
+                        recordObject(depthQueue.list(worker), depthShaderProgram, 0, entity, depth);
+                    recordObject(opaqueQueue.list(worker), shaderProgram, world.textures[entity], entity, depth);
+                    if (world.alphaTextures[entity] != 0)
+                        recordObject(alphaQueue.list(worker), alphaTestShaderProgram, world.alphaTextures[entity], entity, depth);
+                }
+            });
+            depthQueue.merge();
+            opaqueQueue.merge();
+            alphaQueue.merge();
+        }
+        cpuAllocationSum += allocationCount() - allocationsBefore;
+        cpuAllocationFrames++;
+
+        // Pré-passo de profundidade dos objetos opacos (sem escrita de cor)
+        if (useDepthPrePass) {
+            PROFILE_SCOPE("pre-passo");
+            PROFILE_GPU_SCOPE("pre-passo");
+            glUseProgram(depthShaderProgram);
+            glUniformMatrix4fv(glGetUniformLocation(depthShaderProgram, "projection"), 1, GL_FALSE, value_ptr(projection));
+            glUniformMatrix4fv(glGetUniformLocation(depthShaderProgram, "view"), 1, GL_FALSE, value_ptr(view));
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            executor.execute(depthQueue);
+            countExecution();
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+            // A profundidade já está pronta: só o fragmento visível de cada pixel passa
+            glDepthFunc(GL_EQUAL);
+            glDepthMask(GL_FALSE);
+        }
+
+        {
+            PROFILE_SCOPE("opacos");
+            PROFILE_GPU_SCOPE("opacos");
+            // Configuração do shader principal
+            glUseProgram(shaderProgram);
+            glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, value_ptr(projection));
+            glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, value_ptr(view));
+            glUniform3fv(glGetUniformLocation(shaderProgram, "viewPos"), 1, value_ptr(camera.position));
+            glUniform3fv(glGetUniformLocation(shaderProgram, "objectColor"), 1, value_ptr(objectColor));
+            clusteredLights.bind(shaderProgram, 1, WIDTH, HEIGHT);
+
+            glBeginQuery(fragmentQueryTarget, fragmentQueries[queryFrame % 2]);
+
+            // Desenho dos objetos opacos
+            glUniform1i(glGetUniformLocation(shaderProgram, "texture1"), 0);
+            glActiveTexture(GL_TEXTURE0);
+            executor.execute(opaqueQueue);
+            countExecution();
+
+            glEndQuery(fragmentQueryTarget);
         }
 
-        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        // Desenha o fundo
-        glDepthMask(GL_FALSE);
-        glUseProgram(bgShaderProgram);
-        glBindVertexArray(bgVAO);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, backgroundTexID);
-        glUniform1i(glGetUniformLocation(bgShaderProgram, "background"), 0);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        glBindVertexArray(0);
+        // As texturas com teste alfa (olho do flamingo) ficam fora do pré-passo
+        // e voltam ao teste de profundidade normal
+        glDepthFunc(GL_LESS);
         glDepthMask(GL_TRUE);
 
-        // Configuração do shader principal
-        glUseProgram(shaderProgram);
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, value_ptr(projection));
-        mat4 view = camera.getViewMatrix();
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, value_ptr(view));
-        glUniform3fv(glGetUniformLocation(shaderProgram, "lightPos"), 1, value_ptr(lightPos));
-        glUniform3fv(glGetUniformLocation(shaderProgram, "viewPos"), 1, value_ptr(camera.position));
-        glUniform3fv(glGetUniformLocation(shaderProgram, "lightColor"), 1, value_ptr(lightColor));
-        glUniform3fv(glGetUniformLocation(shaderProgram, "objectColor"), 1, value_ptr(objectColor));
-
-        // Desenho da lua
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, moonTextureID);
-        glUniform1i(glGetUniformLocation(shaderProgram, "texture1"), 0);
-        drawObject(shaderProgram, moonVAO, moonVertexCount, moonPosition, moonScale, 
-            vec3(moonRotationX, moonRotationY, moonRotationZ), objectConfigs["moon"].material);
-
-        // Desenho de Marte
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, marsTextureID);
-        glUniform1i(glGetUniformLocation(shaderProgram, "texture1"), 0);
-        drawObject(shaderProgram, marsVAO, marsVertexCount, marsPosition, marsScale, 
-            vec3(marsRotationX, marsRotationY, marsRotationZ), objectConfigs["mars"].material);
-
-        // Desenho do flamingo
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, flamingoBodyTextureID);
-        glUniform1i(glGetUniformLocation(shaderProgram, "texture1"), 0);
-        glUniform1i(glGetUniformLocation(shaderProgram, "useEyeTexture"), 0); // Parâmetro adicional para distinguir texturas
-        drawObject(shaderProgram, flamingoVAO, flamingoVertexCount, flamingoPosition, flamingoScale, 
-            vec3(flamingoRotationX, flamingoRotationY, flamingoRotationZ), objectConfigs["flamingo"].material);
-
-        // Desenho do olho do flamingo
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, flamingoEyeTextureID);
-        glUniform1i(glGetUniformLocation(shaderProgram, "texture1"), 0);
-        glUniform1i(glGetUniformLocation(shaderProgram, "useEyeTexture"), 1); // Parâmetro para usar a textura do olho
-        drawObject(shaderProgram, flamingoVAO, flamingoVertexCount, flamingoPosition, flamingoScale, 
-            vec3(flamingoRotationX, flamingoRotationY, flamingoRotationZ), objectConfigs["flamingo"].material);
-
-        glfwSwapBuffers(window);
-    }
+        {
+            PROFILE_SCOPE("alfa");
+            PROFILE_GPU_SCOPE("alfa");
+            // Desenho das texturas com teste alfa, com a variante de shader correspondente
+            glUseProgram(alphaTestShaderProgram);
+            glUniformMatrix4fv(glGetUniformLocation(alphaTestShaderProgram, "projection"), 1, GL_FALSE, value_ptr(projection));
+            glUniformMatrix4fv(glGetUniformLocation(alphaTestShaderProgram, "view"), 1, GL_FALSE, value_ptr(view));
+            glUniform3fv(glGetUniformLocation(alphaTestShaderProgram, "viewPos"), 1, value_ptr(camera.position));
+            glUniform3fv(glGetUniformLocation(alphaTestShaderProgram, "objectColor"), 1, value_ptr(objectColor));
+            clusteredLights.bind(alphaTestShaderProgram, 1, WIDTH, HEIGHT);
+            glUniform1i(glGetUniformLocation(alphaTestShaderProgram, "texture1"), 0);
+            glActiveTexture(GL_TEXTURE0);
+            executor.execute(alphaQueue);
+            countExecution();
+        }
 
-    glfwTerminate();
-    return 0;
-}
+        // Lê a consulta do quadro anterior só se ela já terminou (como no FrameProfiler): a
+        // CPU nunca espera pela GPU, o que distorceria a medida do pré-passo. Se a GPU está
+        // mais de um quadro atrás, o resultado é descartado (a consulta é reaproveitada)
+        if (queryFrame > 0) {
+            PROFILE_SCOPE("consulta de fragmentos");
+            GLuint previousQuery = fragmentQueries[(queryFrame - 1) % 2];
+            GLint available = 0;
+            glGetQueryObjectiv(previousQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available) {
+                GLuint64 fragmentCount = 0;
+                glGetQueryObjectui64v(previousQuery, GL_QUERY_RESULT, &fragmentCount);
+                int mode = queryModes[(queryFrame - 1) % 2];
+                fragmentCountSum[mode] += fragmentCount;
+                fragmentCountFrames[mode]++;
+            }
+        }
+        queryModes[queryFrame % 2] = useDepthPrePass ? 1 : 0;
+        queryFrame++;
+
+        statsTime += deltaTime;
+        if (statsTime >= 1.0f) {
+            for (int mode = 0; mode < 2; ++mode) {
+                if (fragmentCountFrames[mode] > 0)
+                    fragmentCountAverage[mode] = (double)fragmentCountSum[mode] / fragmentCountFrames[mode];
+                fragmentCountSum[mode] = 0;
+                fragmentCountFrames[mode] = 0;
+            }
+            int mode = useDepthPrePass ? 1 : 0;
+            cout << (hasPipelineStatistics ? "Invocacoes do fragment shader" : "Amostras sombreadas")
+                 << (useDepthPrePass ? " (com pre-passo): " : " (sem pre-passo): ")
+                 << (GLuint64)fragmentCountAverage[mode] << " por quadro";
+            if (fragmentCountAverage[0] > 0.0 && fragmentCountAverage[1] >= 0.0)
+                cout << ", economia do pre-passo: "
+                     << 100.0 * (1.0 - fragmentCountAverage[1] / fragmentCountAverage[0]) << "%";
+            cout << ", " << (double)cpuAllocationSum / cpuAllocationFrames << " alocacoes no heap por quadro (CPU)" << endl;
+            const ProfileFrame& profile = FrameProfiler::lastFrame();
+            cout << "Perfil: CPU " << profile.cpuMilliseconds << " ms, GPU " << profile.gpuMilliseconds << " ms, "
+                 << profile.counters[PROFILE_DRAW_CALLS] << " draw calls, " << profile.counters[PROFILE_STATE_CHANGES]
+                 << " trocas de estado, " << profile.counters[PROFILE_TRIANGLES] << " triangulos" << endl;
+            cpuAllocationSum = 0;
+            cpuAllocationFrames = 0;
+            statsTime = 0.0f;
+        }
 
-GLuint setupShader()
-{
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vertexShader);
-
-    GLint success;
-    GLchar infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
-        cout << "Vertex Shader Error:\n"
-             << infoLog << endl;
-    }
+        // Sobreposição com o último quadro completo do profiler
+        if (showProfiler) {
+            if (printProfilerLegend) {
+                profilerOverlay.printLegend();
+                printProfilerLegend = false;
+            }
+            profilerOverlay.draw(WIDTH, HEIGHT);
+        }
 
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
-    glCompileShader(fragmentShader);
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
-        cout << "Fragment Shader Error:\n"
-             << infoLog << endl;
+        if (options.headless && options.format == "none") {
+            PROFILE_SCOPE("glFinish");
+            glFinish();
+        }
+        else if (options.headless) {
+            PROFILE_SCOPE("gravacao do quadro");
+            string path = frameFileName(options, frame);
+            if (!headless.readFrame(frameImage) || !writeFrameImage(path, WIDTH, HEIGHT, frameImage)) {
+                cout << "Erro ao gravar o quadro " << path << endl;
+                break;
+            }
+        }
+        else {
+            PROFILE_SCOPE("swap");
+            glfwSwapBuffers(window);
+        }
+        FrameProfiler::endFrame();
+
+        if (!options.benchPath.empty() && frame >= BENCH_WARMUP_FRAMES) {
+            const ProfileFrame& profile = FrameProfiler::lastFrame();
+            benchFrameTimes.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - frameStart).count());
+            benchCpuTimes.push_back(profile.cpuMilliseconds);
+            if (profile.gpuMilliseconds > 0.0) // 0 quando os tempos da GPU ainda não chegaram
+                benchGpuTimes.push_back(profile.gpuMilliseconds);
+            benchDrawCalls.push_back((double)profile.counters[PROFILE_DRAW_CALLS]);
+        }
+        frame++;
     }
 
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success)
-    {
-        glGetProgramInfoLog(shaderProgram, 512, nullptr, infoLog);
-        cout << "Shader Linking Error:\n"
-             << infoLog << endl;
+    if (options.headless && frame > 0) {
+        double elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - renderStart).count();
+        if (options.format == "none")
+            cout << frame << " quadros desenhados: " << elapsed / frame << " ms/quadro" << endl;
+        else
+            cout << frame << " quadros gravados em " << options.outputPrefix << "*." << options.format << ": "
+                 << elapsed / frame << " ms/quadro (com leitura e gravacao)" << endl;
     }
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    // Percentis dos quadros, com nomes "quadro/<cena>/<caminho da câmera>/<medida>"
+    if (!options.benchPath.empty()) {
+        string sceneName = options.scenePath.substr(options.scenePath.find_last_of("/\\") + 1);
+        sceneName = sceneName.substr(0, sceneName.find('.'));
+        string prefix = "quadro/" + sceneName + "/" + options.cameraPath + "/";
+        BenchmarkReport report("TrabalhoGB");
+        cout << "Benchmark (" << benchFrameTimes.size() << " quadros depois de " << BENCH_WARMUP_FRAMES
+             << " de aquecimento):" << endl;
+        report.add(prefix + "total", "ms", benchFrameTimes);
+        report.add(prefix + "cpu", "ms", benchCpuTimes);
+        report.add(prefix + "gpu", "ms", benchGpuTimes);
+        report.add(prefix + "draw_calls", "count", benchDrawCalls);
+        report.add(prefix + "carga", "ms", { loadMilliseconds }); // loadScene + createSceneEntities
+        report.write(options.benchPath);
+    }
 
-    return shaderProgram;
+    // Os passos de recarga usam as variáveis deste escopo
+    fileWatcher.stop();
+    glDeleteQueries(2, fragmentQueries);
+    profilerOverlay.release();
+    FrameProfiler::release();
+    phongShaders->variants->release();
+    depthShaders->variants->release();
+    clusteredLights.release();
+    glfwTerminate();
+    return 0;
 }
 
 //  Função para configurar a geometria
@@ -758,6 +955,7 @@ GLuint setupGeometry(const vector<vec3>& positions, const vector<vec2>& texCoord
     glBindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+    FrameProfiler::count(PROFILE_UPLOAD_BYTES, vertices.size() * sizeof(Vertex));
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid *)0);
     glEnableVertexAttribArray(0);
@@ -787,7 +985,8 @@ GLuint setupGeometry(const vector<vec3>& positions, const vector<vec2>& texCoord
         vec3 normal;
     };
 
-    vector<Vertex> vertices;
+    ArenaVector<Vertex> vertices{ ArenaAllocator<Vertex>(loadScratch) };
+    vertices.reserve(positions.size());
     for (size_t i = 0; i < positions.size(); i++)
     {
         Vertex v;
@@ -800,6 +999,7 @@ GLuint setupGeometry(const vector<vec3>& positions, const vector<vec2>& texCoord
     glBindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+    FrameProfiler::count(PROFILE_UPLOAD_BYTES, vertices.size() * sizeof(Vertex));
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid *)0);
     glEnableVertexAttribArray(0);
@@ -815,55 +1015,554 @@ GLuint setupGeometry(const vector<vec3>& positions, const vector<vec2>& texCoord
     return VAO;
 }
 
-// Função para carregar a textura
-GLuint loadTexture(const string &filePath)
+// Imagem decodificada em RGBA, ainda fora da GPU
+struct TextureImage {
+    int width = 0;
+    int height = 0;
+    shared_ptr<unsigned char> pixels;
+};
+
+// Decodifica a imagem (sem OpenGL: também na thread do FileWatcher)
+bool decodeTexture(const string &filePath, TextureImage &image)
 {
-    int width, height, nrChannels;
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 4);
-    GLenum format = GL_RGBA;
+    PROFILE_SCOPE("decodeTexture");
+    int nrChannels;
+    stbi_set_flip_vertically_on_load_thread(true);
+    unsigned char *data = stbi_load(filePath.c_str(), &image.width, &image.height, &nrChannels, 4);
     if (!data)
     {
         cout << "Falha ao carregar imagem: " << filePath << endl;
-        return 0;
+        return false;
     }
+    image.pixels = shared_ptr<unsigned char>(data, stbi_image_free);
+    return true;
+}
 
-    GLuint texID;
-    glGenTextures(1, &texID);
+// Envia a imagem para a textura texID (uma textura nova ou uma recarregada)
+void uploadTexture(GLuint texID, const TextureImage &image)
+{
+    GLenum format = GL_RGBA;
     glBindTexture(GL_TEXTURE_2D, texID);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels.get());
+    FrameProfiler::count(PROFILE_UPLOAD_BYTES, (uint64_t)image.width * image.height * 4);
     glGenerateMipmap(GL_TEXTURE_2D);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+// Função para carregar a textura
+GLuint loadTexture(const string &filePath)
+{
+    PROFILE_SCOPE("loadTexture");
+    TextureImage image;
+    if (!decodeTexture(filePath, image))
+        return 0;
 
-    stbi_image_free(data);
+    GLuint texID;
+    glGenTextures(1, &texID);
+    uploadTexture(texID, image);
     return texID;
 }
 
-// Função para desenhar um objeto
-void drawObject(GLuint shaderProgram, GLuint VAO, size_t vertexCount, vec3 position, vec3 scaleVec, vec3 rotation, Material material)
+// Textura do arquivo, carregada uma vez só. Quando o arquivo muda, a imagem nova é
+// decodificada na thread do FileWatcher e enviada para a mesma textura: as entidades
+// que a usam não mudam
+GLuint textureFor(const string& file)
 {
-    mat4 model = translate(mat4(1.0f), position);
-    model = rotate(model, radians(rotation.x), vec3(1.0f, 0.0f, 0.0f));
-    model = rotate(model, radians(rotation.y), vec3(0.0f, 1.0f, 0.0f));
-    model = rotate(model, radians(rotation.z), vec3(0.0f, 0.0f, 1.0f));
-    model = glm::scale(model, scaleVec);
+    if (file.empty())
+        return 0;
+    auto it = textureAssets.find(file);
+    if (it != textureAssets.end())
+        return it->second;
+    // Falhas não ficam no cache: a próxima recarga da cena tenta de novo
+    GLuint texID = loadTexture(file);
+    if (texID != 0) {
+        textureAssets[file] = texID;
+        fileWatcher.watch(file, [file, texID]() -> FileWatcher::Apply {
+            TextureImage image;
+            if (!decodeTexture(file, image))
+                return nullptr;
+            return [file, texID, image]() {
+                uploadTexture(texID, image);
+                cout << "Textura recarregada: " << file << endl;
+            };
+        });
+    }
+    return texID;
+}
 
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, value_ptr(model));
-    
-    // Passa os coeficientes de material para o shader
-    glUniform3fv(glGetUniformLocation(shaderProgram, "Ka"), 1, value_ptr(material.ka));
-    glUniform3fv(glGetUniformLocation(shaderProgram, "Kd"), 1, value_ptr(material.kd));
-    glUniform3fv(glGetUniformLocation(shaderProgram, "Ks"), 1, value_ptr(material.ks));
-    glUniform1f(glGetUniformLocation(shaderProgram, "shininess"), material.shininess);
+// Malha lida do OBJ/MTL, ainda fora da GPU
+struct MeshData {
+    vector<vec3> positions;
+    vector<vec2> texCoords;
+    vector<vec3> normals;
+    Material material;
+};
 
+// Sem OpenGL: também na thread do FileWatcher, com a sua própria arena
+bool decodeMesh(const string& objFile, const string& mtlFile, MeshData& mesh, LinearArena& scratch)
+{
+    string meshTextureFile;
+    if (!loadOBJ(objFile, mtlFile, meshTextureFile, mesh.positions, mesh.texCoords, mesh.normals, mesh.material, scratch)) {
+        cout << "Erro ao carregar " << objFile << endl;
+        return false;
+    }
+    return true;
+}
+
+MeshAsset uploadMesh(const MeshData& mesh)
+{
+    MeshAsset asset;
+    asset.VAO = setupGeometry(mesh.positions, mesh.texCoords, mesh.normals);
+    loadScratch.reset();
+    asset.vertexCount = (GLsizei)mesh.positions.size();
+    asset.radius = 0.0f;
+    for (const vec3& position : mesh.positions)
+        asset.radius = std::max(asset.radius, length(position));
+    asset.material = mesh.material;
+    return asset;
+}
+
+// Apaga o VAO e o VBO de setupGeometry
+void deleteGeometry(GLuint VAO)
+{
+    GLint VBO = 0;
     glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+    glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &VBO);
     glBindVertexArray(0);
+    GLuint buffer = (GLuint)VBO;
+    glDeleteBuffers(1, &buffer);
+    glDeleteVertexArrays(1, &VAO);
+}
+
+// Malha de (objFile, mtlFile), carregada uma vez só (nullptr se o arquivo não pode ser
+// lido). Quando o OBJ ou o MTL muda, ele é lido de novo na thread do FileWatcher; entre
+// dois quadros a malha nova vai para a GPU, as entidades que usavam a antiga passam a
+// usar a nova e a antiga é apagada
+const MeshAsset* meshFor(const string& objFile, const string& mtlFile)
+{
+    string key = objFile + "|" + mtlFile;
+    auto it = meshAssets.find(key);
+    if (it != meshAssets.end())
+        return &it->second;
+
+    MeshData mesh;
+    if (!decodeMesh(objFile, mtlFile, mesh, loadScratch)) {
+        loadScratch.reset();
+        return nullptr;
+    }
+    const Material& material = mesh.material;
+    cout << objFile << ": Ka " << material.ka.r << " " << material.ka.g << " " << material.ka.b
+         << ", Kd " << material.kd.r << " " << material.kd.g << " " << material.kd.b
+         << ", Ks " << material.ks.r << " " << material.ks.g << " " << material.ks.b
+         << ", Shininess " << material.shininess << endl;
+    it = meshAssets.emplace(key, uploadMesh(mesh)).first;
+
+    FileWatcher::Importer importer = [objFile, mtlFile, key]() -> FileWatcher::Apply {
+        LinearArena scratch(4 << 20);
+        shared_ptr<MeshData> loaded = make_shared<MeshData>();
+        if (!decodeMesh(objFile, mtlFile, *loaded, scratch))
+            return nullptr;
+        return [key, loaded]() {
+            MeshAsset& asset = meshAssets.find(key)->second;
+            GLuint oldVAO = asset.VAO;
+            asset = uploadMesh(*loaded);
+            for (Entity entity = 0; entity < world.size(); ++entity) {
+                if (world.vaos[entity] != oldVAO)
+                    continue;
+                world.vaos[entity] = asset.VAO;
+                world.vertexCounts[entity] = asset.vertexCount;
+                world.boundingRadii[entity] = asset.radius;
+                world.materials[entity] = asset.material;
+            }
+            deleteGeometry(oldVAO);
+            cout << "Malha recarregada: " << key << endl;
+        };
+    };
+    fileWatcher.watch(objFile, importer);
+    if (!mtlFile.empty())
+        fileWatcher.watch(mtlFile, importer);
+    return &it->second;
+}
+
+// Lê <directory>/<name>.vert e .frag (sem OpenGL: também na thread do FileWatcher)
+bool readShaderFiles(const string& directory, const string& name, ShaderFiles& files)
+{
+    string* sources[2] = { &files.vertexSource, &files.fragmentSource };
+    const char* extensions[2] = { ".vert", ".frag" };
+    for (int stage = 0; stage < 2; ++stage) {
+        string path = directory + "/" + name + extensions[stage];
+        ifstream file(path, ios::binary);
+        if (!file.is_open()) {
+            cout << "Erro ao abrir o shader " << path << endl;
+            return false;
+        }
+        ostringstream text;
+        text << file.rdbuf();
+        *sources[stage] = text.str();
+    }
+    return true;
+}
+
+// Variantes do código lido em files; fragmentAppendix (pode ser nulo) é anexado ao
+// fragment shader
+void createShaderVariants(const string& name, ShaderFiles& files, const char* fragmentAppendix)
+{
+    vector<const char*> fragmentSources = { files.fragmentSource.c_str() };
+    if (fragmentAppendix)
+        fragmentSources.push_back(fragmentAppendix);
+    files.variants.reset(new ShaderVariants(name, shaderVersion, { files.vertexSource.c_str() }, fragmentSources));
+}
+
+// Observa os arquivos da cena (o principal e os includes). A cena é lida e compilada de
+// novo na thread do FileWatcher; entre dois quadros ela é comparada com a atual pelos
+// nomes dos objetos (SceneDiff.h) e só os objetos novos, removidos ou alterados mudam,
+// com as malhas e texturas já carregadas vindas dos caches. A câmera continua onde está.
+// Se a cena nova não pode ser montada, a anterior continua
+void watchScene(const string& path, const vector<string>& files)
+{
+    for (const string& file : files) {
+        if (fileWatcher.watching(file))
+            continue;
+        fileWatcher.watch(file, [path]() -> FileWatcher::Apply {
+            shared_ptr<CompiledScene> loaded = make_shared<CompiledScene>();
+            shared_ptr<vector<string>> loadedFiles = make_shared<vector<string>>();
+            if (!loadScene(path, *loaded, loadedFiles.get())) {
+                cout << "Erro ao recarregar a cena " << path << ": mantida a anterior" << endl;
+                return nullptr;
+            }
+            return [path, loaded, loadedFiles]() {
+                chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                loaded->camera = scene.camera;
+
+                // Só as operações da diferença, quando são poucas; senão (ou com muitas
+                // entidades removidas ocupando espaço) a cena é montada de novo
+                SceneDiff diff;
+                bool incremental = diffScenes(scene, *loaded, diff) &&
+                                   diff.ops.size() <= loaded->objectCount() / 2 &&
+                                   removedEntities + diff.count(SCENE_OP_REMOVE) <= world.size() / 2;
+                if (incremental && !applySceneDiff(*loaded, diff)) {
+                    cout << "Erro ao aplicar a cena recarregada: mantida a anterior" << endl;
+                    return;
+                }
+                scene.swap(*loaded);
+                if (!incremental && !createSceneEntities()) {
+                    cout << "Erro ao montar a cena recarregada: mantida a anterior" << endl;
+                    scene.swap(*loaded);
+                    createSceneEntities();
+                    return;
+                }
+                lightTable[0].position = scene.light.position;
+                lightTable[0].color = scene.light.color;
+                if (selectedObject >= world.size())
+                    selectedObject = 0;
+                watchScene(path, *loadedFiles);
+                double milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+                if (incremental)
+                    cout << "Cena recarregada: " << diff.count(SCENE_OP_ADD) << " objetos novos, "
+                         << diff.count(SCENE_OP_REMOVE) << " removidos, " << diff.count(SCENE_OP_UPDATE)
+                         << " alterados, " << diff.unchanged << " iguais (" << milliseconds << " ms)" << endl;
+                else
+                    cout << "Cena recarregada: " << world.size() << " objetos recriados (" << milliseconds << " ms)"
+                         << endl;
+            };
+        });
+    }
+}
+
+// Grava o desenho de uma entidade (matrizes já calculadas por updateTransforms).
+// Pode ser chamada por qualquer thread: só lê o mundo e escreve na lista
+void recordObject(CommandList& list, GLuint shaderProgram, GLuint texture, Entity entity, float depth)
+{
+    uint64_t key = drawSortKey(shaderProgram, texture, world.vaos[entity], depth);
+    DrawUniforms& uniforms = list.draw(key, entity, shaderProgram, world.vaos[entity], texture, 0, world.vertexCounts[entity]);
+    uniforms.model = world.models[entity];
+    uniforms.normalMatrix = world.normalMatrices[entity];
+
+    // Coeficientes de material
+    const Material& material = world.materials[entity];
+    uniforms.ka = material.ka;
+    uniforms.kd = material.kd;
+    uniforms.ks = material.ks;
+    uniforms.shininess = material.shininess;
+}
+
+// Malha e texturas do objeto id de source (carregadas na primeira vez); false, com a
+// mensagem, se o objeto é inválido ou algum arquivo não pode ser lido
+bool objectAssets(const CompiledScene& source, size_t id, const MeshAsset*& mesh, GLuint& texID, GLuint& alphaTexID)
+{
+    if (!source.validObject(id)) {
+        cout << "Objeto " << id << " invalido no arquivo de cena" << endl;
+        return false;
+    }
+    const SceneObjectRecord& cfg = source.object(id);
+    const char* name = source.str(cfg.name);
+
+    // Nomes citados só como pai ou alvo de órbita também recebem um id
+    if (cfg.objFile == SCENE_NONE) {
+        cout << "Objeto " << name << " sem arquivo OBJ (usado como pai sem ser definido?)" << endl;
+        return false;
+    }
+    mesh = meshFor(source.str(cfg.objFile), source.str(cfg.mtlFile));
+    if (!mesh)
+        return false;
+
+    // "texture.alpha" (olhos do flamingo) é opcional
+    texID = textureFor(source.str(cfg.textureFile));
+    alphaTexID = textureFor(source.str(cfg.alphaTextureFile));
+    if (texID == 0 || (cfg.alphaTextureFile != SCENE_NONE && alphaTexID == 0)) {
+        cout << "Erro ao carregar textura do objeto " << name << endl;
+        return false;
+    }
+    return true;
+}
+
+// Componentes da entidade a partir do objeto id de source, só os das mudanças pedidas
+// (SceneChange; o pai fica para linkEntity). As trilhas são acrescentadas: numa entidade
+// que já tinha trilhas, removeTracks antes
+bool setupEntity(Entity entity, const CompiledScene& source, size_t id, uint32_t changes)
+{
+    const SceneObjectRecord& cfg = source.object(id);
+    if (changes & (SCENE_CHANGE_MESH | SCENE_CHANGE_MATERIAL)) {
+        const MeshAsset* mesh;
+        GLuint texID, alphaTexID;
+        if (!objectAssets(source, id, mesh, texID, alphaTexID))
+            return false;
+        world.vaos[entity] = mesh->VAO;
+        world.vertexCounts[entity] = mesh->vertexCount;
+        world.boundingRadii[entity] = mesh->radius;
+        world.materials[entity] = mesh->material;
+        world.textures[entity] = texID;
+        world.alphaTextures[entity] = alphaTexID;
+    }
+    if (changes & SCENE_CHANGE_TRANSFORM) {
+        world.positions[entity] = make_vec3(cfg.position);
+        world.rotations[entity] = quatFromEulerDegrees(make_vec3(cfg.rotation));
+        world.scales[entity] = make_vec3(cfg.scale);
+        world.markDirty(entity);
+    }
+    if (changes & SCENE_CHANGE_ANIMATION) {
+        world.animations[entity] = (AnimationKind)cfg.animation;
+        if (cfg.animation == ANIMATION_ORBIT) {
+            world.orbitRadii[entity] = cfg.orbitRadius;
+            world.orbitSpeeds[entity] = cfg.orbitSpeed;
+        }
+        for (uint32_t t = cfg.firstTrack; t < cfg.firstTrack + cfg.trackCount; ++t) {
+            const SceneTrackRecord& track = source.track(t);
+            uint32_t curve = animationTracks.addCurve(source.keyTimes(track), source.keyValues(track), track.keyCount);
+            animationTracks.addTrack(entity, (TrackTarget)track.target, curve);
+        }
+    }
+    return true;
+}
+
+// Pai da entidade, com entities[i] a entidade do objeto i de source. A órbita é feita
+// no espaço do pai, em volta da sua origem; sem pai, em volta do centro padrão
+void linkEntity(Entity entity, const CompiledScene& source, size_t id, const vector<Entity>& entities)
+{
+    const SceneObjectRecord& cfg = source.object(id);
+    uint32_t parent = cfg.parent == SCENE_NONE && cfg.animation == ANIMATION_ORBIT ? cfg.orbitTarget : cfg.parent;
+    if (parent != SCENE_NONE) {
+        world.setParent(entity, entities[parent]);
+        world.orbitCenters[entity] = vec3(0.0f); // no espaço do pai: a origem dele
+    }
+    else {
+        if (world.parents[entity] != INVALID_ENTITY)
+            world.setParent(entity, INVALID_ENTITY);
+        if (world.animations[entity] == ANIMATION_ORBIT)
+            world.orbitCenters[entity] = vec3(0.0f, 0.0f, -5.0f);
+    }
+}
+
+// Cria as entidades da cena a partir dos objetos de scene. Malhas e texturas repetidas
+// entre objetos (ou já usadas antes de uma recarga da cena) são carregadas uma única vez
+bool createSceneEntities()
+{
+    PROFILE_SCOPE("createSceneEntities");
+    world.clear();
+    animationTracks.clear();
+    sceneEntities.clear();
+    removedEntities = 0;
+    world.reserve(scene.objectCount());
+    sceneEntities.reserve(scene.objectCount());
+    for (size_t id = 0; id < scene.objectCount(); ++id) {
+        // objectAssets confere o objeto antes de o nome ser lido
+        const MeshAsset* mesh;
+        GLuint texID, alphaTexID;
+        if (!objectAssets(scene, id, mesh, texID, alphaTexID))
+            return false;
+        Entity entity = world.create(scene.str(scene.object(id).name));
+        setupEntity(entity, scene, id, SCENE_CHANGE_ALL);
+        sceneEntities.push_back(entity);
+    }
+
+    // Pais (depois, pois podem aparecer depois no arquivo)
+    for (size_t id = 0; id < scene.objectCount(); ++id)
+        linkEntity(sceneEntities[id], scene, id, sceneEntities);
+
+    return true;
+}
+
+// Aplica à cena atual a diferença para after (diffScenes(scene, after)): só as entidades
+// citadas nas operações mudam. As malhas e texturas novas são carregadas antes de mexer
+// no mundo; se alguma falta, retorna false com a cena atual intacta
+bool applySceneDiff(const CompiledScene& after, const SceneDiff& diff)
+{
+    PROFILE_SCOPE("applySceneDiff");
+    for (const SceneOp& op : diff.ops) {
+        const MeshAsset* mesh;
+        GLuint texID, alphaTexID;
+        if (op.kind != SCENE_OP_REMOVE && (op.changes & (SCENE_CHANGE_MESH | SCENE_CHANGE_MATERIAL)) &&
+            !objectAssets(after, op.after, mesh, texID, alphaTexID))
+            return false;
+    }
+
+    // Entidade de cada objeto de after: a mesma do objeto de mesmo nome, ou uma nova
+    vector<Entity> entities(after.objectCount(), INVALID_ENTITY);
+    for (size_t id = 0; id < after.objectCount(); ++id)
+        if (diff.matches[id] != SCENE_NONE)
+            entities[id] = sceneEntities[diff.matches[id]];
+
+    size_t tracksRemoved = 0;
+    for (const SceneOp& op : diff.ops) {
+        if (op.kind == SCENE_OP_ADD) {
+            entities[op.after] = world.create(after.str(after.object(op.after).name));
+            setupEntity(entities[op.after], after, op.after, SCENE_CHANGE_ALL);
+        }
+        else if (op.kind == SCENE_OP_UPDATE) {
+            uint32_t changes = op.changes;
+            if (changes & SCENE_CHANGE_ANIMATION) {
+                // Sem a órbita ou as trilhas, o objeto volta à transformação do arquivo
+                tracksRemoved += animationTracks.removeTracks(entities[op.after]);
+                changes |= SCENE_CHANGE_TRANSFORM;
+            }
+            setupEntity(entities[op.after], after, op.after, changes);
+        }
+    }
+    for (const SceneOp& op : diff.ops)
+        if (op.kind != SCENE_OP_REMOVE && (op.changes & (SCENE_CHANGE_PARENT | SCENE_CHANGE_ANIMATION)))
+            linkEntity(entities[op.after], after, op.after, entities);
+    for (const SceneOp& op : diff.ops) {
+        if (op.kind != SCENE_OP_REMOVE)
+            continue;
+        tracksRemoved += animationTracks.removeTracks(sceneEntities[op.before]);
+        world.destroy(sceneEntities[op.before]);
+        removedEntities++;
+    }
+    // As curvas das trilhas removidas (cada objeto tem as suas) não crescem a cada recarga
+    if (tracksRemoved > 0)
+        animationTracks.compactCurves();
+    sceneEntities.swap(entities);
+    return true;
+}
+
+// Lê as opções da linha de comando; false (com o modo de uso) se alguma é inválida
+bool parseOptions(int argc, char** argv, RunOptions& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        string option = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (option == "--headless")
+            options.headless = true;
+        else if (option == "--scene" && hasValue)
+            options.scenePath = argv[++i];
+        else if (option == "--shaders" && hasValue)
+            options.shaderDirectory = argv[++i];
+        else if (option == "--watch")
+            options.watchFiles = 1;
+        else if (option == "--no-watch")
+            options.watchFiles = 0;
+        else if (option == "--frames" && hasValue)
+            options.frameCount = atoi(argv[++i]);
+        else if (option == "--output" && hasValue)
+            options.outputPrefix = argv[++i];
+        else if (option == "--format" && hasValue)
+            options.format = argv[++i];
+        else if (option == "--trace" && hasValue)
+            options.tracePath = argv[++i];
+        else if (option == "--bench" && hasValue)
+            options.benchPath = argv[++i];
+        else if (option == "--camera-path" && hasValue)
+            options.cameraPath = argv[++i];
+        else if (option == "--profiler")
+            options.showProfiler = true;
+        else if (option == "--camera" && hasValue) {
+            // x,y,z,yaw,pitch
+            char separator;
+            istringstream camera(argv[++i]);
+            vec3& p = options.cameraPosition;
+            camera >> p.x >> separator >> p.y >> separator >> p.z >> separator >> options.cameraYaw >> separator >>
+                options.cameraPitch;
+            if (camera.fail()) {
+                cout << "--camera espera x,y,z,yaw,pitch" << endl;
+                return false;
+            }
+            options.overrideCamera = true;
+        }
+        else {
+            cout << "Uso: TrabalhoGB [--scene arquivo] [--shaders pasta] [--watch | --no-watch] [--camera x,y,z,yaw,pitch]\n"
+                 << "                 [--trace perfil.json] [--profiler]\n"
+                 << "                 [--headless [--frames N] [--output prefixo] [--format png|ppm|raw|none]\n"
+                 << "                             [--camera-path fixa|orbita|aproximacao] [--bench resultados.json]]" << endl;
+            return false;
+        }
+    }
+    if (options.format != "png" && options.format != "ppm" && options.format != "raw" && options.format != "none") {
+        cout << "Formato de quadro desconhecido: " << options.format << endl;
+        return false;
+    }
+    if (options.cameraPath != "fixa" && options.cameraPath != "orbita" && options.cameraPath != "aproximacao") {
+        cout << "Caminho de camera desconhecido: " << options.cameraPath << endl;
+        return false;
+    }
+    if (!options.benchPath.empty() && !options.headless) {
+        cout << "--bench so funciona com --headless" << endl;
+        return false;
+    }
+    if (options.frameCount < 1)
+        options.frameCount = 1;
+    // Sem janela, os quadros devem ser reprodutíveis: recarga só com --watch
+    if (options.watchFiles < 0)
+        options.watchFiles = options.headless ? 0 : 1;
+    return true;
+}
+
+// <prefixo><quadro com 4 dígitos>.<formato>
+string frameFileName(const RunOptions& options, int frame)
+{
+    char number[16];
+    snprintf(number, sizeof(number), "%04d", frame);
+    return options.outputPrefix + number + "." + options.format;
+}
+
+// Caminhos fixos da câmera para os benchmarks sem janela, com t em [0, 1) e a partir da
+// câmera inicial (arquivo de configuração ou --camera):
+//  - fixa: parada;
+//  - orbita: uma volta em torno do ponto 8 unidades à frente, sempre olhando para ele;
+//  - aproximacao: avança 6 unidades em direção a esse ponto
+void cameraPathPose(const string& path, float t, const CameraConfig& start, Camera& out)
+{
+    const float targetDistance = 8.0f;
+    vec3 front(cos(radians(start.yaw)) * cos(radians(start.pitch)), sin(radians(start.pitch)),
+               sin(radians(start.yaw)) * cos(radians(start.pitch)));
+    vec3 target = start.position + front * targetDistance;
+    out.position = start.position;
+    out.yaw = start.yaw;
+    out.pitch = start.pitch;
+    if (path == "orbita") {
+        vec3 offset = start.position - target;
+        float radius = length(vec2(offset.x, offset.z));
+        float angle = atan2(offset.z, offset.x) + 6.2831853f * t;
+        out.position = target + vec3(radius * cos(angle), offset.y, radius * sin(angle));
+        out.yaw = degrees(atan2(target.z - out.position.z, target.x - out.position.x));
+    }
+    else if (path == "aproximacao") {
+        out.position = start.position + front * (6.0f * t);
+    }
 }
 
 // Callback de teclado
@@ -877,18 +1576,10 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
         if (key == GLFW_KEY_ESCAPE)
             glfwSetWindowShouldClose(window, true);
 
-        // Seleção de objetos
-        if (key == GLFW_KEY_1) {
-            selectedObject = 0; // Moon
-            cout << "Lua selecionada" << endl;
-        }
-        if (key == GLFW_KEY_2) {
-            selectedObject = 1; // Mars
-            cout << "Marte selecionado" << endl;
-        }
-        if (key == GLFW_KEY_3) {
-            selectedObject = 2; // Flamingo
-            cout << "Flamingo selecionado" << endl;
+        // Seleção de objetos (1 a 9, na ordem do arquivo de configuração)
+        if (key >= GLFW_KEY_1 && key <= GLFW_KEY_9 && (Entity)(key - GLFW_KEY_1) < world.size()) {
+            selectedObject = key - GLFW_KEY_1;
+            cout << "Objeto selecionado: " << world.names[selectedObject] << endl;
         }
 
         // Rotação (X, Y, Z)
@@ -964,6 +1655,27 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
             camera.rotate(-rotateSpeed, 0.0f); 
         if (key == GLFW_KEY_L)
             camera.rotate(rotateSpeed, 0.0f);  
+
+        // Pré-passo de profundidade
+        if (key == GLFW_KEY_P && action == GLFW_PRESS) {
+            useDepthPrePass = !useDepthPrePass;
+            cout << "Pre-passo de profundidade " << (useDepthPrePass ? "ligado" : "desligado") << endl;
+        }
+        // Cena de benchmark de luzes
+        if (key == GLFW_KEY_B && action == GLFW_PRESS) {
+            lightBenchmark = !lightBenchmark;
+            cout << "Benchmark de luzes " << (lightBenchmark ? "ativado" : "desativado") << endl;
+        }
+
+        // Profiler: sobreposição (com a legenda no terminal) e captura de um trace
+        if (key == GLFW_KEY_O && action == GLFW_PRESS) {
+            showProfiler = !showProfiler;
+            printProfilerLegend = showProfiler;
+        }
+        if (key == GLFW_KEY_T && action == GLFW_PRESS) {
+            if (FrameProfiler::capture(TRACE_FRAMES, "perfil_TrabalhoGB.json"))
+                cout << "Capturando " << TRACE_FRAMES << " quadros do profiler..." << endl;
+        }
     }
     else if (action == GLFW_RELEASE) {
         // Libera teclas de movimento
@@ -979,247 +1691,3 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
         if (key == GLFW_KEY_EQUAL || key == GLFW_KEY_KP_ADD) isScalingUp = false;
     }
 }
-
-// Função para carregar o arquivo de configuração
-bool loadSceneConfig(const string &configFile) {
-    ifstream file(configFile);
-    if (!file.is_open()) {
-        cout << "Erro ao abrir arquivo de configuração: " << configFile << endl;
-        return false;
-    }
-    
-    string line;
-    string currentObject = "";
-    
-    while (getline(file, line)) {
-        // Ignora linhas vazias e comentários
-        if (line.empty() || line[0] == '#') continue;
-        
-        // Remove espaços em branco no início e fim
-        line.erase(0, line.find_first_not_of(" \t"));
-        line.erase(line.find_last_not_of(" \t") + 1);
-        
-        // Divide a linha em chave e valor
-        size_t separatorPos = line.find('=');
-        if (separatorPos == string::npos) continue;
-        
-        string key = line.substr(0, separatorPos);
-        string value = line.substr(separatorPos + 1);
-        
-        // Remove espaços em branco
-        key.erase(0, key.find_first_not_of(" \t"));
-        key.erase(key.find_last_not_of(" \t") + 1);
-        value.erase(0, value.find_first_not_of(" \t"));
-        value.erase(value.find_last_not_of(" \t") + 1);
-        
-        // Processa valores baseado na chave
-        if (key.substr(0, 7) == "object.") {
-            // Extrai o nome do objeto e a propriedade
-            string objKey = key.substr(7);
-            size_t dotPos = objKey.find('.');
-            
-            if (dotPos != string::npos) {
-                string objName = objKey.substr(0, dotPos);
-                string objProp = objKey.substr(dotPos + 1);
-                
-                // Verifica se o objeto já existe no mapa
-                if (objectConfigs.find(objName) == objectConfigs.end()) {
-                    objectConfigs[objName] = ObjectConfig();
-                }
-                
-                // Configura propriedades do objeto
-                if (objProp == "file") {
-                    objectConfigs[objName].objFile = value;
-                }
-                else if (objProp == "mtl") {
-                    objectConfigs[objName].mtlFile = value;
-                }
-                else if (objProp == "texture") {
-                    objectConfigs[objName].textureFile = value;
-                }
-                else if (objProp == "position") {
-                    istringstream iss(value);
-                    iss >> objectConfigs[objName].position.x >> objectConfigs[objName].position.y >> objectConfigs[objName].position.z;
-                }
-                else if (objProp == "rotation") {
-                    istringstream iss(value);
-                    iss >> objectConfigs[objName].rotation.x >> objectConfigs[objName].rotation.y >> objectConfigs[objName].rotation.z;
-                }
-                else if (objProp == "scale") {
-                    istringstream iss(value);
-                    iss >> objectConfigs[objName].scale.x >> objectConfigs[objName].scale.y >> objectConfigs[objName].scale.z;
-                }
-                else if (objProp == "animation") {
-                    objectConfigs[objName].animation = value;
-                }
-                else if (objProp == "orbit.target") {
-                    objectConfigs[objName].orbitTarget = value;
-                }
-                else if (objProp == "orbit.radius") {
-                    objectConfigs[objName].orbitRadius = stof(value);
-                }
-                else if (objProp == "orbit.speed") {
-                    objectConfigs[objName].orbitSpeed = stof(value);
-                }
-                else if (objProp == "texture.body") {
-                    objectConfigs[objName].textureBodyFile = value;
-                }
-                else if (objProp == "texture.eye") {
-                    objectConfigs[objName].textureEyeFile = value;
-                }
-            }
-        }
-        else if (key.substr(0, 7) == "camera.") {
-            string camProp = key.substr(7);
-            
-            if (camProp == "position") {
-                istringstream iss(value);
-                iss >> cameraConfig.position.x >> cameraConfig.position.y >> cameraConfig.position.z;
-            }
-            else if (camProp == "yaw") {
-                cameraConfig.yaw = stof(value);
-            }
-            else if (camProp == "pitch") {
-                cameraConfig.pitch = stof(value);
-            }
-            else if (camProp == "fov") {
-                cameraConfig.fov = stof(value);
-            }
-            else if (camProp == "near") {
-                cameraConfig.nearPlane = stof(value);
-            }
-            else if (camProp == "far") {
-                cameraConfig.farPlane = stof(value);
-            }
-        }
-        else if (key.substr(0, 6) == "light.") {
-            string lightProp = key.substr(6);
-            
-            if (lightProp == "position") {
-                istringstream iss(value);
-                iss >> lightConfig.position.x >> lightConfig.position.y >> lightConfig.position.z;
-            }
-            else if (lightProp == "color") {
-                istringstream iss(value);
-                iss >> lightConfig.color.x >> lightConfig.color.y >> lightConfig.color.z;
-            }
-        }
-    }
-    
-    file.close();
-    return true;
-}
-
-//  Função para carregar um arquivo OBJ e MTL
-bool loadOBJ(const string &objPath, const string &mtlPath, string &textureFileOut,
-             vector<vec3>& outPositions, vector<vec2>& outTexCoords, vector<vec3>& outNormals,
-             Material& outMaterial)
-{
-    ifstream objFile(objPath);
-    if (!objFile.is_open())
-    {
-        cout << "Não foi possível abrir OBJ: " << objPath << endl;
-        return false;
-    }
-
-    vector<vec3> tempPositions;
-    vector<vec2> tempTexCoords;
-
-    string line;
-    while (getline(objFile, line))
-    {
-        istringstream iss(line);
-        string prefix;
-        iss >> prefix;
-
-        if (prefix == "v")
-        {
-            vec3 pos;
-            iss >> pos.x >> pos.y >> pos.z;
-            tempPositions.push_back(pos);
-        }
-        else if (prefix == "vt")
-        {
-            vec2 tex;
-            iss >> tex.x >> tex.y;
-            // tex.y = 1.0f - tex.y;
-            tempTexCoords.push_back(tex);
-        }
-        else if (prefix == "f")
-        {
-            for (int i = 0; i < 3; i++)
-            {
-                string v;
-                iss >> v;
-
-                size_t pos1 = v.find('/');
-                size_t pos2 = v.find('/', pos1 + 1);
-
-                int vi = stoi(v.substr(0, pos1)) - 1;
-                int ti = stoi(v.substr(pos1 + 1, pos2 - pos1 - 1)) - 1;
-
-                outPositions.push_back(tempPositions[vi]);
-                outTexCoords.push_back(tempTexCoords[ti]);
-            }
-        }
-    }
-
-    // Inicializa os valores padrão do material
-    outMaterial.ka = vec3(0.2f, 0.2f, 0.2f);
-    outMaterial.kd = vec3(0.8f, 0.8f, 0.8f);
-    outMaterial.ks = vec3(1.0f, 1.0f, 1.0f);
-    outMaterial.shininess = 32.0f;
-
-    ifstream mtlFile(mtlPath);
-    if (!mtlFile.is_open())
-    {
-        cout << "Não foi possível abrir MTL: " << mtlPath << endl;
-        return false;
-    }
-
-    while (getline(mtlFile, line))
-    {
-        istringstream iss(line);
-        string prefix;
-        iss >> prefix;
-
-        if (prefix == "map_Kd")
-        {
-            string texFile;
-            iss >> texFile;
-
-            string mtlDir = mtlPath.substr(0, mtlPath.find_last_of("/\\"));
-            textureFileOut = mtlDir + "/" + texFile;
-        }
-        else if (prefix == "Ka")
-        {
-            iss >> outMaterial.ka.r >> outMaterial.ka.g >> outMaterial.ka.b;
-            cout << "Ka: " << outMaterial.ka.r << " " << outMaterial.ka.g << " " << outMaterial.ka.b << endl;
-        }
-        else if (prefix == "Kd")
-        {
-            iss >> outMaterial.kd.r >> outMaterial.kd.g >> outMaterial.kd.b;
-            cout << "Kd: " << outMaterial.kd.r << " " << outMaterial.kd.g << " " << outMaterial.kd.b << endl;
-        }
-        else if (prefix == "Ks")
-        {
-            iss >> outMaterial.ks.r >> outMaterial.ks.g >> outMaterial.ks.b;
-            cout << "Ks: " << outMaterial.ks.r << " " << outMaterial.ks.g << " " << outMaterial.ks.b << endl;
-        }
-        else if (prefix == "Ns") // Coeficiente de brilho especular
-        {
-            iss >> outMaterial.shininess;
-            cout << "Shininess: " << outMaterial.shininess << endl;
-        }
-    }
-
-    // Calcula normais
-    outNormals.clear();
-    for (size_t i = 0; i < outPositions.size(); i++) {
-        // Normais apontando para fora do centro aproximado do objeto
-        vec3 normal = normalize(outPositions[i]);
-        outNormals.push_back(normal);
-    }
-    
-    return true;
-}
\ No newline at end of file
@@ -6,6 +6,8 @@
  * Última atualização: 07/03/2025
  */
 
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -22,6 +24,13 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "FrameScheduler.h"
+#include "JobSystem.h"
+#include "NormalMatrix.h"
+#include "SplinePath.h"
+#include "TrajectoryFile.h"
+#include "TrajectoryRecorder.h"
+
 using namespace std;
 using namespace glm;
 
@@ -41,23 +50,12 @@ const float SCREEN_BOUND_Y = 6.0f;  // Limites verticais da tela
 const float SCREEN_BOUND_Z_NEAR = -10.0f;  // Limite de profundidade (mais próximo)
 const float SCREEN_BOUND_Z_FAR = -1.0f;    // Limite de profundidade (mais distante)
 
-// Função para manter uma posição dentro dos limites da tela
+const vec3 SCREEN_BOUNDS_MIN = vec3(-SCREEN_BOUND_X, -SCREEN_BOUND_Y, SCREEN_BOUND_Z_NEAR);
+const vec3 SCREEN_BOUNDS_MAX = vec3(SCREEN_BOUND_X, SCREEN_BOUND_Y, SCREEN_BOUND_Z_FAR);
+
+// Função para manter uma posição dentro dos limites da tela (min/max, sem desvios)
 vec3 keepInBounds(const vec3& position) {
-    vec3 result = position;
-    
-    // Limita as coordenadas X
-    if (result.x < -SCREEN_BOUND_X) result.x = -SCREEN_BOUND_X;
-    if (result.x > SCREEN_BOUND_X) result.x = SCREEN_BOUND_X;
-    
-    // Limita as coordenadas Y
-    if (result.y < -SCREEN_BOUND_Y) result.y = -SCREEN_BOUND_Y;
-    if (result.y > SCREEN_BOUND_Y) result.y = SCREEN_BOUND_Y;
-    
-    // Limita as coordenadas Z
-    if (result.z < SCREEN_BOUND_Z_NEAR) result.z = SCREEN_BOUND_Z_NEAR;
-    if (result.z > SCREEN_BOUND_Z_FAR) result.z = SCREEN_BOUND_Z_FAR;
-    
-    return result;
+    return glm::min(glm::max(position, SCREEN_BOUNDS_MIN), SCREEN_BOUNDS_MAX);
 }
 
 // Flamingo 1
@@ -69,8 +67,6 @@ vector<vec3> trajectoryPoints1 = {
     vec3(-3.0f, 3.0f, -5.0f),
     vec3(-3.0f, 0.0f, -5.0f),
     vec3(0.0f, 0.0f, -5.0f)};
-size_t currentTargetIndex1 = 0;
-vec3 flamingoPosition1 = vec3(0.0f, 0.0f, -5.0f);
 
 // Flamingo 2
 vector<vec3> trajectoryPoints2 = {
@@ -81,8 +77,6 @@ vector<vec3> trajectoryPoints2 = {
     vec3(-3.0f, 0.0f, -5.0f),
     vec3(0.0f, 0.0f, -5.0f),
     vec3(3.0f, 0.0f, -5.0f)};
-size_t currentTargetIndex2 = 0;
-vec3 flamingoPosition2 = vec3(3.0f, 0.0f, -5.0f);
 
 // Flamingo 3
 vector<vec3> trajectoryPoints3 = {
@@ -92,12 +86,63 @@ vector<vec3> trajectoryPoints3 = {
     vec3(3.0f, -3.0f, -5.0f),
     vec3(3.0f, 0.0f, -5.0f),
     vec3(-3.0f, 0.0f, -5.0f)};
-size_t currentTargetIndex3 = 0;
-vec3 flamingoPosition3 = vec3(-3.0f, 0.0f, -5.0f);
+
+vector<vec3>* trajectories[3] = { &trajectoryPoints1, &trajectoryPoints2, &trajectoryPoints3 };
+
+// Tecla F grava a trajetória em .trj (binário) nesta thread, sem travar o quadro
+AsyncTrajectoryWriter trajectoryWriter;
+
+// Tecla R grava o caminho percorrido pelo flamingo selecionado (M6/gravacaoFlamingoN.trj),
+// amostrado a RECORD_RATE Hz e simplificado com tolerância RECORD_TOLERANCE
+TrajectoryRecorder trajectoryRecorder;
+const double RECORD_RATE = 1000.0;
+const float RECORD_TOLERANCE = 0.01f;
+
+// Caminho suave (fechado) pelos pontos de cada trajetória, percorrido com velocidade
+// constante. A tecla C alterna entre Catmull-Rom (passa por todos os pontos) e Bézier
+// cúbica (pontos como polígono de controle, 3n + 1 pontos)
+SplineKind pathKind = SPLINE_CATMULL_ROM;
+vector<SplinePath> flamingoPaths(3);
+
+// Bando de flamingos ("Trajetoria [quantidade]", 3 por padrão): o flamingo i segue o
+// caminho i % 3, espalhados ao longo dele. Distâncias, cursores, posições e tangentes
+// ficam em vetores separados (PathAgents), atualizados em blocos pelo JobSystem
+size_t flamingoCount = 3;
+PathAgents flamingos;
+JobSystem* simulationJobs = nullptr;
 
 // Velocidade global
 float moveSpeed = 1.5f;
 
+// Simulação em passo fixo: as trajetórias avançam sempre em ticks de SIMULATION_STEP
+// segundos, independente da taxa de quadros, e o desenho interpola entre dois ticks
+const double SIMULATION_STEP = 1.0 / 60.0;
+
+// Estado publicado pela simulação para o desenho: posições e tangentes do último tick.
+// A simulação escreve nos vetores dos agentes e os troca com os do buffer (sem cópia)
+struct TrajectorySnapshot {
+    vector<vec3> positions;
+    vector<vec3> tangents;
+    uint64_t tick = 0; // número do tick, para saber se o anterior foi o último enviado
+    double time = 0.0; // instante do tick (schedulerSeconds)
+};
+
+// Tecla T: simulação em uma thread separada, trocando o estado pelo buffer triplo
+SimulationThread simulationThread;
+TripleBuffer<TrajectorySnapshot> snapshots;
+
+// Instâncias na GPU em dois buffers alternados (ping-pong), cada um com [posições |
+// tangentes] de um tick. O tick novo sobrescreve o mais antigo e os atributos do tick
+// anterior passam a ler o outro buffer: só o tick novo é enviado
+struct InstanceBuffers {
+    GLuint buffers[2] = { 0, 0 };
+    int current = 0;   // buffer com o último tick enviado
+    uint64_t tick = 0; // último tick enviado (thread da simulação)
+};
+
+// Os caminhos mudaram fora de um tick (teclas C e L): reenvia as instâncias
+bool instancesDirty = true;
+
 // Classe Camera
 class Camera
 {
@@ -172,7 +217,6 @@ private:
 
 //  Variáveis da câmera
 Camera camera;
-vec3 flamingoPosition = vec3(0.0f, 0.0f, -5.0f);
 vec3 flamingoScale = vec3(0.2f, 0.2f, 0.2f);
 float flamingoRotationX = 0.0f;
 float flamingoRotationY = 0.0f;
@@ -185,19 +229,42 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
 layout (location = 2) in vec3 aNormal;
 
+// Por instância (um flamingo): posição e tangente nos dois últimos ticks
+layout (location = 3) in vec3 aPreviousPosition;
+layout (location = 4) in vec3 aCurrentPosition;
+layout (location = 5) in vec3 aPreviousTangent;
+layout (location = 6) in vec3 aCurrentTangent;
+
 out vec2 TexCoord;
 out vec3 FragPos;
 out vec3 Normal;
 
 uniform mat4 projection;
 uniform mat4 view;
-uniform mat4 model;
+uniform mat4 model; // rotação e escala do modelo (teclas), antes da orientação no caminho
+uniform mat3 normalMatrix; // inversa transposta de mat3(model), calculada na CPU
+uniform float alpha; // fração do tick atual, para interpolar entre os dois ticks
+
+// Base que leva o +Z do modelo para a tangente, mantendo o modelo em pé
+// (o mesmo que orientationAlong() de SplinePath.h)
+mat3 orientationAlong(vec3 tangent)
+{
+    if (dot(tangent, tangent) < 1e-8)
+        return mat3(1.0);
+    vec3 forward = normalize(tangent);
+    vec3 side = vec3(forward.z, 0.0, -forward.x);
+    side = dot(side, side) > 1e-8 ? normalize(side) : vec3(1.0, 0.0, 0.0);
+    return mat3(side, cross(forward, side), forward);
+}
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    vec3 position = mix(aPreviousPosition, aCurrentPosition, alpha);
+    mat3 orientation = orientationAlong(mix(aPreviousTangent, aCurrentTangent, alpha));
+    vec3 worldPos = position + orientation * vec3(model * vec4(aPos, 1.0));
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+    FragPos = worldPos;
+    Normal = orientation * normalMatrix * aNormal;
     TexCoord = aTexCoord;
 }
 )";
@@ -249,11 +316,23 @@ bool loadOBJ(const string &objPath, const string &mtlPath, string &textureFileOu
 
 GLuint loadTexture(const string &filePath);
 
-void drawFlamingo(GLuint shaderProgram, GLuint VAO, vec3 position, vec3 scale, vec3 rotation);
+void setupInstanceBuffers(GLuint VAO, InstanceBuffers& instances);
+void uploadInstances(GLuint VAO, InstanceBuffers& instances, const vector<vec3>& positions,
+                     const vector<vec3>& tangents, bool keepPrevious);
+void drawFlamingos(GLuint shaderProgram, GLuint VAO, float alpha, vec3 scale, vec3 rotation);
+void setupFlamingos();
+void rebuildPath(int path);
+
+void simulateTrajectories(float step);
+void startSimulationThread();
+void stopSimulationThread();
 
 // Função MAIN
-int main()
+int main(int argc, char** argv)
 {
+    if (argc > 1)
+        flamingoCount = std::max<size_t>(1, (size_t)atol(argv[1]));
+
     std::string objPath = "../assets/Modelos3D/Flamingo.obj"; 
     std::string mtlPath = "../assets/Modelos3D/Flamingo.mtl";  
     std::string texturePath = "../assets/tex/pink.jpg";  
@@ -294,6 +373,8 @@ int main()
     }
 
     GLuint VAO = setupGeometry();
+    InstanceBuffers instances;
+    setupInstanceBuffers(VAO, instances);
 
     mat4 projection = perspective(radians(45.0f), (float)WIDTH / (float)HEIGHT, 0.1f, 100.0f);
 
@@ -302,6 +383,13 @@ int main()
     vec3 objectColor = vec3(1.0f);
     float lastFrameTime = glfwGetTime();
 
+    JobSystem jobs;
+    simulationJobs = &jobs;
+    setupFlamingos();
+    cout << flamingoCount << " flamingo(s), " << jobs.threadCount() << " thread(s)" << endl;
+
+    FixedTimestep timestep(SIMULATION_STEP);
+
     while (!glfwWindowShouldClose(window))
     {
         float currentFrameTime = glfwGetTime();
@@ -310,6 +398,22 @@ int main()
 
         glfwPollEvents();
 
+        AsyncTrajectoryWriter::Result saved;
+        while (trajectoryWriter.popResult(saved)) {
+            if (saved.ok)
+                cout << "Trajetoria armazenada em " << saved.path << " (" << saved.pointCount << " pontos)" << endl;
+            else
+                cout << "Erro ao salvar arquivo: " << saved.path << endl;
+        }
+        TrajectoryRecorder::Result recorded;
+        while (trajectoryRecorder.popResult(recorded)) {
+            if (recorded.ok)
+                cout << "Gravacao armazenada em " << recorded.path << ": " << recorded.samples << " amostras, "
+                     << recorded.kept << " pontos depois da simplificacao" << endl;
+            else
+                cout << "Erro ao gravar arquivo: " << recorded.path << endl;
+        }
+
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -328,61 +432,137 @@ int main()
         glBindTexture(GL_TEXTURE_2D, textureID);
         glUniform1i(glGetUniformLocation(shaderProgram, "texture1"), 0);
 
-        // Atualiza posição do Flamingo 1
-        vec3 targetPos1 = trajectoryPoints1[currentTargetIndex1];
-        vec3 direction1 = normalize(targetPos1 - flamingoPosition1);
-        float distance1 = length(targetPos1 - flamingoPosition1);
-
-        if (distance1 < 0.05f)
-        {
-            currentTargetIndex1 = (currentTargetIndex1 + 1) % trajectoryPoints1.size();
-        }
-        else
-        {
-            flamingoPosition1 += direction1 * moveSpeed * deltaTime;
-            flamingoPosition1 = keepInBounds(flamingoPosition1);
+        // Avança a simulação em passos fixos (ou lê o último estado da thread da simulação).
+        // Cada tick novo vai uma vez para a GPU, e o anterior continua no outro buffer de
+        // instâncias; a interpolação para o instante atual é feita no vertex shader
+        float alpha;
+        if (simulationThread.running()) {
+            bool fresh = snapshots.fetch();
+            const TrajectorySnapshot& snapshot = snapshots.readBuffer();
+            if (fresh || instancesDirty) {
+                // Com um tick pulado o anterior não está na GPU: desenha o novo parado
+                bool consecutive = !instancesDirty && snapshot.tick == instances.tick + 1;
+                uploadInstances(VAO, instances, snapshot.positions, snapshot.tangents, consecutive);
+                instances.tick = snapshot.tick;
+            }
+            alpha = glm::clamp((float)((schedulerSeconds() - snapshot.time) / SIMULATION_STEP), 0.0f, 1.0f);
+        } else {
+            if (instancesDirty)
+                uploadInstances(VAO, instances, flamingos.positions, flamingos.tangents, false);
+            int ticks = timestep.advance(deltaTime);
+            for (int tick = 0; tick < ticks; ++tick) {
+                simulateTrajectories((float)timestep.step());
+                if (tick >= ticks - 2) // só os dois últimos ticks são interpolados
+                    uploadInstances(VAO, instances, flamingos.positions, flamingos.tangents, true);
+            }
+            alpha = (float)timestep.alpha();
         }
 
-        // Atualiza posição do Flamingo 2
-        vec3 targetPos2 = trajectoryPoints2[currentTargetIndex2];
-        vec3 direction2 = normalize(targetPos2 - flamingoPosition2);
-        float distance2 = length(targetPos2 - flamingoPosition2);
+        // Desenha todos os flamingos em uma chamada, virados para a direção do caminho
+        drawFlamingos(shaderProgram, VAO, alpha, flamingoScale, vec3(flamingoRotationX, flamingoRotationY, flamingoRotationZ));
 
-        if (distance2 < 0.05f)
-        {
-            currentTargetIndex2 = (currentTargetIndex2 + 1) % trajectoryPoints2.size();
-        }
-        else
-        {
-            flamingoPosition2 += direction2 * moveSpeed * deltaTime;
-            flamingoPosition2 = keepInBounds(flamingoPosition2);
-        }
+        glfwSwapBuffers(window);
+    }
 
-        // Atualiza posição do Flamingo 3
-        vec3 targetPos3 = trajectoryPoints3[currentTargetIndex3];
-        vec3 direction3 = normalize(targetPos3 - flamingoPosition3);
-        float distance3 = length(targetPos3 - flamingoPosition3);
+    stopSimulationThread();
+    simulationJobs = nullptr;
+    glfwTerminate();
+    return 0;
+}
 
-        if (distance3 < 0.05f)
-        {
-            currentTargetIndex3 = (currentTargetIndex3 + 1) % trajectoryPoints3.size();
-        }
-        else
-        {
-            flamingoPosition3 += direction3 * moveSpeed * deltaTime;
-            flamingoPosition3 = keepInBounds(flamingoPosition3);
-        }
+// Um tick da simulação: cada flamingo avança moveSpeed * step ao longo do seu caminho
+void simulateTrajectories(float step)
+{
+    advancePathAgents(flamingoPaths, flamingos, step, simulationJobs);
+}
 
-        // Desenha os 3 flamingos
-        drawFlamingo(shaderProgram, VAO, flamingoPosition1, flamingoScale, vec3(flamingoRotationX, flamingoRotationY, flamingoRotationZ));
-        drawFlamingo(shaderProgram, VAO, flamingoPosition2, flamingoScale, vec3(flamingoRotationX, flamingoRotationY, flamingoRotationZ));
-        drawFlamingo(shaderProgram, VAO, flamingoPosition3, flamingoScale, vec3(flamingoRotationX, flamingoRotationY, flamingoRotationZ));
+// Cria o bando: flamingoCount agentes divididos entre os 3 caminhos
+void setupFlamingos()
+{
+    flamingos.clear();
+    flamingos.boundsMin = SCREEN_BOUNDS_MIN;
+    flamingos.boundsMax = SCREEN_BOUNDS_MAX;
+    for (size_t i = 0; i < flamingoCount; ++i)
+        flamingos.add((uint32_t)(i % 3), moveSpeed);
+    for (int path = 0; path < 3; ++path)
+        rebuildPath(path);
+}
 
-        glfwSwapBuffers(window);
+// Monta o caminho a partir dos pontos da sua trajetória e espalha os flamingos dele ao
+// longo da curva (o primeiro no início)
+void rebuildPath(int path)
+{
+    // A gravação avalia os caminhos na thread dela: termina antes de mudá-los
+    if (trajectoryRecorder.recording()) {
+        trajectoryRecorder.stop();
+        cout << "Gravacao interrompida: caminho alterado" << endl;
     }
 
-    glfwTerminate();
-    return 0;
+    const vector<vec3>& points = *trajectories[path];
+    SplinePath& spline = flamingoPaths[path];
+    if (!spline.build(points, pathKind, true)) {
+        if (pathKind == SPLINE_BEZIER)
+            cout << "Trajetoria " << path + 1 << ": Bezier fechada precisa de 3n + 1 pontos, com o ultimo igual ao primeiro; usando Catmull-Rom" << endl;
+        if (!spline.build(points, SPLINE_CATMULL_ROM, true)) {
+            // Menos de dois pontos: fica parado no ponto (ou na origem da trajetória)
+            vector<vec3> still = { points.empty() ? vec3(0.0f, 0.0f, -5.0f) : points[0] };
+            still.push_back(still[0] + vec3(0.001f, 0.0f, 0.0f));
+            spline.build(still, SPLINE_CATMULL_ROM, false);
+        }
+    }
+
+    size_t onPath = (flamingoCount + 2 - path) / 3;
+    for (size_t i = path, k = 0; i < flamingoCount; i += 3, ++k) {
+        flamingos.distances[i] = spline.length() * (float)k / (float)onPath;
+        flamingos.cursors[i] = 0;
+    }
+    // Passo zero: só amostra os caminhos nas distâncias novas
+    advancePathAgents(flamingoPaths, flamingos, 0.0f, simulationJobs);
+    instancesDirty = true;
+}
+
+// Liga a simulação em uma thread própria, que publica um TrajectorySnapshot a cada tick
+void startSimulationThread()
+{
+    // Até o primeiro tick o desenho mostra o estado atual, parado
+    TrajectorySnapshot initial;
+    initial.positions = flamingos.positions;
+    initial.tangents = flamingos.tangents;
+    initial.time = schedulerSeconds();
+    snapshots.reset(initial);
+    instancesDirty = true;
+
+    // Daqui em diante só a thread da simulação usa o JobSystem: ela passa a ser a dona
+    // dele no primeiro tick, e a thread principal o retoma em stopSimulationThread()
+    simulationThread.start(SIMULATION_STEP, [owner = false, tick = uint64_t(0)](double step) mutable {
+        if (!owner) {
+            simulationJobs->setOwner();
+            owner = true;
+        }
+        simulateTrajectories((float)step);
+        // O tick inteiro foi reescrito nos vetores dos agentes: eles vão para o buffer e os
+        // do buffer (com um tick velho) voltam para os agentes, que os sobrescrevem no próximo
+        TrajectorySnapshot& snapshot = snapshots.writeBuffer();
+        snapshot.positions.swap(flamingos.positions);
+        snapshot.tangents.swap(flamingos.tangents);
+        snapshot.tick = ++tick;
+        snapshot.time = schedulerSeconds();
+        snapshots.publish();
+    });
+}
+
+// Para a thread da simulação e devolve o JobSystem à thread principal
+void stopSimulationThread()
+{
+    bool wasRunning = simulationThread.running();
+    simulationThread.stop();
+    if (simulationJobs)
+        simulationJobs->setOwner();
+    // Os vetores de saída dos agentes ficaram com um tick velho: reamostra o estado atual
+    if (wasRunning) {
+        advancePathAgents(flamingoPaths, flamingos, 0.0f, simulationJobs);
+        instancesDirty = true;
+    }
 }
 
 GLuint setupShader()
@@ -582,19 +762,68 @@ GLuint loadTexture(const string &filePath)
     return texID;
 }
 
-//  Função para desenhar o Flamingo
-void drawFlamingo(GLuint shaderProgram, GLuint VAO, vec3 position, vec3 scaleVec, vec3 rotation)
+// Buffers de instâncias: dois de [posições | tangentes], flamingoCount de cada. Os
+// atributos 3 e 5 (tick anterior) e 4 e 6 (tick atual) são lidos uma vez por instância
+void setupInstanceBuffers(GLuint VAO, InstanceBuffers& instances)
+{
+    glGenBuffers(2, instances.buffers);
+    for (GLuint buffer : instances.buffers) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, 2 * flamingoCount * sizeof(vec3), nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(VAO);
+    for (GLuint i = 3; i <= 6; ++i) {
+        glEnableVertexAttribArray(i);
+        glVertexAttribDivisor(i, 1);
+    }
+    glBindVertexArray(0);
+}
+
+// Envia um tick. Com keepPrevious ele vai para o buffer mais antigo e o outro vira o tick
+// anterior; sem, os dois atributos leem o mesmo buffer (sem movimento até o próximo tick)
+void uploadInstances(GLuint VAO, InstanceBuffers& instances, const vector<vec3>& positions,
+                     const vector<vec3>& tangents, bool keepPrevious)
+{
+    if (keepPrevious)
+        instances.current ^= 1;
+    GLuint current = instances.buffers[instances.current];
+    GLuint previous = keepPrevious ? instances.buffers[instances.current ^ 1] : current;
+
+    size_t bytes = flamingoCount * sizeof(vec3);
+    glBindBuffer(GL_ARRAY_BUFFER, current);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, positions.data());
+    glBufferSubData(GL_ARRAY_BUFFER, bytes, bytes, tangents.data());
+
+    // O VAO guarda o buffer de cada atributo: aponta os do tick anterior e os do atual
+    glBindVertexArray(VAO);
+    GLuint sources[4] = { previous, current, previous, current };
+    for (GLuint i = 0; i < 4; ++i) {
+        glBindBuffer(GL_ARRAY_BUFFER, sources[i]);
+        glVertexAttribPointer(3 + i, 3, GL_FLOAT, GL_FALSE, sizeof(vec3), (GLvoid *)((i / 2) * bytes));
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    instancesDirty = false;
+}
+
+//  Função para desenhar os flamingos: uma chamada instanciada para o bando inteiro
+void drawFlamingos(GLuint shaderProgram, GLuint VAO, float alpha, vec3 scaleVec, vec3 rotation)
 {
-    mat4 model = translate(mat4(1.0f), position);
+    mat4 model = mat4(1.0f);
     model = rotate(model, radians(rotation.x), vec3(1.0f, 0.0f, 0.0f));
     model = rotate(model, radians(rotation.y), vec3(0.0f, 1.0f, 0.0f));
     model = rotate(model, radians(rotation.z), vec3(0.0f, 0.0f, 1.0f));
     model = glm::scale(model, scaleVec);
+    mat3 normalMatrix;
+    computeNormalMatrices(&model, &normalMatrix, 1);
 
     glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, value_ptr(model));
+    glUniformMatrix3fv(glGetUniformLocation(shaderProgram, "normalMatrix"), 1, GL_FALSE, value_ptr(normalMatrix));
+    glUniform1f(glGetUniformLocation(shaderProgram, "alpha"), alpha);
 
     glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLES, 0, positions.size());
+    glDrawArraysInstanced(GL_TRIANGLES, 0, positions.size(), (GLsizei)flamingoCount);
     glBindVertexArray(0);
 }
 
@@ -684,38 +913,95 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
             else if (key == GLFW_KEY_3)
                 currentFlamingo = 3;
 
+            // Tecla T liga/desliga a thread da simulação
+            if (key == GLFW_KEY_T)
+            {
+                if (simulationThread.running())
+                    stopSimulationThread();
+                else
+                    startSimulationThread();
+                cout << "Simulacao em thread separada: " << (simulationThread.running() ? "ligada" : "desligada") << endl;
+            }
+
+            // Tecla C alterna o tipo de curva dos caminhos (Catmull-Rom / Bézier)
+            if (key == GLFW_KEY_C)
+            {
+                bool threaded = simulationThread.running();
+                stopSimulationThread();
+                pathKind = pathKind == SPLINE_CATMULL_ROM ? SPLINE_BEZIER : SPLINE_CATMULL_ROM;
+                cout << "Caminhos: " << (pathKind == SPLINE_CATMULL_ROM ? "Catmull-Rom" : "Bezier cubica") << endl;
+                for (int i = 0; i < 3; ++i)
+                    rebuildPath(i);
+                if (threaded)
+                    startSimulationThread();
+            }
+
             // Caminho base
             string basePath = "../M6/"; 
 
-            if (key == GLFW_KEY_F) // "Tecla F" salva a trajetória
+            string filename = basePath + "trajetoriaFlamingo" + to_string(currentFlamingo);
+            vector<vec3>& points = *trajectories[currentFlamingo - 1];
+
+            if (key == GLFW_KEY_F) // "Tecla F" salva a trajetória (.trj, em segundo plano)
+            {
+                trajectoryWriter.save(filename + ".trj", points);
+            }
+            else if (key == GLFW_KEY_X) // "Tecla X" exporta a trajetória em texto
+            {
+                saveTrajectoryPoints(points, filename + ".txt");
+            }
+            else if (key == GLFW_KEY_R) // "Tecla R" liga/desliga a gravação do flamingo selecionado
             {
-                string filename = basePath + "trajetoriaFlamingo" + to_string(currentFlamingo) + ".txt";
-
-                if (currentFlamingo == 1)
-                    saveTrajectoryPoints(trajectoryPoints1, filename);
-                else if (currentFlamingo == 2)
-                    saveTrajectoryPoints(trajectoryPoints2, filename);
-                else if (currentFlamingo == 3)
-                    saveTrajectoryPoints(trajectoryPoints3, filename);
+                if (trajectoryRecorder.recording()) {
+                    trajectoryRecorder.stop();
+                    cout << "Gravacao parada (" << trajectoryRecorder.samplesTaken() << " amostras, "
+                         << trajectoryRecorder.samplesDropped() << " descartadas)" << endl;
+                }
+                else {
+                    // A distância do flamingo é lida com a simulação parada; daí em diante a
+                    // gravação avalia o caminho no próprio relógio, sem tocar no estado dela
+                    bool threaded = simulationThread.running();
+                    stopSimulationThread();
+                    size_t flamingo = (size_t)(currentFlamingo - 1) % flamingoCount;
+                    const SplinePath* path = &flamingoPaths[flamingos.paths[flamingo]];
+                    float startDistance = flamingos.distances[flamingo];
+                    float speed = flamingos.speeds[flamingo];
+                    if (threaded)
+                        startSimulationThread();
+
+                    uint32_t cursor = 0;
+                    string recordPath = basePath + "gravacaoFlamingo" + to_string(currentFlamingo) + ".trj";
+                    trajectoryRecorder.start({ recordPath }, RECORD_RATE,
+                        [path, startDistance, speed, cursor](uint32_t, double time) mutable {
+                            vec3 position, tangent;
+                            path->sample(startDistance + speed * (float)time, cursor, position, tangent);
+                            return keepInBounds(position);
+                        },
+                        RECORD_TOLERANCE);
+                    cout << "Gravando o flamingo " << currentFlamingo << " a " << RECORD_RATE << " Hz em " << recordPath << endl;
+                }
             }
             else if (key == GLFW_KEY_L) // "Tecla L" carregar a trajetória
             {
-                string filename = basePath + "trajetoriaFlamingo" + to_string(currentFlamingo) + ".txt";
-
-                if (currentFlamingo == 1)
-                    loadTrajectoryPoints(trajectoryPoints1, filename);
-                else if (currentFlamingo == 2)
-                    loadTrajectoryPoints(trajectoryPoints2, filename);
-                else if (currentFlamingo == 3)
-                    loadTrajectoryPoints(trajectoryPoints3, filename);
-
-                //  Reinicializa o índice do alvo para o primeiro ponto da trajetória
-                if (currentFlamingo == 1)
-                    currentTargetIndex1 = 0;
-                else if (currentFlamingo == 2)
-                    currentTargetIndex2 = 0;
-                else if (currentFlamingo == 3)
-                    currentTargetIndex3 = 0;
+                // A thread da simulação lê as trajetórias: pausa enquanto elas mudam
+                bool threaded = simulationThread.running();
+                stopSimulationThread();
+
+                // O .trj tem preferência; sem ele, importa o texto
+                if (loadTrajectoryFile(filename + ".trj", points)) {
+                    for (vec3& p : points)
+                        p = keepInBounds(p);
+                    cout << "Trajetoria carregada de " << filename << ".trj com " << points.size() << " pontos." << endl;
+                }
+                else {
+                    loadTrajectoryPoints(points, filename + ".txt");
+                }
+
+                // Refaz o caminho e volta o flamingo para o início dele
+                rebuildPath(currentFlamingo - 1);
+
+                if (threaded)
+                    startSimulationThread();
             }
         }
     }
@@ -0,0 +1,6 @@
+// Pré-passo de profundidade do TrabalhoGB: sem saída de cor
+// Sem #version: ShaderVariants insere a versão e os #defines de cada variante
+
+void main()
+{
+}
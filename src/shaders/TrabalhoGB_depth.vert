@@ -0,0 +1,15 @@
+// Pré-passo de profundidade do TrabalhoGB: apenas a posição, sem saída de cor
+// Sem #version: ShaderVariants insere a versão e os #defines de cada variante
+
+layout (location = 0) in vec3 aPos;
+
+uniform mat4 projection;
+uniform mat4 view;
+uniform mat4 model;
+
+invariant gl_Position;
+
+void main()
+{
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+}
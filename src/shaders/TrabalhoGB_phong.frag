@@ -0,0 +1,52 @@
+// Fragment shader de Phong do TrabalhoGB
+// Variantes usadas: TEXTURED (objetos opacos) e TEXTURED | ALPHA_TEST (olho do flamingo).
+// Só a variante com teste alfa contém discard, então os objetos opacos mantêm o early-Z
+// Sem #version: ShaderVariants insere a versão e os #defines de cada variante
+
+in vec2 TexCoord;
+in vec3 FragPos;
+in vec3 Normal;
+
+out vec4 FragColor;
+
+uniform sampler2D texture1;
+uniform vec3 viewPos;
+uniform vec3 objectColor;
+
+// Coeficientes de material
+uniform vec3 Ka; // Coeficiente ambiente
+uniform vec3 Kd; // Coeficiente difuso
+uniform vec3 Ks; // Coeficiente especular
+uniform float shininess; // Brilho da especular
+
+// Definida em ClusteredLights::glslSource(), anexado a este código
+void clusteredLighting(vec3 P, vec3 N, vec3 V, float shininess,
+                       out vec3 ambient, out vec3 diffuse, out vec3 specular);
+
+void main()
+{
+    // Soma das luzes do cluster deste fragmento
+    vec3 norm = normalize(Normal);
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 ambient, diffuse, specular;
+    clusteredLighting(FragPos, norm, viewDir, shininess, ambient, diffuse, specular);
+
+    // Iluminação final de Phong
+    vec3 phong = Ka * ambient + Kd * diffuse + Ks * specular;
+
+    // Combinar com a textura (ou com a cor do objeto na variante sem textura)
+#ifdef TEXTURED
+    vec4 texColor = texture(texture1, TexCoord);
+#else
+    vec4 texColor = vec4(objectColor, 1.0);
+#endif
+    
+#ifdef ALPHA_TEST
+    // Textura do olho: pixels transparentes são descartados
+    if (texColor.a < 0.1) {
+        discard;
+    }
+#endif
+    
+    FragColor = vec4(phong, 1.0) * texColor;
+}
@@ -0,0 +1,26 @@
+// Vertex shader de Phong do TrabalhoGB
+// Sem #version: ShaderVariants insere a versão e os #defines de cada variante
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec3 aNormal;
+
+out vec2 TexCoord;
+out vec3 FragPos;
+out vec3 Normal;
+
+uniform mat4 projection;
+uniform mat4 view;
+uniform mat4 model;
+uniform mat3 normalMatrix; // inversa transposta de mat3(model), calculada na CPU
+
+// Mesma expressão do pré-passo de profundidade, para que GL_EQUAL funcione
+invariant gl_Position;
+
+void main()
+{
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    FragPos = vec3(model * vec4(aPos, 1.0));
+    Normal = normalMatrix * aNormal;
+    TexCoord = aTexCoord;
+}
@@ -0,0 +1,51 @@
+/* Ferramenta - compila uma cena texto em um arquivo .cena
+ *
+ * Lê a cena com loadSceneConfig (includes, prefabs e vetores de instâncias resolvidos)
+ * e grava o arquivo binário de CompiledScene.h, que o TrabalhoGB e o SceneBench abrem
+ * com um único mmap. Confere o arquivo gravado abrindo-o de novo.
+ *
+ * Exemplo (da pasta de build):
+ *     SceneCompiler ../src/scene_init.txt cena_init.cena
+ *     TrabalhoGB --scene cena_init.cena
+ *
+ * Uso: SceneCompiler entrada.txt [saida.cena]   (padrão: a entrada com extensão .cena)
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "CompiledScene.h"
+
+using namespace std;
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 3) {
+        cout << "Uso: SceneCompiler entrada.txt [saida.cena]" << endl;
+        return -1;
+    }
+    string input = argv[1];
+    string output = argc == 3 ? argv[2] : filesystem::path(input).replace_extension(".cena").string();
+
+    auto start = chrono::steady_clock::now();
+    SceneConfig config;
+    if (!loadSceneConfig(input, config))
+        return -1;
+    double parseSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (!saveCompiledScene(config, output))
+        return -1;
+
+    start = chrono::steady_clock::now();
+    CompiledScene compiled;
+    if (!compiled.open(output)) {
+        cout << "Erro ao abrir a cena compilada: " << output << endl;
+        return -1;
+    }
+    double openMilliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    cout << output << ": " << compiled.objectCount() << " objetos, " << compiled.sizeBytes() / (1024.0 * 1024.0)
+         << " MB (texto lido em " << parseSeconds << " s, binario aberto em " << openMilliseconds << " ms)" << endl;
+    return 0;
+}
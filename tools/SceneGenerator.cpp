@@ -0,0 +1,98 @@
+/* Ferramenta - gerador de cenas grandes para testes de escala
+ *
+ * Grava uma cena no formato do scene_init.txt com N objetos (de 10 a milhões), em
+ * grade ou galáxia, e os arquivos que ela usa: esferas com o número de triângulos
+ * pedido, materiais MTL e texturas PNG. Com --compilar, grava também a cena compilada
+ * (.cena), que carrega com um mmap. Ver common/SceneGenerator.h.
+ *
+ * Exemplos (da pasta de build, como os exercícios):
+ *     SceneGenerator --objetos 100000 --layout galaxia --saida cenas/galaxia
+ *     SceneGenerator --objetos 100 --malhas esfera:2000000 --saida cenas/pesada
+ *     SceneGenerator --objetos 10000 --materiais 64 --texturas 32 --saida cenas/materiais
+ *     SceneGenerator --objetos 1000000 --layout galaxia --compilar --saida cenas/milhao
+ *     TrabalhoGB --scene cenas/galaxia/cena.txt
+ *
+ * Uso: SceneGenerator [--objetos N] [--layout grade|galaxia] [--espacamento X] [--bracos N]
+ *                     [--malhas moon,mars,suzanne,cube,esfera:T] [--materiais N] [--texturas N]
+ *                     [--orbitas fracao] [--semente N] [--assets pasta] [--saida pasta] [--nome cena]
+ *                     [--compilar]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "SceneGenerator.h"
+
+using namespace std;
+
+int main(int argc, char** argv)
+{
+    SceneGeneratorOptions options;
+    string outputDir = "cena_gerada", sceneName = "cena";
+    for (int i = 1; i < argc; ++i) {
+        string option = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (option == "--objetos" && hasValue)
+            options.objectCount = strtoull(argv[++i], nullptr, 10);
+        else if (option == "--layout" && hasValue) {
+            string layout = argv[++i];
+            if (layout != "grade" && layout != "galaxia") {
+                cout << "Layout desconhecido: " << layout << endl;
+                return -1;
+            }
+            options.layout = layout == "grade" ? LAYOUT_GRID : LAYOUT_GALAXY;
+        }
+        else if (option == "--espacamento" && hasValue)
+            options.spacing = (float)atof(argv[++i]);
+        else if (option == "--bracos" && hasValue)
+            options.galaxyArms = atoi(argv[++i]);
+        else if (option == "--malhas" && hasValue) {
+            options.meshes.clear();
+            istringstream list(argv[++i]);
+            string mesh;
+            while (getline(list, mesh, ','))
+                if (!mesh.empty())
+                    options.meshes.push_back(mesh);
+        }
+        else if (option == "--materiais" && hasValue)
+            options.materialCount = atoi(argv[++i]);
+        else if (option == "--texturas" && hasValue)
+            options.textureCount = atoi(argv[++i]);
+        else if (option == "--orbitas" && hasValue)
+            options.orbitFraction = (float)atof(argv[++i]);
+        else if (option == "--semente" && hasValue)
+            options.seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (option == "--assets" && hasValue)
+            options.assets = argv[++i];
+        else if (option == "--saida" && hasValue)
+            outputDir = argv[++i];
+        else if (option == "--nome" && hasValue)
+            sceneName = argv[++i];
+        else if (option == "--compilar")
+            options.compile = true;
+        else {
+            cout << "Uso: SceneGenerator [--objetos N] [--layout grade|galaxia] [--espacamento X] [--bracos N]\n"
+                 << "                      [--malhas moon,mars,suzanne,cube,esfera:T] [--materiais N] [--texturas N]\n"
+                 << "                      [--orbitas fracao] [--semente N] [--assets pasta] [--saida pasta] [--nome cena]\n"
+                 << "                      [--compilar]" << endl;
+            return -1;
+        }
+    }
+
+    auto start = chrono::steady_clock::now();
+    GeneratedScene scene;
+    if (!generateScene(outputDir, sceneName, options, &scene))
+        return -1;
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << scene.scenePath << ": " << scene.objects << " objetos, " << scene.triangles << " triangulos no total, "
+         << scene.sceneBytes / (1024.0 * 1024.0) << " MB" << endl;
+    cout << "  " << scene.meshFiles << " malha(s), " << scene.materialFiles << " material(is), "
+         << scene.textureFiles << " textura(s) gerados em " << seconds << " s" << endl;
+    if (!scene.compiledPath.empty())
+        cout << scene.compiledPath << ": " << scene.compiledBytes / (1024.0 * 1024.0) << " MB" << endl;
+    return 0;
+}